@@ -15,6 +15,14 @@ set(CMAKE_CXX_FLAGS_RELWITHDEBINFO "${CMAKE_CXX_FLAGS_RELEASE} -g")
 
 add_definitions("-D__FAVOR_BSD") #Not working correctly?
 
+# SIMD code paths are compiled per function with the target attribute and
+# selected at runtime, so they don't need this option
+option(NATIVE_ARCH "Compile everything for the build host CPU (-march=native)" OFF)
+if(NATIVE_ARCH)
+  message(STATUS "Compiling with -march=native")
+  add_compile_options(-march=native)
+endif()
+
 if(${CMAKE_SYSTEM_NAME} STREQUAL "Darwin")
   message(STATUS "Detected MacOSX")
   add_definitions("-DSYSTEM_NAME_DARWIN")
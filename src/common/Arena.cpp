@@ -0,0 +1,145 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implementation of the per thread bump-pointer arena
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/Arena.h>
+#include <common/Trace.h>
+
+#include <mutex>
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+std::atomic<Arena::ChunkPool *> Arena::Pool{nullptr};
+std::atomic<uint32_t> Arena::References[Arena::NumChunks];
+thread_local Arena *Arena::Current{nullptr};
+
+Arena::ChunkPool *Arena::chunkPool() {
+  static std::mutex Mutex;
+  auto Chunks = Pool.load(std::memory_order_acquire);
+  if (Chunks == nullptr) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Chunks = Pool.load(std::memory_order_relaxed);
+    if (Chunks == nullptr) {
+      // Note: We purposefully leak the storage, like the other pools
+      Chunks = new ChunkPool();
+      Chunks->Shared = true;
+      Pool.store(Chunks, std::memory_order_release);
+    }
+  }
+  return Chunks;
+}
+
+Arena::~Arena() {
+  saveActive();
+  for (auto &C : HeldChunks) {
+    release(C.Index);
+  }
+}
+
+void Arena::deallocate(void *Ptr) {
+  auto Chunks = Pool.load(std::memory_order_relaxed);
+  auto Index = uint32_t(((unsigned char *)Ptr - Chunks->PoolBytes) / ChunkBytes);
+  if (References[Index].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Chunks->DeallocateSlot(chunkBegin(Index));
+  }
+}
+
+void Arena::release(uint32_t Index) {
+  if (References[Index].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    chunkPool()->DeallocateSlot(chunkBegin(Index));
+  }
+}
+
+void Arena::saveActive() {
+  if (Next != nullptr) {
+    HeldChunks[Active].Used = size_t(Next - chunkBegin(ActiveIndex));
+  }
+}
+
+void Arena::activate(size_t Held) {
+  Active = Held;
+  ActiveIndex = HeldChunks[Held].Index;
+  Next = chunkBegin(ActiveIndex) + HeldChunks[Held].Used;
+  End = chunkBegin(ActiveIndex) + ChunkBytes;
+}
+
+void Arena::rewind(Chunk &C) {
+  if (C.Used != 0) {
+    Stats.UsedBytes -= C.Used;
+    Stats.Rewinds++;
+    C.Used = 0;
+  }
+}
+
+bool Arena::nextChunk(size_t Bytes) {
+  saveActive();
+
+  // reuse a chunk of which all allocations have been released
+  for (size_t i = 0; i < HeldChunks.size(); i++) {
+    auto &C = HeldChunks[i];
+    if (References[C.Index].load(std::memory_order_acquire) == 1) {
+      rewind(C);
+      activate(i);
+      return true;
+    }
+    if (ChunkBytes - C.Used >= Bytes) {
+      activate(i);
+      return true;
+    }
+  }
+
+  if (HeldChunks.size() >= MaxChunks) {
+    return false;
+  }
+  auto Memory = (unsigned char *)chunkPool()->AllocateSlot(ChunkBytes);
+  if (Memory == nullptr) {
+    XTRACE(MAIN, WAR, "Arena chunk pool exhausted");
+    return false;
+  }
+  auto Index = uint32_t((Memory - Pool.load(std::memory_order_relaxed)->PoolBytes) / ChunkBytes);
+  References[Index].store(1, std::memory_order_relaxed);
+  HeldChunks.push_back({Index, 0});
+  activate(HeldChunks.size() - 1);
+
+  Stats.Chunks = HeldChunks.size();
+  Stats.HighWaterChunks = std::max(Stats.HighWaterChunks, Stats.Chunks);
+  return true;
+}
+
+void Arena::recycle() {
+  if (HeldChunks.empty()) {
+    return;
+  }
+  saveActive();
+
+  bool KeptEmpty{false};
+  for (size_t i = 0; i < HeldChunks.size();) {
+    auto &C = HeldChunks[i];
+    if (References[C.Index].load(std::memory_order_acquire) == 1) {
+      rewind(C);
+      if (KeptEmpty) {
+        release(C.Index);
+        C = HeldChunks.back();
+        HeldChunks.pop_back();
+        continue;
+      }
+      KeptEmpty = true;
+    }
+    i++;
+  }
+  Stats.Chunks = HeldChunks.size();
+
+  // continue in the chunk with the most free space
+  size_t Emptiest{0};
+  for (size_t i = 1; i < HeldChunks.size(); i++) {
+    if (HeldChunks[i].Used < HeldChunks[Emptiest].Used) {
+      Emptiest = i;
+    }
+  }
+  activate(Emptiest);
+}
@@ -0,0 +1,175 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Per thread bump-pointer arena for short lived reduction data
+///
+/// An Arena hands out memory from chunks of ChunkBytes by bumping a
+/// pointer. Single allocations are not reused, a chunk is rewound as a
+/// whole once all of its allocations have been released. For per packet
+/// data (hits, clusters, events) this is after the packet or flush cycle
+/// has been processed, which is when recycle() should be called.
+///
+/// Chunks are taken from one process wide FixedSizePool, so arena memory
+/// is recognised by its address (contains()). Only the thread that owns an
+/// arena allocates from it (see ArenaScope), without locking, except when a
+/// chunk is taken from or returned to the chunk pool. Memory can be
+/// released from any thread, also after the arena has been destroyed.
+///
+/// Requests larger than MaxAllocBytes, or that do not fit when the arena
+/// holds MaxChunks chunks, return nullptr and the caller falls back to its
+/// usual allocator. A single long lived allocation keeps its whole chunk,
+/// so arenas used side by side should be limited to their share of the
+/// chunk pool (chunkShare()).
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/FixedSizePool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class Arena {
+public:
+  enum : size_t {
+    ChunkBytes = 1024 * 1024,
+    NumChunks = 1024, ///< chunks in the process wide chunk pool
+    DefaultMaxChunks = 256,
+    MaxAllocBytes = ChunkBytes / 4,
+    Alignment = 16
+  };
+
+  using ChunkPool = FixedSizePool<
+      FixedSizePoolParams<ChunkBytes, NumChunks, Alignment, Alignment, false>>;
+
+  /// \note Data needs to be int64 as required by common::Statistics.
+  struct ArenaStats {
+    int64_t AllocCount{0};
+    int64_t AllocBytes{0};
+    int64_t FallbackCount{0}; ///< requests left to the caller's allocator
+    int64_t Rewinds{0};       ///< chunks rewound for reuse
+    int64_t Chunks{0};        ///< chunks currently held
+    int64_t UsedBytes{0};     ///< bytes handed out and not yet rewound
+    int64_t HighWaterChunks{0};
+    int64_t HighWaterBytes{0};
+  };
+
+  /// \param MaxChunks most chunks the arena takes from the chunk pool
+  explicit Arena(size_t MaxChunks = DefaultMaxChunks) : MaxChunks(MaxChunks) {}
+
+  /// \return MaxChunks for each of Arenas arenas in use at the same time,
+  /// so that they can not exhaust the chunk pool
+  static constexpr size_t chunkShare(size_t Arenas) {
+    return (Arenas * DefaultMaxChunks <= NumChunks) ? size_t(DefaultMaxChunks)
+                                                    : NumChunks / Arenas;
+  }
+
+  /// \brief hands the chunks back to the chunk pool. Chunks with allocations
+  /// still in use are handed back when the last of these is released.
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /// \brief only to be called by the thread owning the arena
+  /// \return memory aligned to Alignment, nullptr if the request can not be
+  /// served by the arena
+  void *allocate(size_t Bytes);
+
+  /// \brief rewinds all chunks without allocations in use and hands all but
+  /// one of these back to the chunk pool. Only to be called by the thread
+  /// owning the arena, typically after each processed packet.
+  void recycle();
+
+  /// \brief release memory obtained from allocate(), from any thread
+  static void deallocate(void *Ptr);
+
+  /// \return true if Ptr was obtained from an arena
+  static bool contains(void *Ptr) {
+    auto Chunks = Pool.load(std::memory_order_acquire);
+    return Chunks != nullptr && Chunks->Contains(Ptr);
+  }
+
+  /// \return arena used for allocations of the calling thread, or nullptr
+  static Arena *current() { return Current; }
+
+  ArenaStats Stats;
+
+private:
+  friend class ArenaScope;
+
+  struct Chunk {
+    uint32_t Index;
+    size_t Used;
+  };
+
+  /// \brief make a chunk with at least Bytes free the active one
+  bool nextChunk(size_t Bytes);
+  /// \brief write back the fill level of the active chunk
+  void saveActive();
+  void activate(size_t Held);
+  void rewind(Chunk &C);
+  /// \brief drop the arena's reference, returns the chunk to the pool when
+  /// no allocations are in use
+  static void release(uint32_t Index);
+
+  static ChunkPool *chunkPool();
+  static unsigned char *chunkBegin(uint32_t Index) {
+    return Pool.load(std::memory_order_relaxed)->PoolBytes +
+           size_t(Index) * ChunkBytes;
+  }
+
+  static std::atomic<ChunkPool *> Pool;
+  /// allocations in use from each chunk, plus one while an arena holds it
+  static std::atomic<uint32_t> References[NumChunks];
+  static thread_local Arena *Current;
+
+  size_t MaxChunks;
+  std::vector<Chunk> HeldChunks;
+  size_t Active{0};
+  uint32_t ActiveIndex{0};
+  unsigned char *Next{nullptr};
+  unsigned char *End{nullptr};
+};
+
+inline void *Arena::allocate(size_t Bytes) {
+  Bytes = (Bytes + Alignment - 1) & ~size_t(Alignment - 1);
+  if (UNLIKELY(Bytes == 0 || Bytes > MaxAllocBytes)) {
+    Stats.FallbackCount++;
+    return nullptr;
+  }
+  if (UNLIKELY(size_t(End - Next) < Bytes) && !nextChunk(Bytes)) {
+    Stats.FallbackCount++;
+    return nullptr;
+  }
+
+  void *Ptr = Next;
+  Next += Bytes;
+  References[ActiveIndex].fetch_add(1, std::memory_order_relaxed);
+
+  Stats.AllocCount++;
+  Stats.AllocBytes += Bytes;
+  Stats.UsedBytes += Bytes;
+  Stats.HighWaterBytes = std::max(Stats.HighWaterBytes, Stats.UsedBytes);
+  return Ptr;
+}
+
+/// \class ArenaScope
+/// \brief Makes an arena the allocation arena of the calling thread for the
+///        lifetime of the scope, nullptr disables arena allocation. Scopes
+///        can be nested.
+class ArenaScope {
+public:
+  explicit ArenaScope(Arena *Memory) : Previous(Arena::Current) {
+    Arena::Current = Memory;
+  }
+  ~ArenaScope() { Arena::Current = Previous; }
+
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+  Arena *Previous;
+};
@@ -11,6 +11,8 @@
 
 #include <CLI/CLI.hpp>
 #include <atomic>
+#include <common/IdleStrategy.h>
+#include <common/PacketMmapReceiver.h>
 #include <common/Statistics.h>
 #include <common/SPSCFifo.h>
 #include <common/RingBuffer.h>
@@ -20,6 +22,8 @@
 #include <stdio.h>
 #include <string>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 
 // All settings should be initialized.
@@ -31,6 +35,13 @@ struct BaseSettings {
   std::int32_t  ReceiveMaxBytes      {9000}; // Jumbo frame support
   std::int32_t  RxSocketBufferSize   {2000000}; // bytes
   std::int32_t  TxSocketBufferSize   {2000000}; // bytes
+  std::int32_t  ReceiveBatchSize     {1}; // packets per recvmmsg(), 1 is recvfrom()
+  std::uint16_t ReceiverThreads      {1}; // input threads sharing DetectorPort
+  bool          HugePages            {false}; // huge page/mlock rx buffers
+  std::int32_t  NumaNode             {-1}; // for rx buffers, -1 is any node
+  std::string   PacketMmapInterface  {""}; // AF_PACKET receive if not empty
+  std::string   IdleMode             {"sleep"}; // see IdleStrategy.h
+  std::uint32_t IdleUSleep           {10}; // for the sleep idle strategy
   std::string   KafkaBroker          {"localhost:9092"};
   std::string   GraphitePrefix       {"efu.null"};
   std::string   GraphiteRegion       {"0"};
@@ -57,7 +68,12 @@ public:
   using CommandFunction =
       std::function<int(std::vector<std::string>, char *, unsigned int *)>;
   using ThreadList = std::vector<ThreadInfo>;
-  Detector(std::string Name, BaseSettings settings) : EFUSettings(settings), Stats(), DetectorName(Name) {};
+  Detector(std::string Name, BaseSettings settings)
+      : EFUSettings(settings), Stats(), DetectorName(Name) {
+    unsigned int Receivers = EFUSettings.ReceiverThreads;
+    Receivers = (Receivers < 1) ? 1 : (Receivers > MaxReceivers) ? MaxReceivers : Receivers;
+    EFUSettings.ReceiverThreads = Receivers;
+  };
 
   virtual ~Detector() = default;
 
@@ -96,16 +112,25 @@ public:
     }
   };
 
+  /// \brief number of input threads receiving on the detector port
+  virtual unsigned int receivers() { return 1; }
+
+  /// \brief false if more input threads were requested (--rxthreads) than
+  /// the detector supports, see InputDetector::enableReceivers()
+  bool receiversSupported() { return receivers() == EFUSettings.ReceiverThreads; }
+
+  /// \brief false if AF_PACKET receive was requested (--rxinterface) but the
+  /// detector does not use InputDetector::packetMmapReceiveLoop()
+  bool rxInterfaceSupported() {
+    return EFUSettings.PacketMmapInterface.empty() or PacketMmapSupported;
+  }
+
 protected:
   /// \todo figure out the right size  of EthernetBufferMaxEntries
   static const int EthernetBufferMaxEntries {2000};
   static const int EthernetBufferSize {9000}; /// bytes
   static const int KafkaBufferSize {124000}; /// entries ~ 1MB
-
-  /// Shared between input_thread and processing_thread
-  memory_sequential_consistent::CircularFifo<unsigned int, EthernetBufferMaxEntries> InputFifo;
-  /// \todo the number 11 is a workaround
-  RingBuffer<EthernetBufferSize> RxRingbuffer{EthernetBufferMaxEntries + 11};
+  static const int MaxReceivers {8}; /// max input threads on the same port
 
   // Ideally should match the CPU speed, but as this varies across
   // CPU versions we just select something in the 'middle'. This is
@@ -125,12 +150,195 @@ protected:
   std::atomic_bool runThreads{true};
   BaseSettings EFUSettings;
   Statistics Stats;
+  /// used by processing threads when their input fifo is empty
+  IdleStrategy ProcessingIdle{EFUSettings.IdleMode, EFUSettings.IdleUSleep};
   uint32_t RuntimeStatusMask{0};
+  /// set by detectors receiving with packetMmapReceiveLoop()
+  bool PacketMmapSupported{false};
 
 private:
   std::string DetectorName;
 };
 
+/// \brief Detector with input threads receiving into ringbuffers, and fifos
+/// of ringbuffer indices to the processing thread. The fifo implementation
+/// (see SPSCFifo.h) is chosen by the detector module, for example
+/// InputDetector<memory_sequential_consistent::CircularFifo> for the
+/// sequentially consistent fifo.
+template <template <typename, size_t> class FifoTemplate =
+              memory_relaxed_aquire_release::CircularFifo>
+class InputDetector : public Detector {
+public:
+  InputDetector(std::string Name, BaseSettings Settings)
+      : Detector(Name, Settings),
+        RxRingbuffer(EthernetBufferMaxEntries + 11, EFUSettings.HugePages, EFUSettings.NumaNode) {}
+
+  unsigned int receivers() override { return InputStages.size() + 1; }
+
+protected:
+  using InputFifoType = FifoTemplate<unsigned int, EthernetBufferMaxEntries>;
+  using RxRingbufferType = RingBuffer<EthernetBufferSize>;
+
+  /// Shared between input_thread and processing_thread
+  InputFifoType InputFifo;
+  /// \todo the number 11 is a workaround
+  RxRingbufferType RxRingbuffer;
+
+  /// \brief Fifo and ringbuffer for receivers 1 and up (SO_REUSEPORT)
+  struct InputStage {
+    InputStage(const BaseSettings &Settings)
+        : Ringbuffer(EthernetBufferMaxEntries + 11, Settings.HugePages, Settings.NumaNode) {}
+    InputFifoType Fifo;
+    RxRingbufferType Ringbuffer;
+  };
+  std::vector<std::unique_ptr<InputStage>> InputStages;
+
+  /// \brief create the input stages for the requested number of receivers,
+  /// only called by detectors with an input thread per receiver. Receiver 0
+  /// uses InputFifo and RxRingbuffer, the others get their own.
+  void enableReceivers() {
+    while (receivers() < EFUSettings.ReceiverThreads) {
+      InputStages.emplace_back(new InputStage(EFUSettings));
+    }
+  }
+
+  /// \brief Input counters, one set per receiver thread. Summed into the
+  /// detector counters by the processing thread via sumReceiverCounters(),
+  /// when the stats are updated
+  struct ReceiverCounters {
+    int64_t RxPackets{0};
+    int64_t RxBytes{0};
+    int64_t FifoPushErrors{0};
+    int64_t RxIdle{0};
+    int64_t RingOverruns{0}; ///< from the receiver's RingBuffer
+    int64_t KernelDrops{0}; ///< AF_PACKET ring drops, see packetMmapReceiveLoop()
+  } __attribute__((aligned(64)));
+  ReceiverCounters RxCounters[MaxReceivers];
+
+  /// AF_PACKET receivers, see packetMmapReceiveLoop(). Owned by the
+  /// detector as the processing thread may release packets after the
+  /// input thread has stopped.
+  std::unique_ptr<PacketMmapReceiver> PacketReceivers[MaxReceivers];
+
+  /// \brief the fifo used by the specified receiver
+  InputFifoType &inputFifo(unsigned int Receiver) {
+    return (Receiver == 0) ? InputFifo : InputStages[Receiver - 1]->Fifo;
+  }
+
+  /// \brief the ringbuffer used by the specified receiver
+  RxRingbufferType &rxRingbuffer(unsigned int Receiver) {
+    return (Receiver == 0) ? RxRingbuffer : InputStages[Receiver - 1]->Ringbuffer;
+  }
+
+  /// \brief pop from the receiver fifos in round robin order. Packets
+  /// from one receiver are always returned in the order they arrived.
+  /// \param[in,out] Receiver last receiver popped from, updated on success
+  /// \param[out] DataIndex ringbuffer index of the packet
+  /// \return true if data was available
+  bool popInputFifos(unsigned int &Receiver, unsigned int &DataIndex) {
+    unsigned int Receivers = receivers();
+    for (unsigned int i = 1; i <= Receivers; i++) {
+      unsigned int Next = (Receiver + i) % Receivers;
+      if (inputFifo(Next).pop(DataIndex)) {
+        Receiver = Next;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// \brief what the receive ringbuffers are backed by, the lowest
+  /// PinnedMemory::Backing of all receivers
+  int64_t rxMemoryBacking() {
+    int64_t Backing = RxRingbuffer.getBacking();
+    for (auto &Stage : InputStages) {
+      if (Stage->Ringbuffer.getBacking() < Backing) {
+        Backing = Stage->Ringbuffer.getBacking();
+      }
+    }
+    return Backing;
+  }
+
+  /// \brief receive several packets with one system call into the
+  /// ringbuffer and fifo of Receiver. Packets are counted individually so
+  /// statistics are the same as for single receives.
+  /// \param DataReceiver UDPReceiver or PacketMmapReceiver
+  template <typename ReceiverType>
+  void receiveBatch(ReceiverType &DataReceiver, unsigned int Receiver) {
+    auto &Fifo = inputFifo(Receiver);
+    auto &Ringbuffer = rxRingbuffer(Receiver);
+    auto &RxStats = RxCounters[Receiver];
+
+    unsigned int Slots = Ringbuffer.acquire(EFUSettings.ReceiveBatchSize);
+    if (Slots == 0) { // still owned by the processing thread
+      usleep(10);
+      return;
+    }
+
+    int Packets = DataReceiver.receiveBatch(Ringbuffer, Slots);
+    if (Packets == 0) {
+      RxStats.RxIdle++;
+      return;
+    }
+
+    unsigned int FirstIndex = Ringbuffer.getDataIndex();
+    bool FifoFull{false};
+    for (int i = 0; i < Packets; i++) {
+      unsigned int DataIndex = FirstIndex + i;
+      RxStats.RxPackets++;
+      RxStats.RxBytes += Ringbuffer.getDataLength(DataIndex);
+
+      // Once the fifo is full the rest of the batch is dropped, those
+      // buffers stay acquired and are reused by the next receive
+      if (FifoFull or (Fifo.push(DataIndex) == false)) {
+        FifoFull = true;
+        RxStats.FifoPushErrors++;
+        Ringbuffer.discard(DataIndex);
+      } else {
+        Ringbuffer.commit();
+      }
+    }
+  }
+
+  /// \brief input thread loop receiving from the AF_PACKET ring of
+  /// EFUSettings.PacketMmapInterface. Packets are not copied, so they are
+  /// always received with receiveBatch(), also for a batch size of 1.
+  void packetMmapReceiveLoop(unsigned int Receiver) {
+    // Receivers share a fanout group so each packet is only seen once
+    int FanoutGroup = (receivers() > 1) ? EFUSettings.DetectorPort : -1;
+    PacketReceivers[Receiver].reset(new PacketMmapReceiver(
+        EFUSettings.PacketMmapInterface, EFUSettings.DetectorPort, FanoutGroup));
+    auto &DataReceiver = *PacketReceivers[Receiver];
+    DataReceiver.printBufferSizes();
+    DataReceiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
+    // the kernel drop count costs a system call, read it every DropsInterval
+    // batches and when stopping
+    const unsigned int DropsInterval{1024};
+    unsigned int Batches{0};
+    while (runThreads) {
+      receiveBatch(DataReceiver, Receiver);
+      if (++Batches % DropsInterval == 0) {
+        RxCounters[Receiver].KernelDrops = DataReceiver.getDropped();
+      }
+    }
+    RxCounters[Receiver].KernelDrops = DataReceiver.getDropped();
+  }
+
+  /// \brief add the counters of all receivers
+  ReceiverCounters sumReceiverCounters() {
+    ReceiverCounters Sum;
+    for (unsigned int i = 0; i < receivers(); i++) {
+      Sum.RxPackets += RxCounters[i].RxPackets;
+      Sum.RxBytes += RxCounters[i].RxBytes;
+      Sum.FifoPushErrors += RxCounters[i].FifoPushErrors;
+      Sum.RxIdle += RxCounters[i].RxIdle;
+      Sum.RingOverruns += rxRingbuffer(i).getOverruns();
+      Sum.KernelDrops += RxCounters[i].KernelDrops;
+    }
+    return Sum;
+  }
+};
+
 struct PopulateCLIParser {
   std::function<void(CLI::App &)> Function;
 };
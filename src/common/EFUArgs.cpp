@@ -10,6 +10,7 @@
 #include <common/EFUArgs.h>
 #include <common/Version.h>
 #include <common/Log.h>
+#include <common/Socket.h>
 #include <cstdio>
 #include <fstream>
 #include <regex>
@@ -120,6 +121,37 @@ EFUArgs::EFUArgs() {
   CLIParser.add_option("--txbuffer", EFUSettings.TxSocketBufferSize,
                   "Transmit to detector buffer size.")
       ->group("EFU Options")->default_str("9216");
+
+  CLIParser.add_option("--rxbatch", EFUSettings.ReceiveBatchSize,
+                  "Max packets per receive system call (1 - 64), 1 disables batching.")
+      ->group("EFU Options")->default_str("1")
+      ->check(CLI::Range(1, int(Socket::MaxBatchSize)));
+
+  CLIParser.add_option("--rxthreads", EFUSettings.ReceiverThreads,
+                  "Number of input threads sharing the udp port (SO_REUSEPORT, 1 - 8).")
+      ->group("EFU Options")->default_str("1")
+      ->check(CLI::Range(1, 8));
+
+  CLIParser.add_flag("--hugepages", EFUSettings.HugePages,
+                  "Use huge pages (or mlock()ed memory) for the receive buffers.")
+      ->group("EFU Options");
+
+  CLIParser.add_option("--numa_node", EFUSettings.NumaNode,
+                  "Preferred NUMA node for huge page receive buffers, -1 is any node.")
+      ->group("EFU Options")->default_str("-1");
+
+  CLIParser.add_option("--rxinterface", EFUSettings.PacketMmapInterface,
+                  "Receive with a TPACKET_V3 AF_PACKET ring on this interface instead of a udp socket (loki, dream).")
+      ->group("EFU Options")->default_str("");
+
+  CLIParser.add_option("--idle", EFUSettings.IdleMode,
+                  "Processing thread idle strategy: sleep, spin, yield or backoff.")
+      ->group("EFU Options")->default_str("sleep")
+      ->check(CLI::IsMember({"sleep", "spin", "yield", "backoff"}));
+
+  CLIParser.add_option("--idle_usleep", EFUSettings.IdleUSleep,
+                  "usleep() time for the sleep idle strategy.")
+      ->group("EFU Options")->default_str("10");
   // clang-format on
 }
 
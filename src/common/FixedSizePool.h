@@ -10,11 +10,15 @@
 #include <common/Assert.h>
 #include <common/BitMath.h>
 #include <common/Expect.h>
+#include <common/PinnedMemory.h>
 #include <common/Trace.h>
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <cstdint>
+#include <new>
+#include <thread>
 
 #define PoolAssertMsg(kEnable, ...)                                            \
   do {                                                                         \
@@ -65,6 +69,9 @@ struct FixedSizePoolParams {
 ///        (MemDeletedPattern, MemAllocatedPattern) to make it easier to detect
 ///        use-after-free. It also checks on destruction that all indices in the
 ///        stack are unique, meaning no double-free.
+/// Pools can be placed in huge page or mlock()ed memory with CreatePinned().
+/// Pools are not thread safe unless Shared is set or a SharedPoolScope
+///        exists, then allocation and deallocation take a spinlock.
 template <typename FixedSizePoolParamsT> struct FixedSizePool {
   enum : size_t {
     SlotBytes = FixedSizePoolParamsT::SlotBytes,
@@ -93,17 +100,68 @@ template <typename FixedSizePoolParamsT> struct FixedSizePool {
 
   uint32_t NumSlotsUsed;
   MemStats Stats;
+  int64_t MemoryBacking; // PinnedMemory::Backing
+  bool Shared{false}; // set before the pool is used by several threads
+  std::atomic<int> SharedScopes{0}; // see SharedPoolScope
+  std::atomic_flag SpinLock = ATOMIC_FLAG_INIT;
   uint32_t FreeSlotStack[NumSlots]; // no order
   uint32_t SlotAllocSize[NumSlots]; // indexed by Slot index
   alignas(StartAlignment) unsigned char PoolBytes[SlotBytes * NumSlots];
 
   FixedSizePool();
 
+  /// \brief construct a pool in huge page or mlock()ed memory
+  /// \param NumaNode preferred NUMA node, -1 for no preference
+  static FixedSizePool *CreatePinned(int NumaNode = -1);
+  /// \brief destroy a pool created by CreatePinned()
+  static void DestroyPinned(FixedSizePool *Pool);
+
   void *AllocateSlot(size_t byteCount = SlotBytes);
   void DeallocateSlot(void *p);
+  /// \brief count an allocation the outside allocator passed to malloc
+  void CountMallocFallback();
+  /// \return true if the spinlock is used
+  bool IsShared() {
+    return Shared || SharedScopes.load(std::memory_order_relaxed) > 0;
+  }
   bool Contains(void *p);
   /// \return null on no error, else returns error description
   const char *ValidateEmptyStateAndReturnError();
+
+private:
+  /// \brief holds the spinlock for its lifetime if the pool is Shared
+  struct SharedGuard {
+    explicit SharedGuard(FixedSizePool &Pool)
+        : Pool(Pool), Locked(Pool.IsShared()) {
+      if (Locked) {
+        while (Pool.SpinLock.test_and_set(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    ~SharedGuard() {
+      if (Locked) {
+        Pool.SpinLock.clear(std::memory_order_release);
+      }
+    }
+    FixedSizePool &Pool;
+    bool Locked;
+  };
+};
+
+/// \class SharedPoolScope
+/// \brief Makes a pool Shared for the lifetime of the scope. Create it
+///        before the threads using the pool are started and destroy it
+///        after they are joined. Scopes can overlap.
+template <typename PoolT> class SharedPoolScope {
+public:
+  explicit SharedPoolScope(PoolT &Pool) : Pool(Pool) { Pool.SharedScopes++; }
+  ~SharedPoolScope() { Pool.SharedScopes--; }
+  SharedPoolScope(const SharedPoolScope &) = delete;
+  SharedPoolScope &operator=(const SharedPoolScope &) = delete;
+
+private:
+  PoolT &Pool;
 };
 
 template <typename FixedSizePoolParamsT>
@@ -125,14 +183,34 @@ FixedSizePool<FixedSizePoolParamsT>::FixedSizePool() {
   Stats.DeallocCount = 0;
   Stats.DeallocBytes = 0;
   Stats.MallocFallbackCount = 0;
+  MemoryBacking = PinnedMemory::Default;
 
   if (Validate) {
     memset(PoolBytes, MemDeletedPattern, sizeof(PoolBytes));
   }
 }
 
+template <typename FixedSizePoolParamsT>
+FixedSizePool<FixedSizePoolParamsT> *
+FixedSizePool<FixedSizePoolParamsT>::CreatePinned(int NumaNode) {
+  static_assert(StartAlignment <= PinnedMemory::HugePageSize,
+                "Pinned memory is only aligned to HugePageSize");
+  int64_t Backing;
+  void *Memory = PinnedMemory::allocate(sizeof(FixedSizePool), NumaNode, Backing);
+  auto Pool = new (Memory) FixedSizePool();
+  Pool->MemoryBacking = Backing;
+  return Pool;
+}
+
+template <typename FixedSizePoolParamsT>
+void FixedSizePool<FixedSizePoolParamsT>::DestroyPinned(FixedSizePool *Pool) {
+  Pool->~FixedSizePool();
+  PinnedMemory::deallocate(Pool, sizeof(FixedSizePool));
+}
+
 template <typename FixedSizePoolParamsT>
 void *FixedSizePool<FixedSizePoolParamsT>::AllocateSlot(size_t byteCount) {
+  SharedGuard Guard(*this);
   if (UNLIKELY(NumSlotsUsed == NumSlots)) {
     return nullptr;
   }
@@ -167,6 +245,7 @@ void *FixedSizePool<FixedSizePoolParamsT>::AllocateSlot(size_t byteCount) {
 
 template <typename FixedSizePoolParamsT>
 void FixedSizePool<FixedSizePoolParamsT>::DeallocateSlot(void *p) {
+  SharedGuard Guard(*this);
   size_t slotIndex = ((unsigned char *)p - PoolBytes) / SlotBytes;
   PoolAssertMsg(UseAsserts, slotIndex < NumSlots,
                 "Dealloc pointer is not from pool");
@@ -188,6 +267,12 @@ void FixedSizePool<FixedSizePoolParamsT>::DeallocateSlot(void *p) {
   }
 }
 
+template <typename FixedSizePoolParamsT>
+void FixedSizePool<FixedSizePoolParamsT>::CountMallocFallback() {
+  SharedGuard Guard(*this);
+  Stats.MallocFallbackCount++;
+}
+
 template <typename FixedSizePoolParamsT>
 bool FixedSizePool<FixedSizePoolParamsT>::Contains(void *p) {
   return (unsigned char *)p >= PoolBytes &&
@@ -0,0 +1,24 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Selection of processing thread idle strategy
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/IdleStrategy.h>
+#include <common/Log.h>
+
+IdleStrategy::Mode IdleStrategy::modeFromString(std::string Name) {
+  if (Name == "sleep") {
+    return Sleep;
+  } else if (Name == "spin") {
+    return BusySpin;
+  } else if (Name == "yield") {
+    return SpinYield;
+  } else if (Name == "backoff") {
+    return Backoff;
+  }
+  LOG(MAIN, Sev::Warning, "Unknown idle strategy '{}', using sleep", Name);
+  return Sleep;
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief What a processing thread does when there is no data in its fifo
+///
+/// sleep   - usleep() every time (default, for shared machines)
+/// spin    - return immediately (dedicated cores, lowest latency)
+/// yield   - spin for a while, then std::this_thread::yield()
+/// backoff - spin for a while, then an increasing number of pause
+///           instructions (_mm_pause() on x86)
+///
+/// reset() must be called whenever work was found.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+class IdleStrategy {
+public:
+  enum Mode { Sleep, BusySpin, SpinYield, Backoff };
+
+  /// \brief number of idle calls handled by each method
+  struct IdleCounters {
+    int64_t Spins{0};
+    int64_t Yields{0};
+    int64_t Pauses{0};
+    int64_t Sleeps{0};
+  };
+
+  /// \param Name one of "sleep", "spin", "yield" or "backoff"
+  /// \param USleep sleep time for the sleep strategy (us)
+  IdleStrategy(std::string Name, uint32_t USleep)
+      : IdleMode(modeFromString(Name)), SleepUs(USleep) {}
+
+  /// \brief strategy from its name, unknown names select Sleep
+  static Mode modeFromString(std::string Name);
+
+  /// \brief called when there was no work
+  void idle() {
+    switch (IdleMode) {
+    case BusySpin:
+      Counters.Spins++;
+      break;
+    case SpinYield:
+      if (IdleCount < SpinLimit) {
+        IdleCount++;
+        Counters.Spins++;
+      } else {
+        Counters.Yields++;
+        std::this_thread::yield();
+      }
+      break;
+    case Backoff:
+      if (IdleCount < SpinLimit) {
+        IdleCount++;
+        Counters.Spins++;
+      } else {
+        Counters.Pauses++;
+        for (uint32_t i = 0; i < PauseCount; i++) {
+          pause();
+        }
+        if (PauseCount < MaxPauses) {
+          PauseCount *= 2;
+        }
+      }
+      break;
+    case Sleep:
+    default:
+      Counters.Sleeps++;
+      usleep(SleepUs);
+      break;
+    }
+  }
+
+  /// \brief called when work was found, restarts spinning/backoff
+  void reset() {
+    IdleCount = 0;
+    PauseCount = 1;
+  }
+
+  Mode mode() { return IdleMode; }
+
+  IdleCounters Counters;
+
+private:
+  static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+  static const uint32_t SpinLimit{1000}; ///< idle calls before yield/pause
+  static const uint32_t MaxPauses{1024}; ///< max pause instructions per call
+
+  Mode IdleMode{Sleep};
+  uint32_t SleepUs{10};
+  uint32_t IdleCount{0};
+  uint32_t PauseCount{1};
+};
@@ -0,0 +1,272 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implementation of the AF_PACKET TPACKET_V3 receiver
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/Log.h>
+#include <common/PacketMmapReceiver.h>
+#include <common/Trace.h>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef SYSTEM_NAME_LINUX
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+#ifdef SYSTEM_NAME_LINUX
+
+PacketMmapReceiver::PacketMmapReceiver(std::string Interface, uint16_t Port,
+                                       int FanoutGroup, uint32_t BlockSize,
+                                       uint32_t Blocks)
+    : BlockSize(BlockSize), Blocks(Blocks),
+      BlockRefs(new std::atomic<uint32_t>[Blocks]) {
+  for (uint32_t Block = 0; Block < Blocks; Block++) {
+    BlockRefs[Block].store(0);
+  }
+
+  // SOCK_DGRAM: link layer header removed, data (and BPF offsets) start
+  // at the IP header for any interface type
+  SocketFileDescriptor = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+  if (SocketFileDescriptor < 0) {
+    auto Msg = fmt::format("PacketMmapReceiver: socket(AF_PACKET) failed, "
+                           "missing CAP_NET_RAW? ({})", strerror(errno));
+    LOG(IPC, Sev::Error, Msg);
+    throw std::runtime_error(Msg);
+  }
+
+  // Accept IPv4, udp, not a fragment (other than the first), dest port
+  struct sock_filter Filter[] = {
+      {BPF_LD | BPF_B | BPF_ABS, 0, 0, 9},              // ip protocol
+      {BPF_JMP | BPF_JEQ | BPF_K, 0, 6, IPPROTO_UDP},
+      {BPF_LD | BPF_H | BPF_ABS, 0, 0, 6},              // fragment offset
+      {BPF_JMP | BPF_JSET | BPF_K, 4, 0, 0x1fff},
+      {BPF_LDX | BPF_B | BPF_MSH, 0, 0, 0},             // ip header length
+      {BPF_LD | BPF_H | BPF_IND, 0, 0, 2},              // udp dest port
+      {BPF_JMP | BPF_JEQ | BPF_K, 0, 1, Port},
+      {BPF_RET | BPF_K, 0, 0, 0xffffffff},              // accept
+      {BPF_RET | BPF_K, 0, 0, 0},                       // drop
+  };
+  struct sock_fprog Program;
+  Program.len = sizeof(Filter) / sizeof(Filter[0]);
+  Program.filter = Filter;
+
+  int Version = TPACKET_V3;
+  struct tpacket_req3 Request;
+  std::memset(&Request, 0, sizeof(Request));
+  Request.tp_block_size = BlockSize;
+  Request.tp_block_nr = Blocks;
+  Request.tp_frame_size = TPACKET_ALIGNMENT << 7;
+  Request.tp_frame_nr = (BlockSize * Blocks) / Request.tp_frame_size;
+  Request.tp_retire_blk_tov = 10; // ms, hand partially filled blocks over
+
+  if ((setsockopt(SocketFileDescriptor, SOL_SOCKET, SO_ATTACH_FILTER, &Program, sizeof(Program)) < 0) or
+      (setsockopt(SocketFileDescriptor, SOL_PACKET, PACKET_VERSION, &Version, sizeof(Version)) < 0) or
+      (setsockopt(SocketFileDescriptor, SOL_PACKET, PACKET_RX_RING, &Request, sizeof(Request)) < 0)) {
+    auto Msg = fmt::format("PacketMmapReceiver: TPACKET_V3 ring setup failed ({})", strerror(errno));
+    LOG(IPC, Sev::Error, Msg);
+    close(SocketFileDescriptor);
+    throw std::runtime_error(Msg);
+  }
+
+  void *Mapped = mmap(nullptr, (size_t)BlockSize * Blocks, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_LOCKED, SocketFileDescriptor, 0);
+  if (Mapped == MAP_FAILED) {
+    auto Msg = fmt::format("PacketMmapReceiver: mmap() of ring failed ({})", strerror(errno));
+    LOG(IPC, Sev::Error, Msg);
+    close(SocketFileDescriptor);
+    throw std::runtime_error(Msg);
+  }
+  Ring = static_cast<char *>(Mapped);
+
+  struct sockaddr_ll Address;
+  std::memset(&Address, 0, sizeof(Address));
+  Address.sll_family = AF_PACKET;
+  Address.sll_protocol = htons(ETH_P_IP);
+  Address.sll_ifindex = if_nametoindex(Interface.c_str());
+  if ((Address.sll_ifindex == 0) or
+      (bind(SocketFileDescriptor, (struct sockaddr *)&Address, sizeof(Address)) != 0)) {
+    auto Msg = fmt::format("PacketMmapReceiver: bind to interface {} failed", Interface);
+    LOG(IPC, Sev::Error, Msg);
+    munmap(Ring, (size_t)BlockSize * Blocks);
+    close(SocketFileDescriptor);
+    throw std::runtime_error(Msg);
+  }
+
+  if (FanoutGroup >= 0) {
+    int Fanout = (FanoutGroup & 0xffff) | (PACKET_FANOUT_HASH << 16);
+    if (setsockopt(SocketFileDescriptor, SOL_PACKET, PACKET_FANOUT, &Fanout, sizeof(Fanout)) < 0) {
+      // without fanout every receiver would get every packet
+      auto Msg = fmt::format("PacketMmapReceiver: PACKET_FANOUT group {} failed ({})",
+                             FanoutGroup, strerror(errno));
+      LOG(IPC, Sev::Error, Msg);
+      munmap(Ring, (size_t)BlockSize * Blocks);
+      close(SocketFileDescriptor);
+      throw std::runtime_error(Msg);
+    }
+  }
+
+  LOG(IPC, Sev::Info, "PacketMmapReceiver on {}, udp port {}", Interface, Port);
+}
+
+PacketMmapReceiver::~PacketMmapReceiver() {
+  if (Ring != nullptr) {
+    munmap(Ring, (size_t)BlockSize * Blocks);
+  }
+  if (SocketFileDescriptor >= 0) {
+    close(SocketFileDescriptor);
+  }
+}
+
+void PacketMmapReceiver::printBufferSizes() {
+  LOG(IPC, Sev::Info, "TPACKET_V3 ring: {} blocks of {} bytes", Blocks, BlockSize);
+}
+
+int PacketMmapReceiver::setRecvTimeout(int Seconds, int USecs) {
+  TimeoutMs = Seconds * 1000 + USecs / 1000;
+  return 0;
+}
+
+void PacketMmapReceiver::releaseData(uint32_t Block) {
+  uint32_t Refs = BlockRefs[Block].load(std::memory_order_acquire);
+  while (true) {
+    if (Refs == 1) {
+      // Last reference, nobody can take a new one. The block is handed
+      // to the kernel before the count is cleared, see blockReady()
+      auto Desc = (struct tpacket_block_desc *)(Ring + (size_t)Block * BlockSize);
+      __atomic_store_n(&Desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+      BlockRefs[Block].store(0, std::memory_order_release);
+      return;
+    }
+    if (BlockRefs[Block].compare_exchange_weak(Refs, Refs - 1,
+                                               std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+bool PacketMmapReceiver::blockReady(uint32_t Block) {
+  // A block still referenced has already been read, it is not yet back
+  // from the kernel even though its status is TP_STATUS_USER
+  if (BlockRefs[Block].load(std::memory_order_acquire) != 0) {
+    return false;
+  }
+  auto Desc = (struct tpacket_block_desc *)(Ring + (size_t)Block * BlockSize);
+  return (__atomic_load_n(&Desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0;
+}
+
+char *PacketMmapReceiver::nextPacket(int &Length, uint32_t &Block, bool Wait) {
+  auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeoutMs);
+  while (true) {
+    if (PacketsLeft == 0) {
+      if (not blockReady(CurrentBlock)) {
+        if (not Wait) {
+          return nullptr;
+        }
+        auto Remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Deadline - std::chrono::steady_clock::now()).count();
+        if (Remaining <= 0) {
+          return nullptr;
+        }
+        struct pollfd Poll;
+        Poll.fd = SocketFileDescriptor;
+        Poll.events = POLLIN | POLLERR;
+        Poll.revents = 0;
+        if (poll(&Poll, 1, Remaining) <= 0) {
+          return nullptr;
+        }
+        // poll() also reports POLLIN while an earlier block is still in
+        // use (released by the RingBuffer consumer), avoid spinning
+        if (not blockReady(CurrentBlock)) {
+          usleep(PollSleepUs);
+        }
+        continue;
+      }
+      auto Desc = (struct tpacket_block_desc *)(Ring + (size_t)CurrentBlock * BlockSize);
+      PacketsLeft = Desc->hdr.bh1.num_pkts;
+      NextHeader = (char *)Desc + Desc->hdr.bh1.offset_to_first_pkt;
+      BlockRefs[CurrentBlock].store(1, std::memory_order_relaxed); // reader
+    }
+
+    char *Data{nullptr};
+    if (PacketsLeft > 0) {
+      auto Header = (struct tpacket3_hdr *)NextHeader;
+      NextHeader += Header->tp_next_offset;
+      PacketsLeft--;
+
+      // Outgoing packets are also seen on loopback
+      auto LinkAddress = (struct sockaddr_ll *)((char *)Header + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+      uint8_t *Ip = (uint8_t *)Header + Header->tp_net;
+      unsigned int IpHeaderLength = (Ip[0] & 0x0f) * 4;
+      uint8_t *Udp = Ip + IpHeaderLength;
+      int UdpLength = (Udp[4] << 8) | Udp[5];
+      if (LinkAddress->sll_pkttype == PACKET_OUTGOING) {
+        XTRACE(IPC, DEB, "Skipping outgoing packet");
+      } else if ((IpHeaderLength + UdpLength > Header->tp_snaplen) or (UdpLength < 8)) {
+        XTRACE(IPC, WAR, "Truncated or invalid udp packet, snaplen %u", Header->tp_snaplen);
+      } else {
+        Length = UdpLength - 8;
+        Data = (char *)Udp + 8;
+        Block = CurrentBlock;
+        BlockRefs[CurrentBlock].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    if (PacketsLeft == 0) { // reader is done with the block
+      uint32_t Done = CurrentBlock;
+      CurrentBlock = (CurrentBlock + 1) % Blocks;
+      releaseData(Done);
+    }
+    if (Data != nullptr) {
+      return Data;
+    }
+  }
+}
+
+uint64_t PacketMmapReceiver::getDropped() {
+  struct tpacket_stats_v3 Stats;
+  socklen_t Size = sizeof(Stats);
+  if (getsockopt(SocketFileDescriptor, SOL_PACKET, PACKET_STATISTICS, &Stats, &Size) == 0) {
+    Dropped += Stats.tp_drops;
+  }
+  return Dropped;
+}
+
+#else // SYSTEM_NAME_LINUX
+
+PacketMmapReceiver::PacketMmapReceiver(std::string, uint16_t, int, uint32_t,
+                                       uint32_t) {
+  auto Msg = "PacketMmapReceiver: AF_PACKET is only supported on Linux";
+  LOG(IPC, Sev::Error, Msg);
+  throw std::runtime_error(Msg);
+}
+
+PacketMmapReceiver::~PacketMmapReceiver() {}
+
+void PacketMmapReceiver::printBufferSizes() {}
+
+int PacketMmapReceiver::setRecvTimeout(int, int) { return 0; }
+
+void PacketMmapReceiver::releaseData(uint32_t) {}
+
+bool PacketMmapReceiver::blockReady(uint32_t) { return false; }
+
+char *PacketMmapReceiver::nextPacket(int &, uint32_t &, bool) { return nullptr; }
+
+uint64_t PacketMmapReceiver::getDropped() { return 0; }
+
+#endif // SYSTEM_NAME_LINUX
@@ -0,0 +1,113 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Receive udp packets from a memory mapped AF_PACKET (TPACKET_V3)
+/// ring instead of a udp socket (Linux only)
+///
+/// The kernel writes packets into blocks shared with user space, a BPF
+/// filter only lets through IPv4 udp packets for the detector port.
+/// receiveBatch() does not copy: the RingBuffer slots refer to the payloads
+/// in the blocks, and a block is handed back to the kernel when all its
+/// packets have been released from the RingBuffer. Requires CAP_NET_RAW.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <common/RingBuffer.h>
+#include <common/Socket.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+class PacketMmapReceiver : public RingBufferDataOwner {
+public:
+  /// \param Interface network interface to receive on, for example "eth0"
+  /// \param Port udp destination port to accept
+  /// \param FanoutGroup receivers with the same group share the packets
+  /// (PACKET_FANOUT, hash), -1 for no fanout
+  /// \param BlockSize size of each ring block, power of two (bytes)
+  /// \param Blocks number of blocks in the ring
+  /// throws std::runtime_error if the ring cannot be set up
+  PacketMmapReceiver(std::string Interface, uint16_t Port,
+                     int FanoutGroup = -1, uint32_t BlockSize = 1 << 20,
+                     uint32_t Blocks = 32);
+
+  /// \brief unmap ring and close socket. Packets still referenced by a
+  /// RingBuffer must have been released.
+  ~PacketMmapReceiver();
+
+  /// \brief log the ring dimensions
+  void printBufferSizes();
+
+  /// \brief maximum time to wait for a packet in receiveBatch()
+  int setRecvTimeout(int Seconds, int USecs);
+
+  /// \brief Same as UDPReceiver::receiveBatch(), but the buffers are set
+  /// to refer to the payloads in the ring (RingBuffer::setDataView()).
+  /// Waits for the first packet, then takes the packets already in the ring.
+  /// The ring block of a packet is kept until the RingBuffer slot is
+  /// released or discarded.
+  template <const unsigned int N>
+  int receiveBatch(RingBuffer<N> &Ring, int MaxPackets = Socket::MaxBatchSize);
+
+  /// \brief hand the packet back, the block is returned to the kernel once
+  /// all its packets are released (called via RingBuffer)
+  void releaseData(uint32_t Block) override;
+
+  /// \brief packets dropped by the kernel (ring full) since the socket
+  /// was opened. Reads the kernel statistics, which are reset on each read,
+  /// so it is only to be called by the receiving thread.
+  uint64_t getDropped();
+
+private:
+  /// \brief get next packet payload, optionally waiting for it. A reference
+  /// to the block is taken for the caller, see releaseData()
+  /// \param[out] Length payload size (bytes)
+  /// \param[out] Block ring block holding the payload
+  /// \return pointer to the payload, nullptr if there is no packet
+  char *nextPacket(int &Length, uint32_t &Block, bool Wait);
+
+  /// \brief true if the kernel has handed Block over with new packets
+  bool blockReady(uint32_t Block);
+
+  /// sleep when poll() returns, but the next block is not ready (us)
+  static constexpr int PollSleepUs{100};
+
+  int SocketFileDescriptor{-1};
+  char *Ring{nullptr};
+  uint32_t BlockSize{0};
+  uint32_t Blocks{0};
+  int TimeoutMs{100};
+  uint64_t Dropped{0}; ///< sum of the kernel drop counts read so far
+
+  /// references to each block: packets not released and, for the
+  /// current block, the reader
+  std::unique_ptr<std::atomic<uint32_t>[]> BlockRefs;
+  uint32_t CurrentBlock{0};
+  uint32_t PacketsLeft{0}; ///< in current block, 0 if not owned
+  char *NextHeader{nullptr};
+};
+
+template <const unsigned int N>
+int PacketMmapReceiver::receiveBatch(RingBuffer<N> &Ring, int MaxPackets) {
+  unsigned int FirstIndex = Ring.getDataIndex();
+  int Entries = std::min(MaxPackets, (int)(Ring.getMaxElements() - FirstIndex));
+
+  int Packets{0};
+  while (Packets < Entries) {
+    int Length;
+    uint32_t Block;
+    // only wait for the first packet
+    char *Data = nextPacket(Length, Block, Packets == 0);
+    if (Data == nullptr) {
+      break;
+    }
+    Ring.setDataView(FirstIndex + Packets, Data, Length, this, Block);
+    Packets++;
+  }
+  return Packets;
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implementation of huge page / mlock()ed memory allocation
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/Log.h>
+#include <common/PinnedMemory.h>
+#include <common/Trace.h>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#ifdef SYSTEM_NAME_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+constexpr size_t PinnedMemory::HugePageSize;
+
+void *PinnedMemory::allocate(size_t Bytes, int NumaNode, int64_t &Result) {
+  size_t Size = mappedSize(Bytes);
+  void *Ptr{MAP_FAILED};
+  Result = Default;
+
+#ifdef SYSTEM_NAME_LINUX
+  Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (Ptr != MAP_FAILED) {
+    Result = HugePages;
+  } else {
+    LOG(UTILS, Sev::Warning, "No huge pages for {} bytes, using mlock()", Size);
+  }
+#endif
+
+  if (Ptr == MAP_FAILED) {
+    Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      LOG(UTILS, Sev::Error, "mmap() of {} bytes failed", Size);
+      throw std::bad_alloc();
+    }
+  }
+
+#ifdef SYSTEM_NAME_LINUX
+  // Must be set before the pages are faulted in, MPOL_PREFERRED is 1
+  if ((NumaNode >= 0) and (NumaNode < 64)) {
+    unsigned long NodeMask = 1UL << NumaNode;
+    if (syscall(SYS_mbind, Ptr, Size, 1, &NodeMask, 64, 0) != 0) {
+      LOG(UTILS, Sev::Warning, "mbind() to NUMA node {} failed", NumaNode);
+    }
+  }
+#endif
+
+  if (Result != HugePages) {
+    if (mlock(Ptr, Size) == 0) {
+      Result = Locked;
+    } else {
+      LOG(UTILS, Sev::Warning, "mlock() of {} bytes failed", Size);
+    }
+  }
+
+  memset(Ptr, 0, Size); // prefault
+  XTRACE(UTILS, INF, "Allocated %zu bytes, backing %d", Size, (int)Result);
+  return Ptr;
+}
+
+void PinnedMemory::deallocate(void *Ptr, size_t Bytes) {
+  if (Ptr == nullptr) {
+    return;
+  }
+  munmap(Ptr, mappedSize(Bytes));
+}
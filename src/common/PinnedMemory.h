@@ -0,0 +1,42 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Allocation of large, long lived buffers backed by 2MB huge pages
+/// or, if these are not available, by mlock()ed anonymous memory.
+///
+/// Memory is prefaulted on allocation so the first pass through a buffer
+/// does not take page faults. On Linux an optional NUMA node can be given
+/// as a placement hint.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class PinnedMemory {
+public:
+  /// \brief what the memory ended up being backed by, reported as a stat
+  enum Backing : int64_t { Default = 0, Locked = 1, HugePages = 2 };
+
+  static constexpr size_t HugePageSize{2 * 1024 * 1024};
+
+  /// \brief allocate prefaulted memory, trying huge pages, then mlock()
+  /// \param Bytes Size of the allocation
+  /// \param NumaNode preferred NUMA node, -1 for no preference
+  /// \param[out] Result what the memory is backed by
+  /// \return pointer to zeroed memory, throws std::bad_alloc on failure
+  static void *allocate(size_t Bytes, int NumaNode, int64_t &Result);
+
+  /// \brief free memory obtained from allocate()
+  /// \param Ptr pointer returned by allocate()
+  /// \param Bytes same size as given to allocate()
+  static void deallocate(void *Ptr, size_t Bytes);
+
+private:
+  /// \brief allocations are done in whole huge pages
+  static size_t mappedSize(size_t Bytes) {
+    return (Bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+  }
+};
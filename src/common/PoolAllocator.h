@@ -49,12 +49,12 @@ template <typename PoolAllocatorConfigT> struct PoolAllocator {
   using value_type = T;
   using PoolType = typename PoolAllocatorConfigT::PoolType;
 
-  PoolType &Pool;
+  PoolType *Pool;
 
   PoolAllocator(const PoolAllocator &) noexcept = default;
   PoolAllocator &operator=(const PoolAllocator &) = delete;
 
-  PoolAllocator(PoolType &pool) noexcept : Pool(pool) {}
+  PoolAllocator(PoolType &pool) noexcept : Pool(&pool) {}
 
   template <typename U> struct rebind {
     using other =
@@ -73,12 +73,12 @@ typename PoolAllocatorConfigT::T *
 PoolAllocator<PoolAllocatorConfigT>::allocate(std::size_t numElements) {
   size_t byteCount = sizeof(T) * numElements;
   T *alloc = nullptr;
-  if (LIKELY(byteCount <= Pool.SlotBytes)) {
-    alloc = (T *)Pool.AllocateSlot(byteCount);
+  if (LIKELY(byteCount <= Pool->SlotBytes)) {
+    alloc = (T *)Pool->AllocateSlot(byteCount);
   }
   if (UNLIKELY(alloc == nullptr)) {
     alloc = (T *)std::malloc(byteCount);
-    Pool.Stats.MallocFallbackCount++;
+    Pool->CountMallocFallback();
     if (0) {
       XTRACE(MAIN, CRI, "PoolAlloc fallover: %u objs, %u bytes", numElements,
              byteCount);
@@ -90,13 +90,38 @@ PoolAllocator<PoolAllocatorConfigT>::allocate(std::size_t numElements) {
 template <typename PoolAllocatorConfigT>
 void PoolAllocator<PoolAllocatorConfigT>::deallocate(T *p,
                                                      std::size_t) noexcept {
-  if (LIKELY(Pool.Contains(p))) {
-    Pool.DeallocateSlot(p);
+  if (LIKELY(Pool->Contains(p))) {
+    Pool->DeallocateSlot(p);
   } else {
     std::free(p);
   }
 }
 
+/// \brief replace the pool of Alloc by one in huge page or mlock()ed memory,
+/// see FixedSizePool::CreatePinned(). Pool must have been created with new.
+/// A pool with allocations or in a SharedPoolScope is kept, as
+/// deallocate() would otherwise pass them to free() or the scope would
+/// refer to the deleted pool.
+/// \param[in,out] Pool the pool used by Alloc, updated if replaced
+/// \param NumaNode preferred NUMA node, -1 for no preference
+/// \return what the pool in use is backed by (PinnedMemory::Backing)
+template <typename PoolAllocatorConfigT>
+int64_t usePinnedPool(typename PoolAllocatorConfigT::PoolType *&Pool,
+                      PoolAllocator<PoolAllocatorConfigT> &Alloc,
+                      int NumaNode) {
+  using PoolType = typename PoolAllocatorConfigT::PoolType;
+  if ((Pool->MemoryBacking != PinnedMemory::Default) or
+      (Pool->NumSlotsUsed != 0) or (Pool->SharedScopes != 0)) {
+    return Pool->MemoryBacking;
+  }
+  PoolType *Pinned = PoolType::CreatePinned(NumaNode);
+  Pinned->Shared = Pool->Shared;
+  Alloc.Pool = Pinned;
+  delete Pool;
+  Pool = Pinned;
+  return Pool->MemoryBacking;
+}
+
 template <typename PoolAllocatorConfigT, typename PoolAllocatorConfigU>
 bool operator==(const PoolAllocator<PoolAllocatorConfigT> &,
                 const PoolAllocator<PoolAllocatorConfigU> &) {
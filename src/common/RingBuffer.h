@@ -7,12 +7,39 @@
 ///
 /// User writes to buffers directly, so it is possible to write beyond buffers.
 /// However overwrites can be checked using verifyBufferCookies() if paranoid.
+///
+/// Optionally the Producer can use acquire()/commit() and the Consumer
+/// release() for explicit slot ownership. A slot is then never handed out
+/// to the Producer again before the Consumer has released it, and failures
+/// to acquire a slot are counted once per overrun in getOverruns().
+///
+/// The buffers can be backed by huge pages or mlock()ed memory, see
+/// PinnedMemory.
+///
+/// Instead of copying data into a buffer the Producer can let a slot refer
+/// to data owned by a RingBufferDataOwner with setDataView() (zero copy
+/// receive). The owner is told when the Consumer releases the slot.
 //===----------------------------------------------------------------------===//
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <common/PinnedMemory.h>
+#include <cstdint>
 #include <cstdlib>
+#include <new>
+
+/// \brief owner of data referenced by RingBuffer slots, see
+/// RingBuffer::setDataView()
+class RingBufferDataOwner {
+public:
+  virtual ~RingBufferDataOwner() = default;
+
+  /// \brief the data given with Token is no longer used, called by the
+  /// RingBuffer Consumer (release()) or Producer (discard())
+  virtual void releaseData(uint32_t Token) = 0;
+};
 
 template <const unsigned int N> class RingBuffer {
   static const unsigned int COOKIE1 = 0xDEADC0DE;
@@ -28,7 +55,9 @@ public:
 
   /// \brief construct a ringbuffer of specified size
   /// \param entries Maximum number of entries in ring
-  RingBuffer(const int entries);
+  /// \param Pinned use huge pages or mlock()ed memory for the buffers
+  /// \param NumaNode preferred NUMA node for pinned memory, -1 is any
+  RingBuffer(const int entries, bool Pinned = false, int NumaNode = -1);
 
   /// \brief minimal destructor frees the allocated buffer
   ~RingBuffer();
@@ -47,6 +76,14 @@ public:
   /// \param length Size of data (Bytes)
   void setDataLength(unsigned int index, unsigned int length);
 
+  /// \brief Let an acquired buffer refer to Length bytes of Data owned by
+  /// Owner instead of its own memory, getDataBuffer() returns Data until
+  /// the buffer is released. Only called by Producer.
+  /// \param index Index of the specified buffer
+  /// \param Token passed to Owner->releaseData() when the buffer is released
+  void setDataView(unsigned int index, char *Data, unsigned int Length,
+                   RingBufferDataOwner *Owner, uint32_t Token);
+
   /// \brief get the length of data in specified  buffer
   /// \param index Index of specified buffer
   int getDataLength(const unsigned int index);
@@ -56,6 +93,35 @@ public:
   /// Only called by Producer.
   int getNextBuffer();
 
+  /// \brief Take ownership of up to MaxSlots consecutive buffers starting
+  /// at the current index, without wrapping. Slots already acquired but not
+  /// yet committed are included in the count. Only called by Producer.
+  /// \param MaxSlots Maximum number of buffers wanted
+  /// \return number of buffers owned by the Producer, 0 is an overrun
+  unsigned int acquire(unsigned int MaxSlots = 1);
+
+  /// \brief Hand the current (acquired) buffer over to the Consumer and
+  /// advance to the next buffer. Only called by Producer.
+  void commit();
+
+  /// \brief Return a committed buffer so it can be acquired again.
+  /// Only called by Consumer.
+  /// \param index Index of the buffer being released
+  void release(unsigned int index);
+
+  /// \brief Drop the data of an acquired buffer that is not committed, a
+  /// data view is handed back to its owner. Only called by Producer.
+  /// \param index Index of the buffer
+  void discard(unsigned int index);
+
+  /// \brief number of times acquire() found the current buffer still
+  /// owned by the Consumer. Repeated failures before the next successful
+  /// acquire() count as one overrun.
+  int64_t getOverruns() { return overruns_; }
+
+  /// \brief what the buffers are backed by (PinnedMemory::Backing)
+  int64_t getBacking() { return backing_; }
+
   int getMaxBufSize() { return N; }          ///< return buffer size in bytes
   int getMaxElements() { return max_entries_; } ///< return number of buffers
 
@@ -65,18 +131,55 @@ public:
 
 private:
   struct Data *data{nullptr};
+  std::atomic<bool> *owned_{nullptr}; ///< true from acquire() to release()
+  struct View {
+    char *Data{nullptr}; ///< nullptr: data is in the buffer
+    RingBufferDataOwner *Owner{nullptr};
+    uint32_t Token{0};
+  };
+  View *views_{nullptr}; ///< see setDataView()
+
+  /// \brief hand a data view back to its owner
+  void releaseView(unsigned int index);
   unsigned int entry_{0};
   unsigned int max_entries_{0};
+  unsigned int acquired_{0}; ///< buffers acquired, but not committed
+  int64_t overruns_{0};
+  bool overrun_{false}; ///< last acquire() failed, see getOverruns()
+  bool pinned_{false};
+  int64_t backing_{PinnedMemory::Default};
 };
 
 template <const unsigned int N>
-RingBuffer<N>::RingBuffer(int entries) : max_entries_(entries) {
-  data = new Data[entries];
+RingBuffer<N>::RingBuffer(int entries, bool Pinned, int NumaNode)
+    : max_entries_(entries), pinned_(Pinned) {
+  if (pinned_) {
+    void *Memory = PinnedMemory::allocate(entries * sizeof(Data), NumaNode, backing_);
+    data = static_cast<Data *>(Memory);
+    for (int i = 0; i < entries; i++) {
+      new (&data[i]) Data;
+    }
+  } else {
+    data = new Data[entries];
+  }
+  owned_ = new std::atomic<bool>[entries];
+  for (int i = 0; i < entries; i++) {
+    owned_[i].store(false);
+  }
+  views_ = new View[entries];
 }
 
 template <const unsigned int N> RingBuffer<N>::~RingBuffer() {
-  delete[] data;
+  if (pinned_) {
+    PinnedMemory::deallocate(data, max_entries_ * sizeof(Data));
+  } else {
+    delete[] data;
+  }
   data = 0;
+  delete[] owned_;
+  owned_ = 0;
+  delete[] views_;
+  views_ = 0;
 }
 
 template <const unsigned int N> unsigned int RingBuffer<N>::getDataIndex() {
@@ -88,6 +191,9 @@ char *RingBuffer<N>::getDataBuffer(unsigned int index) {
   assert(index < max_entries_);
   assert(data[index].cookie1 == COOKIE1);
   assert(data[index].cookie2 == COOKIE2);
+  if (views_[index].Data != nullptr) {
+    return views_[index].Data;
+  }
   return data[index].buffer;
 }
 
@@ -104,8 +210,71 @@ void RingBuffer<N>::setDataLength(unsigned int index, unsigned int length) {
   data[index].length = length;
 }
 
+template <const unsigned int N>
+void RingBuffer<N>::setDataView(unsigned int index, char *Data,
+                                unsigned int Length,
+                                RingBufferDataOwner *Owner, uint32_t Token) {
+  assert(index < max_entries_);
+  releaseView(index); // acquired, but not committed last time
+  views_[index].Data = Data;
+  views_[index].Owner = Owner;
+  views_[index].Token = Token;
+  data[index].length = Length;
+}
+
+template <const unsigned int N>
+void RingBuffer<N>::releaseView(unsigned int index) {
+  if (views_[index].Data != nullptr) {
+    views_[index].Data = nullptr;
+    views_[index].Owner->releaseData(views_[index].Token);
+  }
+}
+
 /// \todo using powers of two and bitmask in stead of modulus
 template <const unsigned int N> int RingBuffer<N>::getNextBuffer() {
   entry_ = (entry_ + 1) % max_entries_;
   return entry_;
 }
+
+template <const unsigned int N>
+unsigned int RingBuffer<N>::acquire(unsigned int MaxSlots) {
+  while ((acquired_ < MaxSlots) && (entry_ + acquired_ < max_entries_)) {
+    unsigned int index = entry_ + acquired_;
+    if (owned_[index].load(std::memory_order_acquire)) {
+      break;
+    }
+    owned_[index].store(true, std::memory_order_relaxed);
+    acquired_++;
+  }
+  if (acquired_ == 0) {
+    // count once until the Consumer has released the buffer, the
+    // Producer typically retries until it succeeds
+    if (not overrun_) {
+      overrun_ = true;
+      overruns_++;
+    }
+  } else {
+    overrun_ = false;
+  }
+  return acquired_;
+}
+
+template <const unsigned int N> void RingBuffer<N>::commit() {
+  assert(acquired_ > 0);
+  acquired_--;
+  getNextBuffer();
+}
+
+template <const unsigned int N>
+void RingBuffer<N>::release(unsigned int index) {
+  assert(index < max_entries_);
+  releaseView(index);
+  owned_[index].store(false, std::memory_order_release);
+}
+
+template <const unsigned int N>
+void RingBuffer<N>::discard(unsigned int index) {
+  assert(index < max_entries_);
+  releaseView(index);
+  data[index].length = 0;
+}
@@ -122,3 +122,159 @@ size_t CircularFifo<Element, Size>::increment(size_t idx) const {
 }
 
 } // namespace memory_sequential_consistent
+
+/// \brief Same fifo as above but using acquire/release ordering. Head and
+/// tail are placed on separate cache lines and each side keeps a cached copy
+/// of the other side's index, so the shared index is only re-read when the
+/// fifo looks full (producer) or empty (consumer).
+namespace memory_relaxed_aquire_release {
+template <typename Element, size_t Size> class CircularFifo {
+public:
+  enum { Capacity = Size + 1 };
+  enum { CacheLineSize = 64 };
+
+  CircularFifo() : _tail(0), _head(0) {}
+  virtual ~CircularFifo() {}
+
+  bool push(const Element &item);
+  bool pop(Element &item);
+
+  /// \brief push up to Count elements
+  /// \return number of elements pushed
+  size_t push_batch(const Element *items, size_t Count);
+
+  /// \brief pop up to MaxCount elements
+  /// \return number of elements popped
+  size_t pop_batch(Element *items, size_t MaxCount);
+
+  bool wasEmpty() const;
+  bool wasFull() const;
+  int free() const;
+  bool isLockFree() const;
+
+private:
+  size_t increment(size_t idx) const;
+
+  /// \brief number of elements between head and tail
+  size_t used(size_t head, size_t tail) const;
+
+  char _padding0[CacheLineSize]; // cppcheck-suppress unusedStructMember
+  // Producer side
+  std::atomic<size_t> _tail; // tail(input) index
+  size_t _cachedHead{0};     // producer copy of _head
+  char _padding1[CacheLineSize]; // cppcheck-suppress unusedStructMember
+  // Consumer side
+  std::atomic<size_t> _head; // head(output) index
+  size_t _cachedTail{0};     // consumer copy of _tail
+  char _padding2[CacheLineSize]; // cppcheck-suppress unusedStructMember
+  Element _array[Capacity];
+};
+
+// Only the producer updates tail, so it can be loaded relaxed. The
+// release store of tail publishes the element to the consumer.
+template <typename Element, size_t Size>
+bool CircularFifo<Element, Size>::push(const Element &item) {
+  const auto current_tail = _tail.load(std::memory_order_relaxed);
+  const auto next_tail = increment(current_tail);
+  if (next_tail == _cachedHead) {
+    _cachedHead = _head.load(std::memory_order_acquire);
+    if (next_tail == _cachedHead) {
+      return false; // full queue
+    }
+  }
+
+  _array[current_tail] = item;
+  _tail.store(next_tail, std::memory_order_release);
+  return true;
+}
+
+// Pop by Consumer can only update the head
+template <typename Element, size_t Size>
+bool CircularFifo<Element, Size>::pop(Element &item) {
+  const auto current_head = _head.load(std::memory_order_relaxed);
+  if (current_head == _cachedTail) {
+    _cachedTail = _tail.load(std::memory_order_acquire);
+    if (current_head == _cachedTail) {
+      return false; // empty queue
+    }
+  }
+
+  item = _array[current_head];
+  _head.store(increment(current_head), std::memory_order_release);
+  return true;
+}
+
+template <typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::push_batch(const Element *items,
+                                               size_t Count) {
+  const auto current_tail = _tail.load(std::memory_order_relaxed);
+  size_t Free = Size - used(_cachedHead, current_tail);
+  if (Free < Count) {
+    _cachedHead = _head.load(std::memory_order_acquire);
+    Free = Size - used(_cachedHead, current_tail);
+  }
+
+  size_t Pushed = (Count < Free) ? Count : Free;
+  size_t idx = current_tail;
+  for (size_t i = 0; i < Pushed; i++) {
+    _array[idx] = items[i];
+    idx = increment(idx);
+  }
+  _tail.store(idx, std::memory_order_release);
+  return Pushed;
+}
+
+template <typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::pop_batch(Element *items,
+                                              size_t MaxCount) {
+  const auto current_head = _head.load(std::memory_order_relaxed);
+  size_t Available = used(current_head, _cachedTail);
+  if (Available < MaxCount) {
+    _cachedTail = _tail.load(std::memory_order_acquire);
+    Available = used(current_head, _cachedTail);
+  }
+
+  size_t Popped = (MaxCount < Available) ? MaxCount : Available;
+  size_t idx = current_head;
+  for (size_t i = 0; i < Popped; i++) {
+    items[i] = _array[idx];
+    idx = increment(idx);
+  }
+  _head.store(idx, std::memory_order_release);
+  return Popped;
+}
+
+// snapshot with acceptance of that this comparison function is not atomic
+template <typename Element, size_t Size>
+bool CircularFifo<Element, Size>::wasEmpty() const {
+  return (_head.load() == _tail.load());
+}
+
+// snapshot with acceptance that this comparison is not atomic
+template <typename Element, size_t Size>
+bool CircularFifo<Element, Size>::wasFull() const {
+  const auto next_tail = increment(_tail.load());
+  return (next_tail == _head.load());
+}
+
+template <typename Element, size_t Size>
+int CircularFifo<Element, Size>::free() const {
+  return Size - used(_head.load(), _tail.load());
+}
+
+template <typename Element, size_t Size>
+bool CircularFifo<Element, Size>::isLockFree() const {
+  return (_tail.is_lock_free() && _head.is_lock_free());
+}
+
+template <typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::increment(size_t idx) const {
+  return (idx + 1) % Capacity;
+}
+
+template <typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::used(size_t head, size_t tail) const {
+  return (tail + Capacity - head) % Capacity;
+}
+
+} // namespace memory_relaxed_aquire_release
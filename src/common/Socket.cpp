@@ -80,6 +80,13 @@ void Socket::setMulticastReceive() {
   }
 }
 
+void Socket::setReusePort() {
+  if ((setsockopt(SocketFileDescriptor, SOL_SOCKET, SO_REUSEPORT, &SockOptFlagOn, sizeof(SockOptFlagOn))) < 0) {
+    LOG(IPC, Sev::Error, "setsockopt(SOL_SOCKET, SO_REUSEPORT) failed");
+    throw std::runtime_error("system error - setsockopt(SOL_SOCKET, SO_REUSEPORT) failed");
+  }
+}
+
 int Socket::setBufferSizes(int sndbuf, int rcvbuf) {
   if (sndbuf) {
     setSockOpt(SO_SNDBUF, &sndbuf, sizeof(sndbuf));
@@ -221,6 +228,43 @@ ssize_t Socket::receive(void *buffer, int buflen) {
   return recvfrom(SocketFileDescriptor, buffer, buflen, 0, (struct sockaddr *)&remoteSockAddr, &slen);
 }
 
+int Socket::receiveMultiple(char **Buffers, int BufferSize, int *Lengths,
+                            int MaxPackets) {
+#ifdef SYSTEM_NAME_DARWIN
+  // No recvmmsg() on MacOS - fall back to single packet receive
+  if (MaxPackets < 1) {
+    return 0;
+  }
+  ssize_t Ret = receive(Buffers[0], BufferSize);
+  if (Ret < 0) {
+    return Ret;
+  }
+  Lengths[0] = Ret;
+  return 1;
+#else
+  struct mmsghdr Messages[MaxBatchSize];
+  struct iovec Iovecs[MaxBatchSize];
+
+  if (MaxPackets > MaxBatchSize) {
+    MaxPackets = MaxBatchSize;
+  }
+  std::memset(Messages, 0, sizeof(Messages));
+  for (int i = 0; i < MaxPackets; i++) {
+    Iovecs[i].iov_base = Buffers[i];
+    Iovecs[i].iov_len = BufferSize;
+    Messages[i].msg_hdr.msg_iov = &Iovecs[i];
+    Messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // MSG_WAITFORONE: block for the first packet only, then return what is queued
+  int Packets = recvmmsg(SocketFileDescriptor, Messages, MaxPackets, MSG_WAITFORONE, nullptr);
+  for (int i = 0; i < Packets; i++) {
+    Lengths[i] = Messages[i].msg_len;
+  }
+  return Packets;
+#endif
+}
+
 //
 // Private methods
 //
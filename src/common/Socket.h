@@ -14,9 +14,11 @@
 #include <arpa/inet.h>
 #include <cassert>
 #include <cinttypes>
+#include <common/RingBuffer.h>
 #include <sys/socket.h>
 #include <netinet/ip.h>
 #include <unistd.h>
+#include <algorithm>
 #include <string>
 
 /// BSD Socket abstractions for TCP and UDP transmitters and receivers
@@ -24,6 +26,9 @@ class Socket {
 public:
   enum class SocketType { UDP, TCP };
 
+  /// Upper limit for the number of packets in one batched receive
+  static const int MaxBatchSize{64};
+
   class Endpoint {
   public:
     const std::string IpAddress;
@@ -59,6 +64,10 @@ public:
   //void setMulticastReceive(std::string MultiCastAddress);
   void setMulticastReceive();
 
+  /// Allow several sockets to bind to the same ip and port, the kernel
+  /// distributes incoming flows between them. Must be called before bind.
+  void setReusePort();
+
   /// Attempt to specify the socket receive and transmit buffer sizes (for performance)
   int setBufferSizes(int sndbuf, int rcvbuf);
 
@@ -89,6 +98,16 @@ public:
   /// Receive data on socket into buffer with specified length
   ssize_t receive(void *receiveBuffer, int bufferSize);
 
+  /// \brief Receive up to MaxPackets datagrams with a single system call
+  /// (recvmmsg() on Linux, a single recvfrom() elsewhere). Blocks until at
+  /// least one packet has arrived or the receive timeout expires.
+  /// \param Buffers array of MaxPackets receive buffers
+  /// \param BufferSize size of each receive buffer (bytes)
+  /// \param Lengths array of MaxPackets, holds the size of each packet
+  /// \return number of packets received, or < 0 on timeout/error
+  /// \note at most MaxBatchSize packets are received per call
+  int receiveMultiple(char **Buffers, int BufferSize, int *Lengths, int MaxPackets);
+
   /// Send data in buffer with specified length
   int send(void const *dataBuffer, int dataLength);
 
@@ -120,11 +139,52 @@ private:
 /// UDP receiver only needs to specify local socket
 class UDPReceiver : public Socket {
 public:
-  UDPReceiver(Endpoint Local) : Socket(Socket::SocketType::UDP) {
+  /// \param ReusePort set SO_REUSEPORT so that several receivers can share
+  /// the same port (one receiver per input thread)
+  UDPReceiver(Endpoint Local, bool ReusePort = false) : Socket(Socket::SocketType::UDP) {
+    if (ReusePort) {
+      this->setReusePort();
+    }
     this->setLocalSocket(Local.IpAddress, Local.Port);
   };
+
+  /// \brief Receive a batch of packets directly into the ringbuffer.
+  /// Packets are written to consecutive buffers starting at the current
+  /// data index, and the batch never wraps around the end of the ring. The
+  /// data index is NOT advanced, the caller must call getNextBuffer() for
+  /// each packet it keeps. The length of each packet is set in the ring.
+  /// \param Ring ringbuffer to receive into
+  /// \param MaxPackets maximum number of packets to receive
+  /// \return number of packets received (0 on timeout)
+  template <const unsigned int N>
+  int receiveBatch(RingBuffer<N> &Ring, int MaxPackets = MaxBatchSize);
 };
 
+template <const unsigned int N>
+int UDPReceiver::receiveBatch(RingBuffer<N> &Ring, int MaxPackets) {
+  char *Buffers[MaxBatchSize];
+  int Lengths[MaxBatchSize];
+
+  unsigned int FirstIndex = Ring.getDataIndex();
+  int Entries = (MaxPackets < MaxBatchSize) ? MaxPackets : MaxBatchSize;
+  Entries = std::min(Entries, (int)(Ring.getMaxElements() - FirstIndex));
+
+  for (int i = 0; i < Entries; i++) {
+    Ring.setDataLength(FirstIndex + i, 0);
+    Buffers[i] = Ring.getDataBuffer(FirstIndex + i);
+  }
+
+  int Packets = receiveMultiple(Buffers, Ring.getMaxBufSize(), Lengths, Entries);
+  if (Packets <= 0) {
+    return 0;
+  }
+
+  for (int i = 0; i < Packets; i++) {
+    Ring.setDataLength(FirstIndex + i, Lengths[i]);
+  }
+  return Packets;
+}
+
 /// UDP transmitter needs to specify both local and remote socket
 class UDPTransmitter : public Socket {
 public:
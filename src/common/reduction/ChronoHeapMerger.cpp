@@ -0,0 +1,132 @@
+/** Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file **/
+
+//===----------------------------------------------------------------------===//
+///
+/// \file ChronoHeapMerger.cpp
+/// \brief ChronoHeapMerger class implementation
+///
+//===----------------------------------------------------------------------===//
+
+#include <common/reduction/ChronoHeapMerger.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+ChronoHeapMerger::ChronoHeapMerger(uint64_t maximum_latency, size_t modules)
+    : maximum_latency_(maximum_latency) {
+  queues_.resize(modules);
+  latest_.resize(modules, 0);
+  heap_.reserve(modules);
+}
+
+bool ChronoHeapMerger::later(size_t module1, size_t module2) const {
+  auto t1 = queues_[module1].front().time;
+  auto t2 = queues_[module2].front().time;
+  return (t1 > t2) || ((t1 == t2) && (module1 > module2));
+}
+
+void ChronoHeapMerger::insert(size_t module, NeutronEvent event) {
+  auto &queue = queues_.at(module);
+  latest_[module] = std::max(event.time, latest_[module]);
+
+  auto heap_order = [this](size_t m1, size_t m2) { return later(m1, m2); };
+
+  if (queue.empty()) {
+    queue.push_back(event);
+    heap_.push_back(module);
+    std::push_heap(heap_.begin(), heap_.end(), heap_order);
+    return;
+  }
+
+  if (event.time >= queue.back().time) {
+    queue.push_back(event);
+    return;
+  }
+
+  // out of order, keep queue sorted (after events with equal times)
+  auto it = std::upper_bound(queue.begin(), queue.end(), event,
+      [](const NeutronEvent &e1, const NeutronEvent &e2) {
+        return e1.time < e2.time;
+      });
+  bool new_front = (it == queue.begin());
+  queue.insert(it, event);
+  if (new_front) {
+    std::make_heap(heap_.begin(), heap_.end(), heap_order);
+  }
+}
+
+void ChronoHeapMerger::insert(size_t module, std::list<NeutronEvent>& events) {
+  for (const auto& event : events) {
+    insert(module, event);
+  }
+  events.clear();
+}
+
+void ChronoHeapMerger::sync_up(size_t module1, size_t module2) {
+  latest_[module1] = latest_[module2] = std::max(latest_[module1], latest_[module2]);
+}
+
+void ChronoHeapMerger::reset() {
+  latest_.assign(latest_.size(), 0);
+}
+
+bool ChronoHeapMerger::empty() const {
+  return heap_.empty();
+}
+
+uint64_t ChronoHeapMerger::earliest() const {
+  return queues_[heap_.front()].front().time;
+}
+
+uint64_t ChronoHeapMerger::horizon() const {
+  uint64_t ret = std::numeric_limits<uint64_t>::max();
+  for (const auto &l : latest_)
+    ret = std::min(ret, l);
+  if (ret == std::numeric_limits<uint64_t>::max())
+    return 0;
+  return ret;
+}
+
+NeutronEvent ChronoHeapMerger::pop_earliest() {
+  auto heap_order = [this](size_t m1, size_t m2) { return later(m1, m2); };
+
+  std::pop_heap(heap_.begin(), heap_.end(), heap_order);
+  auto module = heap_.back();
+  auto &queue = queues_[module];
+  auto ret = queue.front();
+  queue.pop_front();
+  if (queue.empty()) {
+    heap_.pop_back();
+  } else {
+    std::push_heap(heap_.begin(), heap_.end(), heap_order);
+  }
+  return ret;
+}
+
+bool ChronoHeapMerger::ready() const {
+  if (empty())
+    return false;
+  auto h = horizon();
+  if (h < maximum_latency_)
+    return false;
+  return (earliest() < (h - maximum_latency_));
+}
+
+std::string ChronoHeapMerger::debug(const std::string& prepend, bool verbose) const {
+  std::stringstream ss;
+  ss << prepend << "Maximum latency: " << maximum_latency_ << "\n";
+  ss << prepend << "Latest times:\n";
+  for (size_t i=0; i < latest_.size(); ++i) {
+    ss << prepend << "  [" << i << "]  " << latest_[i]
+       << "  queued " << queues_[i].size() << "\n";
+  }
+  if (verbose && !empty()) {
+    ss << prepend << "Queue:\n";
+    for (size_t i=0; i < queues_.size(); ++i) {
+      for (const auto& e : queues_[i]) {
+        ss << prepend << "  [" << i << "]  " << e.to_string() << "\n";
+      }
+    }
+  }
+  return ss.str();
+}
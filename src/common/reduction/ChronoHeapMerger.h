@@ -0,0 +1,90 @@
+/** Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file **/
+
+//===----------------------------------------------------------------------===//
+///
+/// \file ChronoHeapMerger.h
+/// \brief ChronoHeapMerger class definition
+///
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/reduction/NeutronEvent.h>
+
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <vector>
+
+/// \class ChronoHeapMerger ChronoHeapMerger.h
+/// \brief Drop-in alternative to ChronoMerger with the same latency and
+///        horizon semantics. Events are kept in one time ordered queue per
+///        pipeline and are released through a k-way merge over a min-heap
+///        of the pipeline queues. The queue is ordered at all times, so
+///        sort() is a no-op and the cost of an insert does not grow with
+///        the number of queued events when pipelines deliver events
+///        (nearly) in order. Events with equal times from different
+///        pipelines are released in order of pipeline id.
+
+class ChronoHeapMerger {
+public:
+  /// \brief Constructor, see ChronoMerger
+  /// \param maximum_latency time delay after which events are released
+  /// \param modules number of independent pipelines to synchronize
+  explicit ChronoHeapMerger(uint64_t maximum_latency, size_t modules);
+
+  /// \brief Inserts one NeutronEvent into queue.
+  /// \param module Identifies the pipeline from which the event originates.
+  /// \param event One event to be added to the queue.
+  void insert(size_t module, NeutronEvent event);
+
+  /// \brief Moves the events of an external queue into the Merger's queue.
+  /// \param module Identifies the pipeline from which events originate.
+  /// \param events Queue of events, will be rendered empty.
+  void insert(size_t module, std::list<NeutronEvent>& events);
+
+  /// \brief Forcibly syncs up the time horizons of two pipelines, see ChronoMerger
+  void sync_up(size_t module1, size_t module2);
+
+  /// \brief The queue is always ordered, kept for compatibility with ChronoMerger
+  void sort() {}
+
+  /// \brief Resets the time horizons to 0.
+  void reset();
+
+  /// \returns true if queue is empty
+  bool empty() const;
+
+  /// \returns timestamp of earliest event in queue
+  uint64_t earliest() const;
+
+  /// \returns the global time horizon for all tracked pipelines, i.e. the
+  ///          earliest of the latest times seen from each pipeline
+  uint64_t horizon() const;
+
+  /// \returns true if pipeline is non-empty and earliest event in queue is outside
+  ///          the maximum latency window in relation to the global time horizon.
+  bool ready() const;
+
+  /// \returns the earliest event in queue.
+  /// \post earliest event will be removed from queue
+  NeutronEvent pop_earliest();
+
+  /// \brief prints queue config and contents for debug purposes
+  std::string debug(const std::string& prepend, bool verbose) const;
+
+private:
+  /// \brief heap order, earliest front event (then lowest module) on top
+  bool later(size_t module1, size_t module2) const;
+
+  /// Time ordered queue of neutron events for each pipeline
+  std::vector<std::deque<NeutronEvent>> queues_;
+
+  /// Min-heap of ids of the pipelines with non-empty queues
+  std::vector<size_t> heap_;
+
+  /// Latest event time seen for each pipeline
+  std::vector<uint64_t> latest_;
+
+  uint64_t maximum_latency_;
+};
@@ -9,6 +9,7 @@
 
 #include <common/reduction/ChronoMerger.h>
 #include <algorithm>
+#include <limits>
 
 #include <iosfwd>
 
@@ -100,6 +100,78 @@ void Cluster::insert(const Hit &e) {
   coord_end_ = std::max(coord_end_, e.coordinate);
 }
 
+void Cluster::insert(const HitColumns &columns, size_t begin, size_t end) {
+  if (begin >= end) {
+    return;
+  }
+
+  const uint64_t *time = columns.time.data();
+  const uint16_t *coordinate = columns.coordinate.data();
+  const uint16_t *weight = columns.weight.data();
+  const uint8_t *plane = columns.plane.data();
+
+  if (hits.empty()) {
+    plane_ = plane[begin];
+    time_start_ = time_end_ = time[begin];
+    coord_start_ = coord_end_ = coordinate[begin];
+    utpc_idx_min_ = 0;
+    utpc_idx_max_ = 0;
+  }
+
+  // Weight and coordinate products are integers below 2^48, so their sums
+  // are exact, as are the double sums of insert(Hit) until they reach 2^53
+  uint64_t We{0}, We2{0}, WeCo{0}, We2Co{0};
+  uint16_t coord_min{coord_start_};
+  uint16_t coord_max{coord_end_};
+  uint8_t plane_mismatch{0};
+  for (size_t i = begin; i < end; i++) {
+    uint64_t w = weight[i];
+    uint64_t c = coordinate[i];
+    We += w;
+    We2 += w * w;
+    WeCo += w * c;
+    We2Co += w * w * c;
+    coord_min = (coordinate[i] < coord_min) ? coordinate[i] : coord_min;
+    coord_max = (coordinate[i] > coord_max) ? coordinate[i] : coord_max;
+    plane_mismatch |= static_cast<uint8_t>(plane[i] != plane_);
+  }
+
+  // If plane identities don't match, invalidate
+  if (plane_mismatch) {
+    plane_ = Hit::InvalidPlane;
+  }
+
+  weight_sum_ += static_cast<double>(We);
+  weight2_sum_ += static_cast<double>(We2);
+  coord_mass_ += static_cast<double>(WeCo);
+  coord_mass2_ += static_cast<double>(We2Co);
+  coord_start_ = coord_min;
+  coord_end_ = coord_max;
+
+  // Time masses are not exact in double, keep the order of insert(Hit)
+  int index = static_cast<int>(hits.size());
+  for (size_t i = begin; i < end; i++, index++) {
+    double weight64 = static_cast<double>(weight[i]);
+    double time64 = static_cast<double>(time[i]);
+    time_mass_ += weight64 * time64;
+    time_mass2_ += weight64 * weight64 * time64;
+
+    time_start_ = std::min(time_start_, time[i]);
+    if (time[i] == time_end_) {
+      utpc_idx_max_ = index;
+    } else if (time[i] > time_end_) {
+      utpc_idx_min_ = index;
+      utpc_idx_max_ = index;
+      time_end_ = time[i];
+    }
+  }
+
+  hits.reserve(hits.size() + (end - begin));
+  for (size_t i = begin; i < end; i++) {
+    hits.push_back(columns.hit(i));
+  }
+}
+
 void Cluster::merge(Cluster &other) {
   if (other.hits.empty()) {
     return;
@@ -196,6 +268,10 @@ double Cluster::weight_sum() const {
   return weight_sum_;
 }
 
+double Cluster::weight2_sum() const {
+  return weight2_sum_;
+}
+
 double Cluster::coord_mass() const {
   return coord_mass_;
 }
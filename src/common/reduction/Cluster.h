@@ -35,6 +35,14 @@ public:
   /// \param hit to be added
   void insert(const Hit &hit);
 
+  /// \brief adds hits [begin, end) of a HitColumns container, with the same
+  ///        result as inserting them one by one. Integer weight and coordinate
+  ///        sums are accumulated over the columns in one vectorizable pass.
+  /// \param hits columns to take hits from
+  /// \param begin index of first hit to be added
+  /// \param end index after last hit to be added
+  void insert(const HitColumns &hits, size_t begin, size_t end);
+
   /// \brief merges another cluster into this one
   ///        moves the hits from the other cluster, rendering it empty
   ///        recalculates bounds and aggregates sums
@@ -30,7 +30,228 @@ HitVectorStorage::AllocConfig::PoolType* HitVectorStorage::Pool =
 PoolAllocator<HitVectorStorage::AllocConfig>
     HitVectorStorage::Alloc(*HitVectorStorage::Pool);
 
-std::size_t HitVectorStorage::MaxAllocCount = 0;
+std::atomic<std::size_t> HitVectorStorage::MaxAllocCount{0};
+
+namespace {
+
+/// \brief stable LSD radix sort of hits by Key(hit) - min key, 8 bits per
+/// pass. Only the passes needed for the key range are made, and passes
+/// where all hits fall into one bucket are skipped.
+template <typename KeyFunc> void radix_sort(HitVector &hits, KeyFunc Key) {
+  size_t n = hits.size();
+  if (n < 2) {
+    return;
+  }
+
+  uint64_t KeyMin = Key(hits[0]);
+  uint64_t KeyMax = KeyMin;
+  for (size_t i = 1; i < n; i++) {
+    uint64_t K = Key(hits[i]);
+    KeyMin = std::min(KeyMin, K);
+    KeyMax = std::max(KeyMax, K);
+  }
+  uint64_t Range = KeyMax - KeyMin;
+
+  // scratch buffer per thread, hits are copied back if needed
+  static thread_local std::vector<Hit> Scratch;
+  Scratch.resize(n);
+  Hit *Src = hits.data();
+  Hit *Dst = Scratch.data();
+
+  for (unsigned int Shift = 0; (Shift < 64) and ((Range >> Shift) != 0);
+       Shift += 8) {
+    size_t Count[256] = {0};
+    for (size_t i = 0; i < n; i++) {
+      Count[((Key(Src[i]) - KeyMin) >> Shift) & 0xff]++;
+    }
+    if (Count[((Key(Src[0]) - KeyMin) >> Shift) & 0xff] == n) {
+      continue;
+    }
+
+    size_t Offset{0};
+    for (auto &C : Count) {
+      size_t Bucket = C;
+      C = Offset;
+      Offset += Bucket;
+    }
+    for (size_t i = 0; i < n; i++) {
+      Dst[Count[((Key(Src[i]) - KeyMin) >> Shift) & 0xff]++] = Src[i];
+    }
+    std::swap(Src, Dst);
+  }
+
+  if (Src != hits.data()) {
+    std::copy(Src, Src + n, hits.data());
+  }
+}
+
+} // namespace
+
+void radix_sort_chronologically(HitVector &hits) {
+  radix_sort(hits, [](const Hit &hit) -> uint64_t { return hit.time; });
+}
+
+void radix_sort_by_increasing_coordinate(HitVector &hits) {
+  radix_sort(hits, [](const Hit &hit) -> uint64_t { return hit.coordinate; });
+}
+
+void HitColumns::append(const HitVector &hits) {
+  reserve(size() + hits.size());
+  for (const auto &hit : hits) {
+    push_back(hit);
+  }
+}
+
+void HitColumns::append(const HitColumns &other, size_t begin, size_t end) {
+  time.insert(time.end(), other.time.begin() + begin, other.time.begin() + end);
+  coordinate.insert(coordinate.end(), other.coordinate.begin() + begin,
+                    other.coordinate.begin() + end);
+  weight.insert(weight.end(), other.weight.begin() + begin,
+                other.weight.begin() + end);
+  plane.insert(plane.end(), other.plane.begin() + begin,
+               other.plane.begin() + end);
+}
+
+void HitColumns::copy_to(HitVector &hits) const {
+  hits.reserve(hits.size() + size());
+  for (size_t i = 0; i < size(); i++) {
+    hits.push_back(hit(i));
+  }
+}
+
+namespace {
+
+/// \brief sort order of the key column, as indices into the columns
+template <typename T>
+void sort_order(const std::vector<T> &key, HitSort method,
+                std::vector<uint32_t> &Order) {
+  size_t n = key.size();
+  Order.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    Order[i] = i;
+  }
+
+  if ((method == HitSort::Radix) and (n >= RadixSortMinHits)) {
+    T KeyMin = *std::min_element(key.begin(), key.end());
+    T KeyMax = *std::max_element(key.begin(), key.end());
+    uint64_t Range = KeyMax - KeyMin;
+    static thread_local std::vector<uint32_t> OrderScratch;
+    OrderScratch.resize(n);
+    for (unsigned int Shift = 0; (Shift < 64) and ((Range >> Shift) != 0);
+         Shift += 8) {
+      size_t Count[256] = {0};
+      for (size_t i = 0; i < n; i++) {
+        Count[((uint64_t(key[i]) - KeyMin) >> Shift) & 0xff]++;
+      }
+      if (Count[((uint64_t(key[0]) - KeyMin) >> Shift) & 0xff] == n) {
+        continue;
+      }
+      size_t Offset{0};
+      for (auto &C : Count) {
+        size_t Bucket = C;
+        C = Offset;
+        Offset += Bucket;
+      }
+      for (size_t i = 0; i < n; i++) {
+        auto Index = Order[i];
+        OrderScratch[Count[((uint64_t(key[Index]) - KeyMin) >> Shift) & 0xff]++] =
+            Index;
+      }
+      std::swap(Order, OrderScratch);
+    }
+  } else {
+    std::sort(Order.begin(), Order.end(),
+              [&key](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+  }
+}
+
+/// \brief for 16 bit keys the key and index are packed into one integer,
+/// which sorts without indirection and keeps equal keys in order
+void sort_order(const std::vector<uint16_t> &key, HitSort method,
+                std::vector<uint32_t> &Order) {
+  size_t n = key.size();
+  static thread_local std::vector<uint64_t> Packed;
+  Packed.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    Packed[i] = (uint64_t(key[i]) << 32) | i;
+  }
+
+  if ((method == HitSort::Radix) and (n >= RadixSortMinHits)) {
+    static thread_local std::vector<uint64_t> PackedScratch;
+    PackedScratch.resize(n);
+    for (unsigned int Shift = 32; Shift < 48; Shift += 8) {
+      size_t Count[256] = {0};
+      for (size_t i = 0; i < n; i++) {
+        Count[(Packed[i] >> Shift) & 0xff]++;
+      }
+      if (Count[(Packed[0] >> Shift) & 0xff] == n) {
+        continue;
+      }
+      size_t Offset{0};
+      for (auto &C : Count) {
+        size_t Bucket = C;
+        C = Offset;
+        Offset += Bucket;
+      }
+      for (size_t i = 0; i < n; i++) {
+        PackedScratch[Count[(Packed[i] >> Shift) & 0xff]++] = Packed[i];
+      }
+      std::swap(Packed, PackedScratch);
+    }
+  } else {
+    std::sort(Packed.begin(), Packed.end());
+  }
+
+  Order.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    Order[i] = static_cast<uint32_t>(Packed[i]);
+  }
+}
+
+/// \brief reorder all columns by the key column: builds the permutation
+/// on the key column only, then gathers each column once
+template <typename T>
+void sort_columns(HitColumns &hits, const std::vector<T> &key, HitSort method) {
+  size_t n = hits.size();
+  if (n < 2) {
+    return;
+  }
+
+  static thread_local std::vector<uint32_t> Order;
+  sort_order(key, method, Order);
+
+  static thread_local HitColumns Scratch;
+  Scratch.time.resize(n);
+  Scratch.coordinate.resize(n);
+  Scratch.weight.resize(n);
+  Scratch.plane.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    Scratch.time[i] = hits.time[Order[i]];
+  }
+  for (size_t i = 0; i < n; i++) {
+    Scratch.coordinate[i] = hits.coordinate[Order[i]];
+  }
+  for (size_t i = 0; i < n; i++) {
+    Scratch.weight[i] = hits.weight[Order[i]];
+  }
+  for (size_t i = 0; i < n; i++) {
+    Scratch.plane[i] = hits.plane[Order[i]];
+  }
+  std::swap(hits.time, Scratch.time);
+  std::swap(hits.coordinate, Scratch.coordinate);
+  std::swap(hits.weight, Scratch.weight);
+  std::swap(hits.plane, Scratch.plane);
+}
+
+} // namespace
+
+void sort_chronologically(HitColumns &hits, HitSort method) {
+  sort_columns(hits, hits.time, method);
+}
+
+void sort_by_increasing_coordinate(HitColumns &hits, HitSort method) {
+  sort_columns(hits, hits.coordinate, method);
+}
 
 std::string to_string(const HitVector &vec, const std::string &prepend) {
   std::stringstream ss;
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <common/Arena.h>
 #include <common/PoolAllocator.h>
 #include <common/reduction/Hit.h>
+#include <atomic>
 
 #define ENABLE_GREEDY_HIT_ALLOCATOR 0
 
@@ -120,6 +122,10 @@ public:
     return Vec.insert(position, first, last);
   }
 
+  iterator erase(const_iterator first, const_iterator last) {
+    return Vec.erase(first, last);
+  }
+
   // make sure we reserve enough, as clear() is (possibly) needed to re-use a
   // vector after it has been std::move'd
   void clear() noexcept {
@@ -138,7 +144,13 @@ struct HitVectorStorage {
       PoolAllocatorConfig<Hit, Bytes_1GB, MyVector<Hit>::MinReserveCount, false, true>;
   static AllocConfig::PoolType *Pool;
   static PoolAllocator<AllocConfig> Alloc;
-  static std::size_t MaxAllocCount;
+  static std::atomic<std::size_t> MaxAllocCount;
+
+  /// \brief move the pool to huge page or mlock()ed memory (--hugepages),
+  /// must be called before the pool is used, see usePinnedPool()
+  static int64_t pin(int NumaNode) {
+    return usePinnedPool(Pool, Alloc, NumaNode);
+  }
 };
 
 template <class T> struct HitVectorAllocator {
@@ -149,22 +161,32 @@ template <class T> struct HitVectorAllocator {
   constexpr HitVectorAllocator(const HitVectorAllocator<U> &) noexcept {}
 
   T *allocate(std::size_t n) {
-    /// \todo (mortenhs): This don't work when a vector is (default)
-    // copy-constructed because it will only have the capacity of it's source
-    // vector.
-    if (0) {
-      RelAssertMsg(n >= MyVector<Hit>::MinReserveCount,
-                   "Reserve not properly called somewhere. Could be a move-"
-                   "semantic issue.");
+    /// \todo (mortenhs): assert n >= MyVector<Hit>::MinReserveCount. This
+    // doesn't work when a vector is (default) copy-constructed because it
+    // will only have the capacity of it's source vector.
+
+    // allocations can be made by several threads (see SharedPoolScope)
+    std::size_t Max = HitVectorStorage::MaxAllocCount.load(std::memory_order_relaxed);
+    while (n > Max and not HitVectorStorage::MaxAllocCount.compare_exchange_weak(
+                           Max, n, std::memory_order_relaxed)) {
     }
-    if (0 && n > HitVectorStorage::MaxAllocCount) {
+    if (n > Max) {
       XTRACE(MAIN, CRI, "HitVector max size %zu", n);
-      HitVectorStorage::MaxAllocCount = n;
     }
 
+    // arena of the calling thread, if any (see ArenaScope)
+    if (Arena *Memory = Arena::current()) {
+      if (void *p = Memory->allocate(n * sizeof(T))) {
+        return (T *)p;
+      }
+    }
     return HitVectorStorage::Alloc.allocate(n);
   }
   void deallocate(T *p, std::size_t n) noexcept {
+    if (Arena::contains(p)) {
+      Arena::deallocate(p);
+      return;
+    }
     HitVectorStorage::Alloc.deallocate(p, n);
   }
 };
@@ -186,15 +208,40 @@ bool operator!=(const HitVectorAllocator<T> &, const HitVectorAllocator<U> &) {
 // using HitVector = MyVector<Hit, GreedyHitAllocator<Hit>>;
 using HitVector = MyVector<Hit, HitVectorAllocator<Hit>>;
 
+/// \brief sorting algorithm used by the Hit sort helpers
+/// StdSort - std::sort (comparison sort, not stable)
+/// Radix   - stable LSD radix sort on the key range of the container, with
+///           std::sort for less than RadixSortMinHits hits
+enum class HitSort { StdSort, Radix };
+
+/// \brief below this many hits the radix sort uses std::sort
+static constexpr size_t RadixSortMinHits{512};
+
+/// \brief radix sort Hits by increasing time
+void radix_sort_chronologically(HitVector &hits);
+
+/// \brief radix sort Hits by increasing coordinate
+void radix_sort_by_increasing_coordinate(HitVector &hits);
+
 /// \brief convenience function for sorting Hits by increasing time
-inline void sort_chronologically(HitVector &hits) {
+inline void sort_chronologically(HitVector &hits,
+                                 HitSort method = HitSort::StdSort) {
+  if ((method == HitSort::Radix) and (hits.size() >= RadixSortMinHits)) {
+    radix_sort_chronologically(hits);
+    return;
+  }
   std::sort(hits.begin(), hits.end(), [](const Hit &hit1, const Hit &hit2) {
     return hit1.time < hit2.time;
   });
 }
 
 /// \brief convenience function for sorting Hits by increasing coordinate
-inline void sort_by_increasing_coordinate(HitVector &hits) {
+inline void sort_by_increasing_coordinate(HitVector &hits,
+                                          HitSort method = HitSort::StdSort) {
+  if ((method == HitSort::Radix) and (hits.size() >= RadixSortMinHits)) {
+    radix_sort_by_increasing_coordinate(hits);
+    return;
+  }
   std::sort(hits.begin(), hits.end(), [](const Hit &hit1, const Hit &hit2) {
     return hit1.coordinate < hit2.coordinate;
   });
@@ -207,6 +254,76 @@ inline void sort_by_decreasing_weight(HitVector &hits) {
   });
 }
 
+//-----------------------------------------------------------------------------
+
+/// \class HitColumns
+/// \brief Structure-of-arrays alternative to HitVector, with one contiguous
+/// and aligned column per Hit member. Passes that only need one or two
+/// members (gap detection, sorting, mass sums) touch only those columns
+/// and can be vectorized, which is not possible on the packed Hit.
+/// Use Cluster::insert(const HitColumns &, ...) and
+/// GapClusterer::cluster(const HitColumns &) to cluster from columns.
+class HitColumns {
+public:
+  std::vector<uint64_t> time;
+  std::vector<uint16_t> coordinate;
+  std::vector<uint16_t> weight;
+  std::vector<uint8_t> plane;
+
+  HitColumns() = default;
+  explicit HitColumns(const HitVector &hits) { append(hits); }
+
+  size_t size() const { return time.size(); }
+  bool empty() const { return time.empty(); }
+
+  void clear() {
+    time.clear();
+    coordinate.clear();
+    weight.clear();
+    plane.clear();
+  }
+
+  void reserve(size_t n) {
+    time.reserve(n);
+    coordinate.reserve(n);
+    weight.reserve(n);
+    plane.reserve(n);
+  }
+
+  void push_back(const Hit &hit) {
+    time.push_back(hit.time);
+    coordinate.push_back(hit.coordinate);
+    weight.push_back(hit.weight);
+    plane.push_back(hit.plane);
+  }
+
+  /// \returns copy of hit i
+  Hit hit(size_t i) const {
+    Hit ret;
+    ret.time = time[i];
+    ret.coordinate = coordinate[i];
+    ret.weight = weight[i];
+    ret.plane = plane[i];
+    return ret;
+  }
+
+  /// \brief appends all hits of an AoS container
+  void append(const HitVector &hits);
+
+  /// \brief appends hits [begin, end) of other columns
+  void append(const HitColumns &other, size_t begin, size_t end);
+
+  /// \brief appends all hits to an AoS container
+  void copy_to(HitVector &hits) const;
+};
+
+/// \brief sort HitColumns by increasing time, see sort_chronologically()
+void sort_chronologically(HitColumns &hits, HitSort method = HitSort::StdSort);
+
+/// \brief sort HitColumns by increasing coordinate
+void sort_by_increasing_coordinate(HitColumns &hits,
+                                   HitSort method = HitSort::StdSort);
+
 /// \brief convenience function for printing vector of Hits
 std::string to_string(const HitVector &vec, const std::string &prepend);
 
@@ -62,6 +62,21 @@ struct ClusterPoolStorage {
       PoolAllocatorConfig<StorageGuess, Bytes_1GB, ObjectsPerSlot, false, true>;
   static AllocConfig::PoolType *Pool;
   static PoolAllocator<AllocConfig> Alloc;
+
+  /// \brief move the pool to huge page or mlock()ed memory (--hugepages),
+  /// must be called before the pool is used, see usePinnedPool()
+  static int64_t pin(int NumaNode) {
+    return usePinnedPool(Pool, Alloc, NumaNode);
+  }
+};
+
+/// \brief makes the hit and cluster pools Shared while the threads of a
+/// reduction (de)allocate concurrently, see SharedPoolScope
+struct SharedReductionPools {
+  SharedPoolScope<HitVectorStorage::AllocConfig::PoolType> Hits{
+      *HitVectorStorage::Pool};
+  SharedPoolScope<ClusterPoolStorage::AllocConfig::PoolType> Clusters{
+      *ClusterPoolStorage::Pool};
 };
 
 template <class T> struct ClusterPoolAllocator {
@@ -86,10 +101,20 @@ template <class T> struct ClusterPoolAllocator {
   T *allocate(std::size_t n) {
     RelAssertMsg(n == 1, "not expecting bulk allocation from std::list");
     // if (!std::is_same<T, Cluster>::value) XTRACE(MAIN, CRI, "node");
+    // arena of the calling thread, if any (see ArenaScope)
+    if (Arena *Memory = Arena::current()) {
+      if (void *p = Memory->allocate(sizeof(T))) {
+        return (T *)p;
+      }
+    }
     return (T *)ClusterPoolStorage::Alloc.allocate(1);
   }
 
   void deallocate(T *p, std::size_t n) noexcept {
+    if (Arena::contains(p)) {
+      Arena::deallocate(p);
+      return;
+    }
     ClusterPoolStorage::Alloc.deallocate((ClusterPoolStorage::StorageGuess *)p,
                                          n);
   }
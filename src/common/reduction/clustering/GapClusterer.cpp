@@ -17,6 +17,12 @@ GapClusterer::GapClusterer(uint64_t max_time_gap, uint16_t max_coord_gap)
       max_coord_gap_(max_coord_gap) {}
 
 void GapClusterer::insert(const Hit &hit) {
+  /// Continue a time cluster started by cluster(const HitColumns &)
+  if (!current_time_columns_.empty()) {
+    current_time_columns_.copy_to(current_time_cluster_);
+    current_time_columns_.clear();
+  }
+
   /// Process time-cluster if time gap to next hit is large enough
   if (!current_time_cluster_.empty() &&
       (hit.time - current_time_cluster_.back().time) > max_time_gap_) {
@@ -38,8 +44,65 @@ void GapClusterer::cluster(const HitVector &hits) {
   }
 }
 
+void GapClusterer::cluster(const HitColumns &hits) {
+  /// Continue a time cluster started by insert()
+  if (!current_time_cluster_.empty()) {
+    current_time_columns_.append(current_time_cluster_);
+    current_time_cluster_.clear();
+  }
+
+  size_t n = hits.size();
+  if (n == 0) {
+    return;
+  }
+
+  const uint64_t *time = hits.time.data();
+  if (!current_time_columns_.empty() &&
+      (time[0] - current_time_columns_.time.back()) > max_time_gap_) {
+    flush();
+  }
+
+  size_t begin{0};
+  while (begin < n) {
+    size_t gap = next_time_gap(time, begin + 1, n);
+    current_time_columns_.append(hits, begin, gap);
+    if (gap < n) {
+      XTRACE(CLUSTER, DEB, "timegap > %lu, hit: %lu, current: %lu",
+             max_time_gap_, time[gap], time[gap - 1]);
+      flush();
+    }
+    begin = gap;
+  }
+}
+
+size_t GapClusterer::next_time_gap(const uint64_t *time, size_t begin,
+                                   size_t end) const {
+  /// test blocks of hits without branching, so the compiler can vectorize
+  const size_t Block{16};
+  size_t i = begin;
+  for (; i + Block <= end; i += Block) {
+    bool found{false};
+    for (size_t j = i; j < i + Block; j++) {
+      found |= (time[j] - time[j - 1]) > max_time_gap_;
+    }
+    if (found) {
+      break;
+    }
+  }
+  for (; i < end; i++) {
+    if ((time[i] - time[i - 1]) > max_time_gap_) {
+      return i;
+    }
+  }
+  return end;
+}
+
 void GapClusterer::flush() {
   XTRACE(CLUSTER, DEB, "flushing");
+  if (!current_time_columns_.empty()) {
+    cluster_columns_by_coordinate();
+    current_time_columns_.clear();
+  }
   if (current_time_cluster_.empty()) {
     return;
   }
@@ -49,7 +112,7 @@ void GapClusterer::flush() {
 
 void GapClusterer::cluster_by_coordinate() {
   /// First, sort in terms of coordinate
-  sort_by_increasing_coordinate(current_time_cluster_);
+  sort_by_increasing_coordinate(current_time_cluster_, sort_method_);
 
   Cluster cluster;
   XTRACE(CLUSTER, DEB, "cur time cluster: first coord %u, last coord %u",
@@ -80,11 +143,39 @@ void GapClusterer::cluster_by_coordinate() {
     stash_cluster(cluster);
 }
 
+void GapClusterer::cluster_columns_by_coordinate() {
+  sort_by_increasing_coordinate(current_time_columns_, sort_method_);
+
+  const uint16_t *coordinate = current_time_columns_.coordinate.data();
+  size_t n = current_time_columns_.size();
+
+  /// hits are sorted, the gap to the cluster end is the gap to the previous hit
+  Cluster cluster;
+  size_t begin{0};
+  for (size_t i = 1; i < n; i++) {
+    if ((coordinate[i] - coordinate[i - 1]) > max_coord_gap_) {
+      XTRACE(CLUSTER, DEB,
+             "Stashing cluster - max_coord_gap exceeded (%i > %i)",
+             coordinate[i] - coordinate[i - 1], max_coord_gap_);
+      cluster.insert(current_time_columns_, begin, i);
+      stash_cluster(cluster);
+      cluster.clear();
+      begin = i;
+    }
+  }
+
+  /// Stash any leftovers
+  cluster.insert(current_time_columns_, begin, n);
+  stash_cluster(cluster);
+}
+
 std::string GapClusterer::config(const std::string &prepend) const {
   std::stringstream ss;
   ss << "GapClusterer:\n";
   ss << prepend << fmt::format("max_time_gap={}\n", max_time_gap_);
   ss << prepend << fmt::format("max_coord_gap={}\n", max_coord_gap_);
+  ss << prepend << fmt::format("sort_method={}\n",
+      (sort_method_ == HitSort::Radix) ? "radix" : "std::sort");
   return ss.str();
 }
 
@@ -95,5 +186,11 @@ std::string GapClusterer::status(const std::string &prepend,
   if (!current_time_cluster_.empty())
     ss << prepend << "Current time cluster:\n"
        << to_string(current_time_cluster_, prepend + "  ") + "\n";
+  if (!current_time_columns_.empty()) {
+    HitVector hits;
+    current_time_columns_.copy_to(hits);
+    ss << prepend << "Current time cluster:\n"
+       << to_string(hits, prepend + "  ") + "\n";
+  }
   return ss.str();
 }
@@ -37,9 +37,20 @@ public:
   ///        sorted within the container and between subsequent calls.
   void cluster(const HitVector &hits) override;
 
+  /// \brief insert new hits from columns and perform clustering, with the
+  ///        same result as cluster(const HitVector &). Time and coordinate
+  ///        gaps are found on the time and coordinate columns alone and
+  ///        clusters are filled with Cluster::insert(const HitColumns &, ...)
+  /// \param hits columns of hits to be processed, chronologically sorted
+  ///        within the container and between subsequent calls.
+  void cluster(const HitColumns &hits);
+
   /// \brief complete clustering for any remaining hits
   void flush() override;
 
+  /// \brief select the sort used for the coordinates of time clusters
+  void set_sort_method(HitSort method) { sort_method_ = method; }
+
   /// \brief print configuration of GapClusterer
   std::string config(const std::string &prepend) const override;
 
@@ -49,9 +60,18 @@ public:
 private:
   uint64_t max_time_gap_;
   uint16_t max_coord_gap_;
+  HitSort sort_method_{HitSort::StdSort};
 
   HitVector current_time_cluster_; ///< kept in memory until time gap encountered
+  HitColumns current_time_columns_; ///< same, for cluster(const HitColumns &)
 
   /// \brief helper function to clusters hits in current_time_cluster_
   void cluster_by_coordinate();
+
+  /// \brief helper function to clusters hits in current_time_columns_
+  void cluster_columns_by_coordinate();
+
+  /// \returns index of first hit in [begin, end) with a time gap to the
+  ///          previous hit larger than max_time_gap_, or end
+  size_t next_time_gap(const uint64_t *time, size_t begin, size_t end) const;
 };
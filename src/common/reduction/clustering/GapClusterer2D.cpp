@@ -8,21 +8,40 @@
 
 #include <common/reduction/clustering/GapClusterer2D.h>
 #include <common/Trace.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
 
+constexpr uint32_t GapClusterer2D::NoCluster;
+
 GapClusterer2D::GapClusterer2D(uint64_t max_time_gap, uint16_t max_coord_gap)
     : AbstractClusterer(), max_time_gap_(max_time_gap), max_coord_gap_(max_coord_gap) {}
 
 void GapClusterer2D::set_geometry(const Multigrid::ModuleGeometry &geom) {
+  if (streaming_) {
+    flush();
+  }
   geometry_ = geom;
+  grid_valid_ = false;
 }
 
 Multigrid::ModuleGeometry GapClusterer2D::geometry() const {
   return geometry_;
 }
 
+void GapClusterer2D::set_streaming(bool streaming) {
+  flush();
+  streaming_ = streaming;
+}
+
 void GapClusterer2D::insert(const Hit &hit) {
+  if (streaming_) {
+    insert_streaming(hit);
+    return;
+  }
+
   /// Process time-cluster if time gap to next hit is large enough
   if (!current_time_cluster_.empty() &&
       (hit.time - current_time_cluster_.back().time) > max_time_gap_) {
@@ -41,6 +60,10 @@ void GapClusterer2D::cluster(const HitVector &hits) {
 }
 
 void GapClusterer2D::flush() {
+  if (streaming_) {
+    flush_streaming();
+    return;
+  }
   if (current_time_cluster_.empty()) {
     return;
   }
@@ -105,11 +128,218 @@ void GapClusterer2D::stash_cluster(HitVector& xz_cluster) {
   AbstractClusterer::stash_cluster(cluster);
 }
 
+void GapClusterer2D::build_grid() {
+  wire_x_.clear();
+  wire_z_.clear();
+
+  /// Every wire of the geometry has its own (x, z) position
+  size_t wires = std::min(size_t(geometry_.x_range()) * geometry_.z_range(),
+                          size_t(std::numeric_limits<uint16_t>::max()) + 1);
+  for (size_t w = 0; w < wires; w++) {
+    wire_x_.push_back(geometry_.x_from_wire(uint16_t(w)));
+    wire_z_.push_back(geometry_.z_from_wire(uint16_t(w)));
+  }
+
+  grid_x0_ = geometry_.x_offset;
+  grid_x1_ = grid_x0_ + int64_t(geometry_.x_range()) - 1;
+  grid_z0_ = geometry_.z_offset;
+  grid_z1_ = grid_z0_ + int64_t(geometry_.z_range()) - 1;
+  if (wires == 0) {
+    grid_x1_ = grid_x0_ - 1;
+  }
+
+  grid_.assign(wires, GridCell());
+  epoch_ = 1;
+  grid_valid_ = true;
+}
+
+uint32_t GapClusterer2D::find_slot(uint32_t slot) {
+  uint32_t root = slot;
+  while (slots_[root].parent != root) {
+    root = slots_[root].parent;
+  }
+  while (slots_[slot].parent != root) {
+    uint32_t next = slots_[slot].parent;
+    slots_[slot].parent = root;
+    slot = next;
+  }
+  return root;
+}
+
+uint32_t GapClusterer2D::new_slot() {
+  uint32_t slot;
+  if (free_slots_.empty()) {
+    slot = uint32_t(slots_.size());
+    slots_.emplace_back();
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  slots_[slot].parent = slot;
+  slots_[slot].open = true;
+  return slot;
+}
+
+void GapClusterer2D::link(uint32_t slot) {
+  uint32_t root = find_slot(slot);
+  if (std::find(linked_.begin(), linked_.end(), root) == linked_.end()) {
+    linked_.push_back(root);
+  }
+}
+
+uint32_t GapClusterer2D::merge_linked() {
+  uint32_t root = linked_.front();
+  for (auto slot : linked_) {
+    if (slots_[slot].cluster.hit_count() > slots_[root].cluster.hit_count()) {
+      root = slot;
+    }
+  }
+
+  auto &merged = slots_[root].merged;
+  for (auto slot : linked_) {
+    if (slot == root) {
+      continue;
+    }
+    auto &other = slots_[slot];
+    slots_[root].cluster.merge(other.cluster);
+    other.parent = root;
+    other.open = false;
+    merged.push_back(slot);
+    merged.insert(merged.end(), other.merged.begin(), other.merged.end());
+    other.merged.clear();
+  }
+  return root;
+}
+
+void GapClusterer2D::stash_open(uint32_t slot) {
+  auto &open = slots_[slot];
+  AbstractClusterer::stash_cluster(open.cluster);
+  open.cluster.clear();
+  open.open = false;
+  open.parent = NoCluster;
+  free_slots_.push_back(slot);
+  for (auto merged : open.merged) {
+    slots_[merged].parent = NoCluster;
+    free_slots_.push_back(merged);
+  }
+  open.merged.clear();
+}
+
+void GapClusterer2D::close_streaming(uint64_t time) {
+  /// Entries are chronological, the first still in reach ends the search
+  while (!horizon_.empty() && (time - horizon_.front().first) > max_time_gap_) {
+    auto slot = horizon_.front().second;
+    horizon_.pop_front();
+    if (slots_[slot].parent == NoCluster) {
+      continue;
+    }
+    auto root = find_slot(slot);
+    if (slots_[root].open &&
+        (time - slots_[root].cluster.time_end()) > max_time_gap_) {
+      stash_open(root);
+    }
+  }
+}
+
+void GapClusterer2D::insert_streaming(const Hit &hit) {
+  if (!grid_valid_) {
+    build_grid();
+  }
+
+  close_streaming(hit.time);
+
+  bool on_grid = (hit.coordinate < wire_x_.size());
+  int64_t x = on_grid ? wire_x_[hit.coordinate]
+                      : geometry_.x_from_wire(hit.coordinate);
+  int64_t z = on_grid ? wire_z_[hit.coordinate]
+                      : geometry_.z_from_wire(hit.coordinate);
+
+  auto in_reach = [this, &hit](uint64_t time) {
+    return (time <= hit.time) && (hit.time - time) <= max_time_gap_;
+  };
+
+  linked_.clear();
+
+  /// Grid positions in reach, clamped to the geometry
+  int64_t x_begin = std::max(x - max_coord_gap_, grid_x0_);
+  int64_t x_end = std::min(x + max_coord_gap_, grid_x1_);
+  int64_t z_begin = std::max(z - max_coord_gap_, grid_z0_);
+  int64_t z_end = std::min(z + max_coord_gap_, grid_z1_);
+  int64_t z_size = grid_z1_ - grid_z0_ + 1;
+  for (int64_t xi = x_begin; xi <= x_end; xi++) {
+    auto row = &grid_[size_t((xi - grid_x0_) * z_size)];
+    for (int64_t zi = z_begin; zi <= z_end; zi++) {
+      const auto &cell = row[zi - grid_z0_];
+      if (cell.epoch == epoch_ && in_reach(cell.time)) {
+        link(cell.cluster);
+      }
+    }
+  }
+
+  /// Hits outside of the geometry, expected to be rare
+  if (!outside_hits_.empty()) {
+    outside_hits_.erase(
+        std::remove_if(outside_hits_.begin(), outside_hits_.end(),
+                       [&in_reach](const OutsideHit &other) {
+                         return !in_reach(other.time);
+                       }),
+        outside_hits_.end());
+    for (const auto &other : outside_hits_) {
+      if (std::abs(other.x - x) <= max_coord_gap_ &&
+          std::abs(other.z - z) <= max_coord_gap_) {
+        link(other.cluster);
+      }
+    }
+  }
+
+  uint32_t root;
+  if (linked_.empty()) {
+    root = new_slot();
+  } else if (linked_.size() == 1) {
+    root = linked_.front();
+  } else {
+    root = merge_linked();
+  }
+  slots_[root].cluster.insert(hit);
+
+  if (on_grid) {
+    auto &cell = grid_[size_t((x - grid_x0_) * z_size + (z - grid_z0_))];
+    cell = {hit.time, root, epoch_};
+  } else {
+    outside_hits_.push_back({x, z, hit.time, root});
+  }
+  horizon_.emplace_back(hit.time, root);
+}
+
+void GapClusterer2D::flush_streaming() {
+  std::vector<std::pair<uint64_t, uint32_t>> open;
+  for (uint32_t slot = 0; slot < slots_.size(); slot++) {
+    if (slots_[slot].open) {
+      open.emplace_back(slots_[slot].cluster.time_end(), slot);
+    }
+  }
+  std::sort(open.begin(), open.end());
+  for (const auto &o : open) {
+    stash_open(o.second);
+  }
+
+  horizon_.clear();
+  outside_hits_.clear();
+
+  /// Invalidates all grid cells
+  if (++epoch_ == 0) {
+    grid_.assign(grid_.size(), GridCell());
+    epoch_ = 1;
+  }
+}
+
 std::string GapClusterer2D::config(const std::string &prepend) const {
   std::stringstream ss;
   ss << "GapClusterer2D:\n";
   ss << prepend << fmt::format("max_time_gap={}\n", max_time_gap_);
   ss << prepend << fmt::format("max_coord_gap={}\n", max_coord_gap_);
+  if (streaming_)
+    ss << prepend << "streaming\n";
   ss << prepend << geometry_.debug(prepend + "  ");
   return ss.str();
 }
@@ -120,6 +350,12 @@ std::string GapClusterer2D::status(const std::string &prepend, bool verbose) con
   if (!current_time_cluster_.empty())
     ss << prepend << "Current time cluster:\n"
        << to_string(current_time_cluster_, prepend + "  ") + "\n";
+  if (streaming_) {
+    size_t open{0};
+    for (const auto &slot : slots_)
+      open += slot.open;
+    ss << prepend << fmt::format("Open clusters: {}\n", open);
+  }
   return ss.str();
 }
 
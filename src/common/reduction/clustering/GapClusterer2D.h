@@ -10,6 +10,8 @@
 
 #include <common/reduction/clustering/AbstractClusterer.h>
 #include <multigrid/reduction/ModuleGeometry.h>
+#include <deque>
+#include <vector>
 
 // \todo update documentation for 2D version
 
@@ -19,6 +21,14 @@
 ///         chronologically sorted within supplied containers and between
 ///         subsequent instances thereof. Clustering is first performed in time,
 ///         and then in space.
+///
+///         In streaming mode (set_streaming()) hits are instead linked as they
+///         are inserted to open clusters with a hit no more than max_time_gap
+///         earlier and no more than max_coord_gap away in both x and z. Open
+///         clusters are looked up in a grid over the (x, z) positions of the
+///         geometry, and are stashed as soon as the time horizon has moved more
+///         than max_time_gap past their last hit. The cost per hit does not
+///         depend on how many hits are in flight.
 
 class GapClusterer2D : public AbstractClusterer {
 public:
@@ -35,6 +45,11 @@ public:
   /// \returns current ModuleGeometry definition
   Multigrid::ModuleGeometry geometry() const;
 
+  /// \brief selects the clustering mode, pending hits are flushed first
+  /// \param streaming if true, hits are clustered incrementally through the
+  ///        spatial grid, instead of sorting each time cluster in x and z
+  void set_streaming(bool streaming);
+
   /// \brief insert new hit and perform clustering
   /// \param hit to be added to cluster. Hits must be chronological between
   ///         subsequent calls. It may be more efficient to use:
@@ -70,6 +85,66 @@ private:
 
   void stash_cluster(HitVector& xz_cluster);
 
+  bool streaming_{false};
+
+  static constexpr uint32_t NoCluster{0xFFFFFFFF};
+
+  /// Latest hit at an (x, z) position and the open cluster it belongs to,
+  /// only valid in the flush epoch it was written in
+  struct GridCell {
+    uint64_t time{0};
+    uint32_t cluster{NoCluster};
+    uint32_t epoch{0};
+  };
+
+  /// Hit on a wire outside of the geometry, linked by comparison
+  struct OutsideHit {
+    int64_t x;
+    int64_t z;
+    uint64_t time;
+    uint32_t cluster;
+  };
+
+  /// Cluster slot, a merged slot points to the slot now holding its hits
+  struct OpenCluster {
+    Cluster cluster;
+    uint32_t parent{NoCluster};
+    bool open{false};
+    std::vector<uint32_t> merged; ///< slots merged into this one
+  };
+
+  bool grid_valid_{false};
+  std::vector<GridCell> grid_; ///< x major, z minor
+  std::vector<uint32_t> wire_x_; ///< x of wires inside the geometry
+  std::vector<uint32_t> wire_z_; ///< z of wires inside the geometry
+  int64_t grid_x0_{0}, grid_x1_{-1};
+  int64_t grid_z0_{0}, grid_z1_{-1};
+  uint32_t epoch_{1};
+
+  std::vector<OutsideHit> outside_hits_;
+  std::vector<OpenCluster> slots_;
+  std::vector<uint32_t> free_slots_;
+  std::deque<std::pair<uint64_t, uint32_t>> horizon_; ///< (hit time, cluster)
+  std::vector<uint32_t> linked_; ///< open clusters linked to the current hit
+
+  /// \brief adds hit to the open clusters in space-time reach, or opens one
+  void insert_streaming(const Hit &hit);
+
+  /// \brief stashes open clusters out of time reach of a hit at time
+  void close_streaming(uint64_t time);
+
+  /// \brief stashes all open clusters, in order of their last hit
+  void flush_streaming();
+
+  void stash_open(uint32_t slot);
+  void build_grid();
+  uint32_t find_slot(uint32_t slot);
+  uint32_t new_slot();
+  void link(uint32_t slot);
+
+  /// \brief merges the clusters in linked_ into the largest of them
+  uint32_t merge_linked();
+
   inline void sort_by_x(HitVector &hits) {
     std::sort(hits.begin(), hits.end(),
               [this](const Hit &hit1, const Hit &hit2) {
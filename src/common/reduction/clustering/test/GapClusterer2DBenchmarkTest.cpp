@@ -0,0 +1,55 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <benchmark/benchmark.h>
+#include <common/reduction/clustering/GapClusterer2D.h>
+#include <random>
+
+static constexpr uint64_t TimeGap{100};
+
+/// \brief events of 2 - 4 neighbouring wires at random positions, with on
+/// average occupancy events within a time gap of each other, in time order
+static HitVector make_hits(size_t occupancy, size_t events) {
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> event_gap(0, 2 * TimeGap / occupancy);
+  std::uniform_int_distribution<uint64_t> hit_time(0, TimeGap / 2);
+  std::uniform_int_distribution<uint16_t> x(0, 47);
+  std::uniform_int_distribution<uint16_t> z(0, 16);
+  std::uniform_int_distribution<uint16_t> wires(2, 4);
+  std::uniform_int_distribution<uint16_t> adc(50, 1000);
+  HitVector hits;
+  uint64_t time{1000000};
+  for (size_t e = 0; e < events; e++) {
+    time += event_gap(gen);
+    uint16_t first = x(gen) * 20 + z(gen);
+    for (uint16_t i = 0, n = wires(gen); i < n; i++) {
+      hits.push_back({time + hit_time(gen), uint16_t(first + i), adc(gen), 0});
+    }
+  }
+  std::stable_sort(hits.begin(), hits.end(),
+                   [](const Hit &a, const Hit &b) { return a.time < b.time; });
+  return hits;
+}
+
+/// \brief clustering 10000 events with state.range(0) events in flight
+static void Cluster2D(benchmark::State &state, bool streaming) {
+  auto hits = make_hits(state.range(0), 10000);
+  Multigrid::ModuleGeometry geometry;
+  geometry.num_wires(960);
+  geometry.z_range(20);
+
+  GapClusterer2D clusterer(TimeGap, 1);
+  clusterer.set_geometry(geometry);
+  clusterer.set_streaming(streaming);
+
+  for (auto _ : state) {
+    clusterer.cluster(hits);
+    clusterer.flush();
+    benchmark::DoNotOptimize(clusterer.clusters.size());
+    clusterer.clusters.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * hits.size());
+}
+BENCHMARK_CAPTURE(Cluster2D, batch, false)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_CAPTURE(Cluster2D, streaming, true)->RangeMultiplier(4)->Range(1, 64);
+
+BENCHMARK_MAIN();
@@ -3,6 +3,8 @@
 #include <common/reduction/clustering/GapClusterer2D.h>
 
 #include <test/TestBase.h>
+#include <random>
+#include <tuple>
 
 class GapClusterer2DTest : public TestBase {
 protected:
@@ -16,6 +18,18 @@ protected:
       for (e.coordinate = strip_start; e.coordinate <= strip_end; e.coordinate += strip_step)
         ret.push_back(e);
   }
+
+  using Signature = std::tuple<uint64_t, uint64_t, uint16_t, uint16_t, size_t, double>;
+
+  /// \brief cluster properties in an order independent of the clustering mode
+  std::vector<Signature> signatures(const ClusterContainer &clusters) {
+    std::vector<Signature> ret;
+    for (const auto &c : clusters)
+      ret.emplace_back(c.time_start(), c.time_end(), c.coord_start(),
+                       c.coord_end(), c.hit_count(), c.weight_sum());
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  }
 };
 
 TEST_F(GapClusterer2DTest, ZeroTimeGap) {
@@ -157,6 +171,153 @@ TEST_F(GapClusterer2DTest, PrintStatus) {
   MESSAGE() << "VERBOSE:\n" << gc.status("  ", true);
 }
 
+TEST_F(GapClusterer2DTest, StreamingSameAsBatch) {
+  struct Scenario {
+    uint16_t strip_start, strip_end, strip_step;
+    uint64_t time_start, time_end, time_step;
+    uint64_t max_time_gap;
+    uint16_t max_coord_gap;
+  };
+  // the scenarios of the tests above
+  std::vector<Scenario> scenarios{{0, 0, 1, 1, 10, 1, 0, 0},
+                                  {0, 0, 1, 0, 40, 4, 5, 0},
+                                  {0, 0, 1, 0, 50, 5, 5, 0},
+                                  {0, 0, 1, 1, 60, 6, 5, 0},
+                                  {1, 10, 1, 1, 10, 1, 0, 0},
+                                  {1, 40, 4, 1, 10, 1, 0, 5},
+                                  {1, 50, 5, 1, 10, 1, 0, 5}};
+
+  for (const auto &s : scenarios) {
+    HitVector hc;
+    mock_cluster(hc, s.strip_start, s.strip_end, s.strip_step,
+                 s.time_start, s.time_end, s.time_step);
+
+    GapClusterer2D batch(s.max_time_gap, s.max_coord_gap);
+    GapClusterer2D streaming(s.max_time_gap, s.max_coord_gap);
+    streaming.set_streaming(true);
+    batch.cluster(hc);
+    streaming.cluster(hc);
+    EXPECT_EQ(streaming.stats_cluster_count, batch.stats_cluster_count);
+
+    batch.flush();
+    streaming.flush();
+    EXPECT_EQ(streaming.stats_cluster_count, batch.stats_cluster_count);
+    EXPECT_EQ(signatures(streaming.clusters), signatures(batch.clusters));
+  }
+}
+
+TEST_F(GapClusterer2DTest, StreamingSeparatedBlobs) {
+  Multigrid::ModuleGeometry geometry;
+  geometry.num_wires(960);
+  geometry.z_range(20);
+
+  // frames of blobs of up to 2x2 wires at distinct sites 4 wires apart,
+  // frames are further apart in time than the time gap
+  std::default_random_engine gen;
+  std::uniform_int_distribution<size_t> blobs(1, 40);
+  std::uniform_int_distribution<uint16_t> site(0, 59);
+  std::uniform_int_distribution<uint16_t> hits(1, 4);
+  std::uniform_int_distribution<uint16_t> offset(0, 1);
+  std::uniform_int_distribution<uint64_t> dt(0, 100);
+  std::uniform_int_distribution<uint16_t> weight(1, 1000);
+  HitVector hc;
+  uint64_t time{1000};
+  for (size_t frame = 0; frame < 200; frame++) {
+    std::vector<bool> taken(60, false);
+    HitVector frame_hits;
+    for (size_t b = 0, n = blobs(gen); b < n; b++) {
+      auto s = site(gen);
+      if (taken[s])
+        continue;
+      taken[s] = true;
+      for (uint16_t h = 0, count = hits(gen); h < count; h++) {
+        uint16_t x = (s / 5) * 4 + offset(gen);
+        uint16_t z = (s % 5) * 4 + offset(gen);
+        frame_hits.push_back({time + dt(gen), uint16_t(x * 20 + z), weight(gen), 0});
+      }
+    }
+    std::stable_sort(frame_hits.begin(), frame_hits.end(),
+                     [](const Hit &a, const Hit &b) { return a.time < b.time; });
+    hc.insert(hc.end(), frame_hits.begin(), frame_hits.end());
+    time += 300;
+  }
+
+  GapClusterer2D batch(100, 1);
+  batch.set_geometry(geometry);
+  GapClusterer2D streaming(100, 1);
+  streaming.set_geometry(geometry);
+  streaming.set_streaming(true);
+
+  for (size_t begin = 0; begin < hc.size(); begin += 1000) {
+    HitVector chunk;
+    chunk.insert(chunk.end(), hc.begin() + begin,
+                 hc.begin() + std::min(begin + 1000, hc.size()));
+    batch.cluster(chunk);
+    streaming.cluster(chunk);
+    EXPECT_EQ(streaming.stats_cluster_count, batch.stats_cluster_count);
+  }
+  batch.flush();
+  streaming.flush();
+
+  ASSERT_GT(batch.clusters.size(), 1000);
+  EXPECT_EQ(signatures(streaming.clusters), signatures(batch.clusters));
+}
+
+TEST_F(GapClusterer2DTest, StreamingDiffersFromBatch) {
+  // default geometry, wire = 20 * x + z
+  HitVector hc;
+  hc.push_back({10, 0, 1, 0});  // x 0, z 0
+  hc.push_back({10, 23, 1, 0}); // x 1, z 3
+  hc.push_back({10, 41, 1, 0}); // x 2, z 1
+
+  // batch clusters x and z one after the other, the first and last hits are
+  // neighbours in z within the cluster of neighbouring x
+  GapClusterer2D batch(5, 1);
+  batch.cluster(hc);
+  batch.flush();
+  ASSERT_EQ(batch.clusters.size(), 2);
+
+  // streaming requires neighbours in x and z, no hits are linked
+  GapClusterer2D streaming(5, 1);
+  streaming.set_streaming(true);
+  streaming.cluster(hc);
+  streaming.flush();
+  ASSERT_EQ(streaming.clusters.size(), 3);
+}
+
+TEST_F(GapClusterer2DTest, StreamingOutsideGeometry) {
+  // default geometry has 80 wires, wire 85 is next to wire 65 in x
+  HitVector hc;
+  hc.push_back({10, 65, 1, 0});
+  hc.push_back({11, 85, 1, 0});
+  hc.push_back({12, 89, 1, 0});
+  hc.push_back({12, 200, 1, 0});
+
+  for (bool streaming : {false, true}) {
+    GapClusterer2D gc(5, 1);
+    gc.set_streaming(streaming);
+    gc.cluster(hc);
+    gc.flush();
+    ASSERT_EQ(gc.clusters.size(), 3);
+  }
+}
+
+TEST_F(GapClusterer2DTest, StreamingFlushesOnModeChange) {
+  HitVector hc;
+  mock_cluster(hc, 1, 3, 1, 1, 3, 1);
+
+  GapClusterer2D gc(5, 1);
+  gc.cluster(hc);
+  EXPECT_EQ(gc.clusters.size(), 0);
+  gc.set_streaming(true);
+  EXPECT_EQ(gc.clusters.size(), 1);
+
+  gc.cluster(hc);
+  EXPECT_EQ(gc.clusters.size(), 1);
+  MESSAGE() << "STREAMING:\n" << gc.status("  ", false);
+  gc.set_streaming(false);
+  EXPECT_EQ(gc.clusters.size(), 2);
+}
 
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -3,6 +3,7 @@
 #include <common/reduction/clustering/GapClusterer.h>
 
 #include <test/TestBase.h>
+#include <random>
 
 class GapClustererTest : public TestBase {
 protected:
@@ -138,6 +139,37 @@ TEST_F(GapClustererTest, JustOverFiveCoordGap) {
   EXPECT_EQ(gc.clusters.size(), 100);
 }
 
+TEST_F(GapClustererTest, RadixSortSameClusters) {
+  HitVector hc;
+  // 800 hits in one time cluster, strips 0-18 and 30-49 (gap at 19-29)
+  mock_cluster(hc, 0, 49, 1, 0, 15, 1);
+  HitVector hc_gap;
+  for (auto &hit : hc)
+    if ((hit.coordinate < 19) || (hit.coordinate > 29))
+      hc_gap.push_back(hit);
+
+  GapClusterer gc_std(1, 5);
+  gc_std.cluster(hc_gap);
+  gc_std.flush();
+
+  GapClusterer gc_radix(1, 5);
+  gc_radix.set_sort_method(HitSort::Radix);
+  gc_radix.cluster(hc_gap);
+  gc_radix.flush();
+
+  ASSERT_EQ(gc_std.clusters.size(), 2);
+  ASSERT_EQ(gc_radix.clusters.size(), 2);
+  auto c_std = gc_std.clusters.begin();
+  auto c_radix = gc_radix.clusters.begin();
+  for (; c_std != gc_std.clusters.end(); ++c_std, ++c_radix) {
+    EXPECT_EQ(c_std->hit_count(), c_radix->hit_count());
+    EXPECT_EQ(c_std->coord_start(), c_radix->coord_start());
+    EXPECT_EQ(c_std->coord_end(), c_radix->coord_end());
+    EXPECT_EQ(c_std->time_start(), c_radix->time_start());
+    EXPECT_EQ(c_std->weight_sum(), c_radix->weight_sum());
+  }
+}
+
 TEST_F(GapClustererTest, PrintConfig) {
   GapClusterer gc(0, 5);
 
@@ -158,6 +190,118 @@ TEST_F(GapClustererTest, PrintStatus) {
 }
 
 
+TEST_F(GapClustererTest, ColumnsSameClusters) {
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> dt(0, 3);
+  std::uniform_int_distribution<uint16_t> coord(0, 1279);
+  std::uniform_int_distribution<uint16_t> weight(1, 1000);
+  HitVector hits;
+  uint64_t time{1ULL << 40};
+  for (size_t i = 0; i < 5000; ++i) {
+    time += dt(gen) * dt(gen) * dt(gen);
+    hits.push_back({time, coord(gen), weight(gen), 0});
+  }
+
+  for (auto method : {HitSort::StdSort, HitSort::Radix}) {
+    GapClusterer gc_aos(5, 2);
+    gc_aos.set_sort_method(method);
+    GapClusterer gc_soa(5, 2);
+    gc_soa.set_sort_method(method);
+
+    // chunks, with a time cluster open across the chunk boundaries
+    for (size_t begin = 0; begin < hits.size(); begin += 1000) {
+      HitVector chunk;
+      HitColumns columns;
+      for (size_t i = begin; i < begin + 1000; ++i) {
+        chunk.push_back(hits[i]);
+        columns.push_back(hits[i]);
+      }
+      gc_aos.cluster(chunk);
+      gc_soa.cluster(columns);
+      EXPECT_EQ(gc_aos.stats_cluster_count, gc_soa.stats_cluster_count);
+    }
+    gc_aos.flush();
+    gc_soa.flush();
+
+    ASSERT_GT(gc_aos.clusters.size(), 100);
+    ASSERT_EQ(gc_aos.clusters.size(), gc_soa.clusters.size());
+    auto c_soa = gc_soa.clusters.begin();
+    for (const auto &c_aos : gc_aos.clusters) {
+      EXPECT_EQ(c_aos.hit_count(), c_soa->hit_count());
+      EXPECT_EQ(c_aos.time_start(), c_soa->time_start());
+      EXPECT_EQ(c_aos.time_end(), c_soa->time_end());
+      EXPECT_EQ(c_aos.coord_start(), c_soa->coord_start());
+      EXPECT_EQ(c_aos.coord_end(), c_soa->coord_end());
+      EXPECT_EQ(c_aos.weight_sum(), c_soa->weight_sum());
+      EXPECT_EQ(c_aos.coord_mass(), c_soa->coord_mass());
+      EXPECT_DOUBLE_EQ(c_aos.time_mass(), c_soa->time_mass());
+      ++c_soa;
+    }
+  }
+}
+
+TEST_F(GapClustererTest, ColumnsAndHitsMixed) {
+  HitVector hc;
+  mock_cluster(hc, 0, 5, 1, 0, 10, 1);
+  mock_cluster(hc, 0, 5, 1, 100, 110, 1);
+
+  GapClusterer gc(5, 1);
+  HitColumns first;
+  for (size_t i = 0; i < hc.size() / 4; ++i)
+    first.push_back(hc[i]);
+  gc.cluster(first);
+  for (size_t i = hc.size() / 4; i < hc.size() / 2 + 3; ++i)
+    gc.insert(hc[i]);
+  HitColumns second;
+  for (size_t i = hc.size() / 2 + 3; i < hc.size(); ++i)
+    second.push_back(hc[i]);
+  gc.cluster(second);
+  gc.flush();
+
+  ASSERT_EQ(gc.clusters.size(), 2);
+  EXPECT_EQ(gc.clusters.front().hit_count(), hc.size() / 2);
+  EXPECT_EQ(gc.clusters.back().hit_count(), hc.size() / 2);
+}
+
+TEST_F(GapClustererTest, ArenaSameClusters) {
+  HitVector hc;
+  mock_cluster(hc, 0, 49, 3, 0, 200, 20);
+  mock_cluster(hc, 0, 49, 1, 1000, 1015, 1);
+
+  GapClusterer gc_pool(1, 2);
+  gc_pool.cluster(hc);
+  gc_pool.flush();
+
+  Arena Memory;
+  {
+    GapClusterer gc_arena(1, 2);
+    {
+      ArenaScope Scope(&Memory);
+      gc_arena.cluster(hc);
+      gc_arena.flush();
+    }
+    ASSERT_GT(Memory.Stats.AllocCount, 0);
+
+    ASSERT_EQ(gc_pool.clusters.size(), gc_arena.clusters.size());
+    auto c_arena = gc_arena.clusters.begin();
+    for (const auto &c_pool : gc_pool.clusters) {
+      EXPECT_TRUE(Arena::contains(c_arena->hits.data()));
+      EXPECT_EQ(c_pool.hit_count(), c_arena->hit_count());
+      EXPECT_EQ(c_pool.time_start(), c_arena->time_start());
+      EXPECT_EQ(c_pool.coord_start(), c_arena->coord_start());
+      EXPECT_EQ(c_pool.coord_end(), c_arena->coord_end());
+      EXPECT_EQ(c_pool.weight_sum(), c_arena->weight_sum());
+      ++c_arena;
+    }
+  }
+
+  // everything released, all memory can be reused
+  Memory.recycle();
+  EXPECT_EQ(Memory.Stats.UsedBytes, 0);
+  EXPECT_EQ(Memory.Stats.Chunks, 1);
+  EXPECT_GT(Memory.Stats.HighWaterBytes, 0);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
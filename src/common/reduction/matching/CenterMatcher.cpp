@@ -16,27 +16,136 @@ void CenterMatcher::set_max_delta_time(uint64_t max_delta_time) {
   max_delta_time_ = max_delta_time;
 }
 
-void CenterMatcher::set_time_algorithm(std::string time_algorithm) {
-  time_algorithm_ = time_algorithm;
-}
+template <>
+struct CenterMatcher::TimeKey<CenterMatcher::TimeAlgorithm::CenterOfMass> {
+  static double time(const Cluster &cluster) { return cluster.time_center(); }
+};
 
-void CenterMatcher::match(bool flush) {
+template <>
+struct CenterMatcher::TimeKey<CenterMatcher::TimeAlgorithm::Charge2> {
+  static double time(const Cluster &cluster) { return cluster.time_center2(); }
+};
+
+template <>
+struct CenterMatcher::TimeKey<CenterMatcher::TimeAlgorithm::UTPC> {
+  static uint64_t time(const Cluster &cluster) { return cluster.time_end(); }
+};
+
+template <>
+struct CenterMatcher::TimeKey<CenterMatcher::TimeAlgorithm::UTPCWeighted>
+    : CenterMatcher::TimeKey<CenterMatcher::TimeAlgorithm::UTPC> {};
+
+template <CenterMatcher::TimeAlgorithm Algorithm>
+struct CenterMatcher::TimeKeyOrder {
+  bool operator()(const Cluster &c1, const Cluster &c2) const {
+    return TimeKey<Algorithm>::time(c1) < TimeKey<Algorithm>::time(c2);
+  }
+};
+
+bool CenterMatcher::TimeOrder::operator()(const Cluster &c1,
+                                          const Cluster &c2) const {
+  switch (algorithm) {
+  case TimeAlgorithm::CenterOfMass:
+    return TimeKey<TimeAlgorithm::CenterOfMass>::time(c1) <
+           TimeKey<TimeAlgorithm::CenterOfMass>::time(c2);
+  case TimeAlgorithm::Charge2:
+    return TimeKey<TimeAlgorithm::Charge2>::time(c1) <
+           TimeKey<TimeAlgorithm::Charge2>::time(c2);
+  case TimeAlgorithm::UTPC:
+  case TimeAlgorithm::UTPCWeighted:
+    break;
+  }
+  return TimeKey<TimeAlgorithm::UTPC>::time(c1) <
+         TimeKey<TimeAlgorithm::UTPC>::time(c2);
+}
 
+void CenterMatcher::set_time_algorithm(std::string time_algorithm) {
+  time_algorithm_ = time_algorithm;
   if (time_algorithm_ == "center-of-mass") {
-    unmatched_clusters_.sort([](const Cluster &c1, const Cluster &c2) {
-      return c1.time_center() < c2.time_center();
-    });
+    algorithm_ = TimeAlgorithm::CenterOfMass;
   } else if (time_algorithm_ == "charge2") {
-    unmatched_clusters_.sort([](const Cluster &c1, const Cluster &c2) {
-      return c1.time_center2() < c2.time_center2();
-    });
+    algorithm_ = TimeAlgorithm::Charge2;
+  } else if (time_algorithm_ == "utpc") {
+    algorithm_ = TimeAlgorithm::UTPC;
   }
-  // time_algorithm_ == "utpc" or time_algorithm_ == "utpc-weighted"
+  // time_algorithm_ == "utpc-weighted" and anything else matches by end time
   else {
-    unmatched_clusters_.sort([](const Cluster &c1, const Cluster &c2) {
-      return c1.time_end() < c2.time_end();
-    });
+    algorithm_ = TimeAlgorithm::UTPCWeighted;
+  }
+  order_.algorithm = algorithm_;
+  ordered_clusters_.set_order(order_);
+}
+
+void CenterMatcher::set_ordered_queue(bool ordered) {
+  if (ordered_ && !ordered) {
+    ordered_clusters_.release(unmatched_clusters_);
+  }
+  ordered_ = ordered;
+}
+
+void CenterMatcher::add_to_event(Event &evt, Cluster &cluster) {
+  // if the event is complete in both planes, stash it
+  if (evt.both_planes()) {
+    XTRACE(CLUSTER, DEB, "stash complete plane1/2 event");
+    stash_event(evt);
+    evt.clear();
+  }
+  if (!evt.empty()) {
+    if (evt.time_gap(cluster) > max_delta_time_) {
+      XTRACE(CLUSTER, DEB, "time gap too large");
+      stash_event(evt);
+      evt.clear();
+    }
+    // Plane 1 has value 0
+    if (cluster.plane() == 0) {
+      if (!evt.ClusterA.empty()) {
+        XTRACE(CLUSTER, DEB, "stash plane 1 event");
+        stash_event(evt);
+        evt.clear();
+      }
+    }
+    // Plane 2 has value 1
+    else if (cluster.plane() == 1) {
+      if (!evt.ClusterB.empty()) {
+        XTRACE(CLUSTER, DEB, "stash plane 2 event");
+        stash_event(evt);
+        evt.clear();
+      }
+    }
+  }
+  // Add only to the cluster, if the plane is empty
+  evt.merge(cluster);
+}
+
+void CenterMatcher::match(bool flush) {
+  switch (algorithm_) {
+  case TimeAlgorithm::CenterOfMass:
+    match_with<TimeAlgorithm::CenterOfMass>(flush);
+    break;
+  case TimeAlgorithm::Charge2:
+    match_with<TimeAlgorithm::Charge2>(flush);
+    break;
+  case TimeAlgorithm::UTPC:
+    match_with<TimeAlgorithm::UTPC>(flush);
+    break;
+  case TimeAlgorithm::UTPCWeighted:
+    match_with<TimeAlgorithm::UTPCWeighted>(flush);
+    break;
+  }
+}
+
+template <CenterMatcher::TimeAlgorithm Algorithm>
+void CenterMatcher::match_with(bool flush) {
+  if (ordered_) {
+    match_ordered<Algorithm>(flush);
+  } else {
+    match_sorted<Algorithm>(flush);
   }
+}
+
+template <CenterMatcher::TimeAlgorithm Algorithm>
+void CenterMatcher::match_sorted(bool flush) {
+  unmatched_clusters_.sort(TimeKeyOrder<Algorithm>());
 
   XTRACE(CLUSTER, DEB, "match(): unmatched clusters %u",
          unmatched_clusters_.size());
@@ -52,37 +161,7 @@ void CenterMatcher::match(bool flush) {
       break;
     }
 
-    // if the event is complete in both planes, stash it
-    if (evt.both_planes()) {
-      XTRACE(CLUSTER, DEB, "stash complete plane1/2 event");
-      stash_event(evt);
-      evt.clear();
-    }
-    if (!evt.empty()) {
-      if (evt.time_gap(*cluster) > max_delta_time_) {
-        XTRACE(CLUSTER, DEB, "time gap too large");
-        stash_event(evt);
-        evt.clear();
-      }
-      // Plane 1 has value 0
-      if (cluster->plane() == 0) {
-        if (!evt.ClusterA.empty()) {
-          XTRACE(CLUSTER, DEB, "stash plane 1 event");
-          stash_event(evt);
-          evt.clear();
-        }
-      }
-      // Plane 2 has value 1
-      else if (cluster->plane() == 1) {
-        if (!evt.ClusterB.empty()) {
-          XTRACE(CLUSTER, DEB, "stash plane 2 event");
-          stash_event(evt);
-          evt.clear();
-        }
-      }
-    }
-    // Add only to the cluster, if the plane is empty
-    evt.merge(*cluster);
+    add_to_event(evt, *cluster);
     unmatched_clusters_.pop_front();
   }
 
@@ -101,10 +180,57 @@ void CenterMatcher::match(bool flush) {
   }
 }
 
+template <CenterMatcher::TimeAlgorithm Algorithm>
+void CenterMatcher::match_ordered(bool flush) {
+  ordered_clusters_.merge(unmatched_clusters_, TimeKeyOrder<Algorithm>());
+
+  XTRACE(CLUSTER, DEB, "match(): unmatched clusters %u",
+         ordered_clusters_.size());
+
+  Event evt{PlaneA, PlaneB};
+
+  while (!ordered_clusters_.empty()) {
+
+    auto &cluster = ordered_clusters_.front();
+
+    if (!flush && !ready_to_be_matched(cluster)) {
+      XTRACE(CLUSTER, DEB, "not ready to be matched");
+      break;
+    }
+
+    add_to_event(evt, cluster);
+    ordered_clusters_.pop_front();
+  }
+
+  if (!evt.empty()) {
+    if (flush) {
+      stash_event(evt);
+    } else {
+      if (!evt.ClusterA.empty())
+        ordered_clusters_.requeue(std::move(evt.ClusterA),
+                                  TimeKeyOrder<Algorithm>());
+      if (!evt.ClusterB.empty())
+        ordered_clusters_.requeue(std::move(evt.ClusterB),
+                                  TimeKeyOrder<Algorithm>());
+    }
+  }
+}
+
 std::string CenterMatcher::config(const std::string &prepend) const {
   std::stringstream ss;
   ss << AbstractMatcher::config(prepend);
   ss << prepend << fmt::format("time_algorithm: {}\n", time_algorithm_);
   ss << prepend << fmt::format("max_delta_time: {}\n", max_delta_time_);
+  ss << prepend << fmt::format("ordered_queue: {}\n", ordered_);
+  return ss.str();
+}
+
+std::string CenterMatcher::status(const std::string &prepend, bool verbose) const {
+  std::stringstream ss;
+  ss << AbstractMatcher::status(prepend, verbose);
+  if (ordered_) {
+    ss << prepend << "Ordered unmatched clusters:\n"
+       << ordered_clusters_.to_string(prepend + "  ", verbose);
+  }
   return ss.str();
 }
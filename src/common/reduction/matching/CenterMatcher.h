@@ -9,6 +9,7 @@
 #pragma once
 
 #include <common/reduction/matching/AbstractMatcher.h>
+#include <common/reduction/matching/OrderedClusterQueue.h>
 
 /// \class CenterMatcher CenterMatcher.h
 /// \brief Matcher implementation that joins clusters into events
@@ -18,7 +19,10 @@ class CenterMatcher : public AbstractMatcher {
 public:
   /// Inherit constructor
   using AbstractMatcher::AbstractMatcher;
-  
+
+  /// \brief time algorithms, selected by name in set_time_algorithm()
+  enum class TimeAlgorithm { CenterOfMass, Charge2, UTPC, UTPCWeighted };
+
   /// \brief sets the maximum time gap criterion
   /// \param maximum_time_gap maximum time gap between clusters in different planes
   void set_max_delta_time(uint64_t max_delta_time);
@@ -26,7 +30,13 @@ public:
    /// \brief sets the time algorithm
   /// \param time_algorithm (center-of-mass, charge2, utpc, utpc-weighted)
   void set_time_algorithm(std::string time_algorithm);
-  
+
+  /// \brief selects how unmatched clusters are queued
+  /// \param ordered if true, clusters are merged into a queue ordered by
+  ///         the time algorithm instead of sorting the list of unmatched
+  ///         clusters in every match(). Matched events are the same in both cases.
+  void set_ordered_queue(bool ordered);
+
   
   /// \brief CenterMatcher constructor
   /// \sa AbstractMatcher
@@ -41,13 +51,45 @@ public:
 
   /// \brief print configuration of CenterMatcher
   std::string config(const std::string& prepend) const override;
-  
+
+  /// \brief print current status of CenterMatcher
+  std::string status(const std::string &prepend, bool verbose) const override;
+
 private:
   uint64_t max_delta_time_{0};
 
   //Algorithm for time calculation, either center-of-mass, charge2, or utpc
   std::string time_algorithm_{"center-of-mass"};
+  TimeAlgorithm algorithm_{TimeAlgorithm::CenterOfMass};
 
-  
+  /// \brief cluster time used for matching by a time algorithm
+  template <TimeAlgorithm Algorithm> struct TimeKey;
+
+  /// \brief cluster order of a time algorithm, used on the match() paths
+  template <TimeAlgorithm Algorithm> struct TimeKeyOrder;
+
+  /// Cluster order used for matching, follows the time algorithm. Selects
+  /// the algorithm per comparison, so only used when reordering the queue
+  struct TimeOrder {
+    TimeAlgorithm algorithm{TimeAlgorithm::CenterOfMass};
+    bool operator()(const Cluster &c1, const Cluster &c2) const;
+  };
+
+  TimeOrder order_;
+  bool ordered_{false};
+  OrderedClusterQueue<TimeOrder> ordered_clusters_;
+
+  /// \brief match() specialized for each time algorithm so that sorting
+  ///        and queue insertion do not dispatch per pair of clusters
+  template <TimeAlgorithm Algorithm> void match_with(bool flush);
+
+  /// \brief match() on the list of unmatched clusters
+  template <TimeAlgorithm Algorithm> void match_sorted(bool flush);
+
+  /// \brief match() on the ordered queue
+  template <TimeAlgorithm Algorithm> void match_ordered(bool flush);
+
+  /// \brief matches one cluster, stashing the event if complete
+  void add_to_event(Event &evt, Cluster &cluster);
 };
 
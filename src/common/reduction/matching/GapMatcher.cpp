@@ -18,7 +18,19 @@ void GapMatcher::set_minimum_time_gap(uint64_t minimum_time_gap) {
   minimum_time_gap_ = minimum_time_gap;
 }
 
+void GapMatcher::set_ordered_queue(bool ordered) {
+  if (ordered_ && !ordered) {
+    ordered_clusters_.release(unmatched_clusters_);
+  }
+  ordered_ = ordered;
+}
+
 void GapMatcher::match(bool flush) {
+  if (ordered_) {
+    match_ordered(flush);
+    return;
+  }
+
   unmatched_clusters_.sort([](const Cluster &c1, const Cluster &c2) {
     return c1.time_start() < c2.time_start();
   });
@@ -56,10 +68,60 @@ void GapMatcher::match(bool flush) {
   }
 }
 
+void GapMatcher::match_ordered(bool flush) {
+  ordered_clusters_.merge(unmatched_clusters_);
+
+  XTRACE(CLUSTER, DEB, "match(): unmatched clusters %u", ordered_clusters_.size());
+
+  Event evt{PlaneA, PlaneB};
+  while (!ordered_clusters_.empty()) {
+
+    auto &cluster = ordered_clusters_.front();
+
+    if (!flush && !ready_to_be_matched(cluster)) {
+      XTRACE(CLUSTER, DEB, "not ready to be matched");
+      break;
+    }
+
+    if (!evt.empty() && (evt.time_gap(cluster) > minimum_time_gap_)) {
+      XTRACE(CLUSTER, DEB, "time gap too large");
+      stash_event(evt);
+      evt.clear();
+    }
+
+    evt.merge(cluster);
+
+    ordered_clusters_.pop_front();
+  }
+
+  /// If anything remains
+  if (!evt.empty()) {
+    if (flush) {
+      stash_event(evt);
+    } else {
+      if (!evt.ClusterA.empty())
+        ordered_clusters_.requeue(std::move(evt.ClusterA));
+      if (!evt.ClusterB.empty())
+        ordered_clusters_.requeue(std::move(evt.ClusterB));
+    }
+  }
+}
+
 std::string GapMatcher::config(const std::string& prepend) const {
   std::stringstream ss;
   ss << AbstractMatcher::config(prepend);
   ss << prepend << fmt::format("minimum_time_gap: {}\n", minimum_time_gap_);
+  ss << prepend << fmt::format("ordered_queue: {}\n", ordered_);
+  return ss.str();
+}
+
+std::string GapMatcher::status(const std::string &prepend, bool verbose) const {
+  std::stringstream ss;
+  ss << AbstractMatcher::status(prepend, verbose);
+  if (ordered_) {
+    ss << prepend << "Ordered unmatched clusters:\n"
+       << ordered_clusters_.to_string(prepend + "  ", verbose);
+  }
   return ss.str();
 }
 
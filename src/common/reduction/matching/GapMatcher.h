@@ -9,6 +9,7 @@
 #pragma once
 
 #include <common/reduction/matching/AbstractMatcher.h>
+#include <common/reduction/matching/OrderedClusterQueue.h>
 
 /// \class GapMatcher GapMatcher.h
 /// \brief Matcher implementation that joins clusters into events
@@ -24,7 +25,13 @@ public:
   ///         to be disambiguated into separate events. If time gap is smaller,
   ///         the clusters are merged into one event.
   void set_minimum_time_gap(uint64_t minimum_time_gap);
-  
+
+  /// \brief selects how unmatched clusters are queued
+  /// \param ordered if true, clusters are merged into a time ordered queue
+  ///         instead of sorting the list of unmatched clusters in every
+  ///         match(). Matched events are the same in both cases.
+  void set_ordered_queue(bool ordered);
+
   /// \brief Match queued up clusters into events.
   ///         Clusters that either overlap in time or have time gaps that are smaller than
   ///         the minimum time gap are joined into events.
@@ -35,6 +42,21 @@ public:
   /// \brief print configuration of GapMatcher
   std::string config(const std::string& prepend) const override;
 
+  /// \brief print current status of GapMatcher
+  std::string status(const std::string &prepend, bool verbose) const override;
+
 private:
   uint64_t minimum_time_gap_{0};
+
+  struct StartTimeOrder {
+    bool operator()(const Cluster &c1, const Cluster &c2) const {
+      return c1.time_start() < c2.time_start();
+    }
+  };
+
+  bool ordered_{false};
+  OrderedClusterQueue<StartTimeOrder> ordered_clusters_;
+
+  /// \brief match() on the ordered queue
+  void match_ordered(bool flush);
 };
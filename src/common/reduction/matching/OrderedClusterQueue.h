@@ -0,0 +1,90 @@
+/* Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file OrderedClusterQueue.h
+/// \brief OrderedClusterQueue class definition and implementation
+///
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <common/reduction/clustering/AbstractClusterer.h>
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <string>
+
+/// \class OrderedClusterQueue OrderedClusterQueue.h
+/// \brief Queue of unmatched clusters which is kept ordered at all times.
+///         Clusters are merged in by insertion, which for (nearly) chronological
+///         input is an append, so the queue never needs to be sorted as a whole.
+///         The resulting order is the same as appending to a std::list and
+///         calling its (stable) sort().
+/// \tparam Order strict weak ordering of clusters, bool(const Cluster&, const Cluster&)
+
+template <typename Order>
+class OrderedClusterQueue {
+public:
+  explicit OrderedClusterQueue(Order order = Order()) : order_(order) {}
+
+  /// \brief changes the ordering and reorders queued clusters
+  void set_order(Order order) {
+    order_ = order;
+    std::stable_sort(clusters_.begin(), clusters_.end(), order_);
+  }
+
+  /// \brief moves clusters into the queue, after queued clusters of equal order
+  /// \post container is empty
+  void merge(ClusterContainer &clusters) { merge(clusters, order_); }
+
+  /// \brief as merge(), comparing with order which must give the same
+  ///         ordering as the queue's Order (e.g. one that is cheaper to call)
+  template <typename CompatibleOrder>
+  void merge(ClusterContainer &clusters, CompatibleOrder order) {
+    for (auto &cluster : clusters) {
+      if (clusters_.empty() || !order(cluster, clusters_.back())) {
+        clusters_.emplace_back(std::move(cluster));
+      } else {
+        auto it = std::upper_bound(clusters_.begin(), clusters_.end(), cluster, order);
+        clusters_.emplace(it, std::move(cluster));
+      }
+    }
+    clusters.clear();
+  }
+
+  /// \brief puts a cluster back, before queued clusters of equal order
+  void requeue(Cluster &&cluster) { requeue(std::move(cluster), order_); }
+
+  /// \brief as requeue(), comparing with a CompatibleOrder, see merge()
+  template <typename CompatibleOrder>
+  void requeue(Cluster &&cluster, CompatibleOrder order) {
+    auto it = std::lower_bound(clusters_.begin(), clusters_.end(), cluster, order);
+    clusters_.emplace(it, std::move(cluster));
+  }
+
+  /// \brief moves all queued clusters to the back of a container
+  void release(ClusterContainer &clusters) {
+    for (auto &cluster : clusters_) {
+      clusters.emplace_back(std::move(cluster));
+    }
+    clusters_.clear();
+  }
+
+  bool empty() const { return clusters_.empty(); }
+  size_t size() const { return clusters_.size(); }
+  Cluster &front() { return clusters_.front(); }
+  void pop_front() { clusters_.pop_front(); }
+
+  /// \brief convenience function for printing queued clusters
+  std::string to_string(const std::string &prepend, bool verbose) const {
+    std::stringstream ss;
+    for (const auto &cluster : clusters_) {
+      ss << prepend << cluster.to_string(prepend, verbose) << "\n";
+    }
+    return ss.str();
+  }
+
+private:
+  Order order_;
+  std::deque<Cluster> clusters_;
+};
@@ -0,0 +1,56 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <benchmark/benchmark.h>
+#include <common/reduction/matching/CenterMatcher.h>
+#include <random>
+
+/// \brief chronological clusters of 1 - 4 hits with random gaps, per plane
+static ClusterContainer make_clusters(uint8_t plane, size_t count) {
+  std::default_random_engine gen(plane);
+  std::uniform_int_distribution<uint64_t> gap(0, 400);
+  std::uniform_int_distribution<uint16_t> hits(1, 4);
+  ClusterContainer clusters;
+  uint64_t time{0};
+  for (size_t i = 0; i < count; ++i) {
+    Cluster cluster;
+    time += gap(gen);
+    for (uint16_t h = 0, n = hits(gen); h < n; ++h) {
+      cluster.insert({time + gap(gen) / 4, h, uint16_t(1 + gap(gen)), plane});
+    }
+    clusters.push_back(cluster);
+  }
+  return clusters;
+}
+
+/// \brief matching state.range(0) clusters per plane
+static void Match(benchmark::State &state, std::string algorithm) {
+  const auto clusters_a = make_clusters(0, state.range(0));
+  const auto clusters_b = make_clusters(1, state.range(0));
+  CenterMatcher matcher(1000, 0, 1);
+  matcher.set_max_delta_time(100);
+  matcher.set_time_algorithm(algorithm);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ClusterContainer a(clusters_a);
+    ClusterContainer b(clusters_b);
+    matcher.matched_events.clear();
+    matcher.insert(0, a);
+    matcher.insert(1, b);
+    state.ResumeTiming();
+
+    matcher.match(true);
+    benchmark::DoNotOptimize(matcher.matched_events.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK_CAPTURE(Match, center_of_mass, std::string("center-of-mass"))
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(Match, charge2, std::string("charge2"))
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(Match, utpc, std::string("utpc"))
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(Match, utpc_weighted, std::string("utpc-weighted"))
+    ->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -3,6 +3,53 @@
 #include <common/reduction/matching/CenterMatcher.h>
 #include <common/reduction/matching/EndMatcher.h>
 #include <test/TestBase.h>
+#include <random>
+
+/// \brief random clusters in planes 0 and 1 with random gaps, inserted in
+/// chunks of chronological clusters per plane, matched after each chunk
+template <typename Matcher>
+static void feed_random_clusters(Matcher &matcher, unsigned int seed) {
+  std::default_random_engine gen(seed);
+  std::uniform_int_distribution<uint64_t> gap(0, 400);
+  std::uniform_int_distribution<uint16_t> hits(1, 4);
+  uint64_t time[2] {0, 0};
+  for (int chunk = 0; chunk < 200; ++chunk) {
+    for (uint8_t plane = 0; plane < 2; ++plane) {
+      ClusterContainer clusters;
+      for (int i = 0; i < 5; ++i) {
+        Cluster cluster;
+        time[plane] += gap(gen);
+        for (uint16_t h = 0, n = hits(gen); h < n; ++h) {
+          Hit hit;
+          hit.plane = plane;
+          hit.time = time[plane] + gap(gen) / 4;
+          hit.coordinate = h;
+          hit.weight = 1 + gap(gen);
+          cluster.insert(hit);
+        }
+        clusters.push_back(cluster);
+      }
+      matcher.insert(plane, clusters);
+    }
+    matcher.match(false);
+  }
+  matcher.match(true);
+}
+
+/// \brief matchers produce the same events
+static void expect_same_events(const AbstractMatcher &m1, const AbstractMatcher &m2) {
+  ASSERT_EQ(m1.matched_events.size(), m2.matched_events.size());
+  for (size_t i = 0; i < m1.matched_events.size(); ++i) {
+    const auto &e1 = m1.matched_events[i];
+    const auto &e2 = m2.matched_events[i];
+    EXPECT_EQ(e1.ClusterA.hit_count(), e2.ClusterA.hit_count());
+    EXPECT_EQ(e1.ClusterB.hit_count(), e2.ClusterB.hit_count());
+    EXPECT_EQ(e1.ClusterA.weight_sum(), e2.ClusterA.weight_sum());
+    EXPECT_EQ(e1.ClusterB.weight_sum(), e2.ClusterB.weight_sum());
+    EXPECT_EQ(e1.time_start(), e2.time_start());
+    EXPECT_EQ(e1.time_end(), e2.time_end());
+  }
+}
 
 class CenterMatcherTest : public TestBase {
 protected:
@@ -300,6 +347,57 @@ TEST_F(CenterMatcherTest, Y_X_X_Y) {
   
 // \todo do more tests
 
+TEST_F(CenterMatcherTest, OrderedQueueSameEvents) {
+  for (auto algorithm : {"center-of-mass", "charge2", "utpc", "utpc-weighted"}) {
+    CenterMatcher list_matcher(1000, 0, 1);
+    list_matcher.set_max_delta_time(100);
+    list_matcher.set_time_algorithm(algorithm);
+    CenterMatcher ordered_matcher(1000, 0, 1);
+    ordered_matcher.set_max_delta_time(100);
+    ordered_matcher.set_time_algorithm(algorithm);
+    ordered_matcher.set_ordered_queue(true);
+
+    feed_random_clusters(list_matcher, 1);
+    feed_random_clusters(ordered_matcher, 1);
+    ASSERT_GT(list_matcher.matched_events.size(), 500);
+    expect_same_events(list_matcher, ordered_matcher);
+  }
+}
+
+TEST_F(CenterMatcherTest, UtpcVariantsSameEvents) {
+  CenterMatcher utpc(1000, 0, 1);
+  utpc.set_max_delta_time(100);
+  utpc.set_time_algorithm("utpc");
+  feed_random_clusters(utpc, 1);
+  ASSERT_GT(utpc.matched_events.size(), 500);
+
+  for (auto algorithm : {"utpc-weighted", "utpc_weighted"}) {
+    CenterMatcher weighted(1000, 0, 1);
+    weighted.set_max_delta_time(100);
+    weighted.set_time_algorithm(algorithm);
+    feed_random_clusters(weighted, 1);
+    expect_same_events(utpc, weighted);
+  }
+}
+
+TEST_F(CenterMatcherTest, TimeAlgorithmChangesOrder) {
+  CenterMatcher center(1000, 0, 1);
+  center.set_max_delta_time(100);
+  feed_random_clusters(center, 1);
+  CenterMatcher end(1000, 0, 1);
+  end.set_max_delta_time(100);
+  end.set_time_algorithm("utpc");
+  feed_random_clusters(end, 1);
+
+  size_t different{0};
+  for (size_t i = 0; i < std::min(center.matched_events.size(),
+                                  end.matched_events.size()); ++i) {
+    if (center.matched_events[i].time_start() != end.matched_events[i].time_start())
+      different++;
+  }
+  EXPECT_GT(different, 0);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -3,6 +3,53 @@
 #include <common/reduction/matching/GapMatcher.h>
 
 #include <test/TestBase.h>
+#include <random>
+
+/// \brief random clusters in planes 0 and 1 with random gaps, inserted in
+/// chunks of chronological clusters per plane, matched after each chunk
+template <typename Matcher>
+static void feed_random_clusters(Matcher &matcher, unsigned int seed) {
+  std::default_random_engine gen(seed);
+  std::uniform_int_distribution<uint64_t> gap(0, 400);
+  std::uniform_int_distribution<uint16_t> hits(1, 4);
+  uint64_t time[2] {0, 0};
+  for (int chunk = 0; chunk < 200; ++chunk) {
+    for (uint8_t plane = 0; plane < 2; ++plane) {
+      ClusterContainer clusters;
+      for (int i = 0; i < 5; ++i) {
+        Cluster cluster;
+        time[plane] += gap(gen);
+        for (uint16_t h = 0, n = hits(gen); h < n; ++h) {
+          Hit hit;
+          hit.plane = plane;
+          hit.time = time[plane] + gap(gen) / 4;
+          hit.coordinate = h;
+          hit.weight = 1 + gap(gen);
+          cluster.insert(hit);
+        }
+        clusters.push_back(cluster);
+      }
+      matcher.insert(plane, clusters);
+    }
+    matcher.match(false);
+  }
+  matcher.match(true);
+}
+
+/// \brief matchers produce the same events
+static void expect_same_events(const AbstractMatcher &m1, const AbstractMatcher &m2) {
+  ASSERT_EQ(m1.matched_events.size(), m2.matched_events.size());
+  for (size_t i = 0; i < m1.matched_events.size(); ++i) {
+    const auto &e1 = m1.matched_events[i];
+    const auto &e2 = m2.matched_events[i];
+    EXPECT_EQ(e1.ClusterA.hit_count(), e2.ClusterA.hit_count());
+    EXPECT_EQ(e1.ClusterB.hit_count(), e2.ClusterB.hit_count());
+    EXPECT_EQ(e1.ClusterA.weight_sum(), e2.ClusterA.weight_sum());
+    EXPECT_EQ(e1.ClusterB.weight_sum(), e2.ClusterB.weight_sum());
+    EXPECT_EQ(e1.time_start(), e2.time_start());
+    EXPECT_EQ(e1.time_end(), e2.time_end());
+  }
+}
 
 class GapMatcherTest : public TestBase {
 protected:
@@ -28,6 +75,36 @@ TEST_F(GapMatcherTest, PrintConfig) {
   MESSAGE() << "CONFIG:\n" << matcher.config("  ");
 }
 
+TEST_F(GapMatcherTest, OrderedQueueSameEvents) {
+  for (unsigned int seed : {1, 2, 3}) {
+    GapMatcher list_matcher(1000, 0, 1);
+    list_matcher.set_minimum_time_gap(100);
+    GapMatcher ordered_matcher(1000, 0, 1);
+    ordered_matcher.set_minimum_time_gap(100);
+    ordered_matcher.set_ordered_queue(true);
+
+    feed_random_clusters(list_matcher, seed);
+    feed_random_clusters(ordered_matcher, seed);
+    ASSERT_GT(list_matcher.matched_events.size(), 500);
+    expect_same_events(list_matcher, ordered_matcher);
+  }
+}
+
+TEST_F(GapMatcherTest, OrderedQueueSwitchBack) {
+  GapMatcher matcher(1000, 0, 1);
+  matcher.set_ordered_queue(true);
+  ClusterContainer x;
+  Cluster cluster;
+  cluster.insert({100, 10, 1, 0});
+  x.push_back(cluster);
+  matcher.insert(0, x);
+  matcher.match(false);
+  EXPECT_EQ(matcher.matched_events.size(), 0);
+  matcher.set_ordered_queue(false);
+  matcher.match(true);
+  EXPECT_EQ(matcher.matched_events.size(), 1);
+}
+
 // \todo do more tests
 
 int main(int argc, char **argv) {
@@ -0,0 +1,79 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <benchmark/benchmark.h>
+#include <common/reduction/clustering/GapClusterer.h>
+#include <common/reduction/matching/GapMatcher.h>
+#include <random>
+
+enum class Memory { Pool, SharedPool, Arena };
+
+/// \brief hits of a packet, events of one wire and one strip cluster of
+/// about 5 hits each, a new event every 1us on average, in time order
+static std::vector<HitVector> make_packets(size_t packets, size_t events) {
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> event_gap(500, 1500);
+  std::uniform_int_distribution<uint16_t> channel(0, 60);
+  std::uniform_int_distribution<uint16_t> adc(50, 1000);
+  std::vector<HitVector> ret(packets);
+  uint64_t time{1000000};
+  for (auto &hits : ret) {
+    for (size_t e = 0; e < events; e++) {
+      time += event_gap(gen);
+      for (uint8_t plane = 0; plane < 2; plane++) {
+        uint16_t first = channel(gen);
+        for (uint16_t i = 0; i < 5; i++) {
+          hits.push_back({time + 20 * i, uint16_t(first + i), adc(gen), plane});
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+/// \brief clustering and matching of state.range(0) hits per packet, the
+/// events of each packet are released after the packet
+static void BuildEvents(benchmark::State &state, Memory memory) {
+  auto packets = make_packets(64, state.range(0) / 10);
+  HitVectorStorage::Pool->Shared = (memory == Memory::SharedPool);
+  ClusterPoolStorage::Pool->Shared = (memory == Memory::SharedPool);
+  Arena arena;
+  ArenaScope scope(memory == Memory::Arena ? &arena : nullptr);
+
+  GapClusterer clusterer_a(200, 1);
+  GapClusterer clusterer_b(200, 1);
+  GapMatcher matcher(1000, 0, 1);
+  matcher.set_minimum_time_gap(100);
+
+  size_t packet{0};
+  for (auto _ : state) {
+    for (const auto &hit : packets[packet]) {
+      if (hit.plane == 0)
+        clusterer_a.insert(hit);
+      else
+        clusterer_b.insert(hit);
+    }
+    clusterer_a.flush();
+    clusterer_b.flush();
+    matcher.insert(0, clusterer_a.clusters);
+    matcher.insert(1, clusterer_b.clusters);
+    matcher.match(true);
+    benchmark::DoNotOptimize(matcher.matched_events.size());
+    matcher.matched_events.clear();
+    if (memory == Memory::Arena)
+      arena.recycle();
+    packet = (packet + 1) % packets.size();
+  }
+
+  HitVectorStorage::Pool->Shared = false;
+  ClusterPoolStorage::Pool->Shared = false;
+  state.counters["arena_high_water_kB"] = arena.Stats.HighWaterBytes / 1024;
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BuildEvents, pool, Memory::Pool)
+    ->RangeMultiplier(4)->Range(10, 2560);
+BENCHMARK_CAPTURE(BuildEvents, shared_pool, Memory::SharedPool)
+    ->RangeMultiplier(4)->Range(10, 2560);
+BENCHMARK_CAPTURE(BuildEvents, arena, Memory::Arena)
+    ->RangeMultiplier(4)->Range(10, 2560);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,214 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <common/reduction/ChronoHeapMerger.h>
+#include <common/reduction/ChronoMerger.h>
+#include <random>
+#include <test/TestBase.h>
+
+class ChronoHeapMergerTest : public TestBase {
+protected:
+  ChronoHeapMerger merger{100, 3};
+};
+
+TEST_F(ChronoHeapMergerTest, BadModule) {
+  EXPECT_NO_THROW(merger.insert(0, {0,0}));
+  EXPECT_NO_THROW(merger.insert(1, {0,0}));
+  EXPECT_NO_THROW(merger.insert(2, {0,0}));
+  EXPECT_ANY_THROW(merger.insert(3, {0,0}));
+  EXPECT_ANY_THROW(merger.insert(4, {0,0}));
+}
+
+TEST_F(ChronoHeapMergerTest, Empty) {
+  EXPECT_TRUE(merger.empty());
+  merger.insert(0, {0,0});
+  EXPECT_FALSE(merger.empty());
+  merger.pop_earliest();
+  EXPECT_TRUE(merger.empty());
+}
+
+TEST_F(ChronoHeapMergerTest, PopEarliest) {
+  merger.insert(0, {1,2});
+  merger.insert(0, {3,4});
+  auto n1 = merger.pop_earliest();
+  EXPECT_EQ(n1.time, 1);
+  EXPECT_EQ(n1.pixel_id, 2);
+  auto n2 = merger.pop_earliest();
+  EXPECT_EQ(n2.time, 3);
+  EXPECT_EQ(n2.pixel_id, 4);
+  EXPECT_TRUE(merger.empty());
+}
+
+TEST_F(ChronoHeapMergerTest, Horizon) {
+  EXPECT_EQ(merger.horizon(), 0);
+  merger.insert(0, {5,0});
+  EXPECT_EQ(merger.horizon(), 0);
+  merger.insert(1, {4,0});
+  EXPECT_EQ(merger.horizon(), 0);
+  merger.insert(2, {3,0});
+  EXPECT_EQ(merger.horizon(), 3);
+  merger.insert(2, {6,0});
+  EXPECT_EQ(merger.horizon(), 4);
+  merger.insert(1, {7,0});
+  EXPECT_EQ(merger.horizon(), 5);
+  merger.insert(0, {8,0});
+  EXPECT_EQ(merger.horizon(), 6);
+}
+
+TEST_F(ChronoHeapMergerTest, Earliest) {
+  merger.insert(0, {5,0});
+  merger.insert(1, {4,0});
+  merger.insert(2, {3,0});
+  merger.insert(2, {6,0});
+  merger.insert(1, {7,0});
+  merger.insert(0, {8,0});
+
+  // no sort() needed
+  EXPECT_EQ(merger.earliest(), 3);
+  merger.pop_earliest();
+  EXPECT_EQ(merger.earliest(), 4);
+  merger.pop_earliest();
+  EXPECT_EQ(merger.earliest(), 5);
+  merger.pop_earliest();
+  EXPECT_EQ(merger.earliest(), 6);
+  merger.pop_earliest();
+  EXPECT_EQ(merger.earliest(), 7);
+  merger.pop_earliest();
+  EXPECT_EQ(merger.earliest(), 8);
+  merger.pop_earliest();
+  EXPECT_TRUE(merger.empty());
+}
+
+TEST_F(ChronoHeapMergerTest, Ready) {
+  EXPECT_FALSE(merger.ready());
+  merger.insert(0, {3,0});
+  EXPECT_FALSE(merger.ready());
+  merger.insert(1, {4,0});
+  EXPECT_FALSE(merger.ready());
+  merger.insert(2, {5,0});
+  EXPECT_FALSE(merger.ready());
+
+  merger.insert(0, {104,0});
+  EXPECT_FALSE(merger.ready());
+  merger.insert(1, {105,0});
+  EXPECT_FALSE(merger.ready());
+  merger.insert(2, {106,0});
+  EXPECT_TRUE(merger.ready());
+
+  merger.pop_earliest();
+  EXPECT_FALSE(merger.ready());
+
+  merger.insert(0, {105,0});
+  merger.sort();
+  EXPECT_TRUE(merger.ready());
+  merger.pop_earliest();
+  EXPECT_FALSE(merger.ready());
+
+  merger.insert(0, {106,0});
+  merger.insert(1, {106,0});
+  merger.sort();
+  EXPECT_TRUE(merger.ready());
+  merger.pop_earliest();
+  EXPECT_FALSE(merger.ready());
+}
+
+TEST_F(ChronoHeapMergerTest, Reset) {
+  merger.insert(0, {5,0});
+  merger.insert(1, {4,0});
+  merger.insert(2, {3,0});
+  merger.insert(2, {6,0});
+  merger.insert(1, {7,0});
+  merger.insert(0, {8,0});
+  EXPECT_EQ(merger.horizon(), 6);
+  while (!merger.empty())
+    merger.pop_earliest();
+  EXPECT_TRUE(merger.empty());
+  EXPECT_EQ(merger.horizon(), 6);
+  merger.reset();
+  EXPECT_EQ(merger.horizon(), 0);
+}
+
+
+TEST_F(ChronoHeapMergerTest, Print) {
+  merger.insert(0, {3,0});
+  merger.insert(1, {4,0});
+  merger.insert(2, {5,0});
+  merger.insert(0, {104,0});
+  merger.insert(1, {105,0});
+  merger.insert(2, {106,0});
+  merger.insert(0, {105,0});
+  merger.insert(0, {106,0});
+  merger.insert(1, {106,0});
+  merger.sort();
+
+  MESSAGE() << "NOT A UNIT TEST: please manually check output\n";
+  MESSAGE() << "SIMPLE:\n" << merger.debug("  ", false);
+  MESSAGE() << "VERBOSE:\n" << merger.debug("  ", true);
+}
+
+TEST_F(ChronoHeapMergerTest, OutOfOrderModule) {
+  merger.insert(0, {10,1});
+  merger.insert(0, {5,2});
+  merger.insert(0, {10,3});
+  merger.insert(0, {7,4});
+  merger.insert(1, {6,5});
+  std::vector<uint32_t> pixels;
+  while (!merger.empty())
+    pixels.push_back(merger.pop_earliest().pixel_id);
+  EXPECT_EQ(pixels, std::vector<uint32_t>({2, 5, 4, 1, 3}));
+}
+
+TEST_F(ChronoHeapMergerTest, InsertList) {
+  std::list<NeutronEvent> events {{3,1}, {1,2}, {2,3}};
+  merger.insert(2, events);
+  EXPECT_TRUE(events.empty());
+  EXPECT_EQ(merger.pop_earliest().pixel_id, 2);
+  EXPECT_EQ(merger.pop_earliest().pixel_id, 3);
+  EXPECT_EQ(merger.pop_earliest().pixel_id, 1);
+}
+
+/// same events released as ChronoMerger, for unique event times
+TEST_F(ChronoHeapMergerTest, SameAsChronoMerger) {
+  const size_t modules {8};
+  ChronoMerger list_merger(1000, modules);
+  ChronoHeapMerger heap_merger(1000, modules);
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> jitter(0, 500);
+
+  std::vector<NeutronEvent> out_list, out_heap;
+  uint32_t pixel {0};
+  for (uint64_t packet = 0; packet < 100; ++packet) {
+    for (size_t m = 0; m < modules; ++m) {
+      for (int i = 0; i < 10; ++i) {
+        // unique times, slightly out of order within a module
+        uint64_t time = (packet * 1000 + jitter(gen)) * 16 + m;
+        list_merger.insert(m, {time, pixel});
+        heap_merger.insert(m, {time, pixel});
+        pixel++;
+      }
+    }
+    list_merger.sort();
+    heap_merger.sort();
+    EXPECT_EQ(list_merger.horizon(), heap_merger.horizon());
+    while (list_merger.ready())
+      out_list.push_back(list_merger.pop_earliest());
+    while (heap_merger.ready())
+      out_heap.push_back(heap_merger.pop_earliest());
+    ASSERT_EQ(out_list.size(), out_heap.size());
+  }
+  while (!list_merger.empty())
+    out_list.push_back(list_merger.pop_earliest());
+  while (!heap_merger.empty())
+    out_heap.push_back(heap_merger.pop_earliest());
+
+  ASSERT_EQ(out_list.size(), modules * 1000);
+  ASSERT_EQ(out_list.size(), out_heap.size());
+  for (size_t i = 0; i < out_list.size(); ++i) {
+    EXPECT_EQ(out_list[i].time, out_heap[i].time);
+    EXPECT_EQ(out_list[i].pixel_id, out_heap[i].pixel_id);
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,45 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <benchmark/benchmark.h>
+#include <common/reduction/ChronoHeapMerger.h>
+#include <common/reduction/ChronoMerger.h>
+#include <random>
+
+/// \brief state.range(0) modules each deliver a packet of EventsPerPacket
+/// events per iteration. The merger is sorted and drained of ready events
+/// after each packet, as done by Multigrid and Jalousie. The latency keeps
+/// about LatencyPackets packets from each module queued.
+template <typename Merger>
+static void MergePackets(benchmark::State &state) {
+  const size_t Modules = state.range(0);
+  const uint64_t EventsPerPacket{100};
+  const uint64_t PacketTime{10000};
+  const uint64_t LatencyPackets{4};
+
+  Merger merger(LatencyPackets * PacketTime, Modules);
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> jitter(0, PacketTime / EventsPerPacket);
+
+  uint64_t time{0};
+  int64_t items{0};
+  for (auto _ : state) {
+    for (size_t m = 0; m < Modules; ++m) {
+      for (uint64_t i = 0; i < EventsPerPacket; ++i) {
+        merger.insert(m, {time + i * PacketTime / EventsPerPacket + jitter(gen),
+                          static_cast<uint32_t>(i)});
+      }
+      merger.sort();
+      while (merger.ready()) {
+        benchmark::DoNotOptimize(merger.pop_earliest());
+        items++;
+      }
+    }
+    time += PacketTime;
+  }
+  state.SetItemsProcessed(items);
+}
+
+BENCHMARK_TEMPLATE(MergePackets, ChronoMerger)->RangeMultiplier(2)->Range(1, 32);
+BENCHMARK_TEMPLATE(MergePackets, ChronoHeapMerger)->RangeMultiplier(2)->Range(1, 32);
+
+BENCHMARK_MAIN();
@@ -299,6 +299,41 @@ TEST_F(ClusterTest, MergeMismatchedPlanes) {
   EXPECT_FALSE(cluster2.valid());
 }
 
+TEST_F(ClusterTest, InsertColumnsSameAsInsert) {
+  HitColumns columns;
+  columns.push_back({1000, 7, 10, 0});
+  columns.push_back({1003, 5, 20, 0});
+  columns.push_back({1003, 9, 5, 0});
+  columns.push_back({1001, 6, 65535, 0});
+  columns.push_back({1002, 8, 1, 1});
+  columns.push_back({1003, 8, 1, 1});
+
+  for (size_t split : {0, 1, 3, 6}) {
+    Cluster single;
+    for (size_t i = 0; i < columns.size(); ++i)
+      single.insert(columns.hit(i));
+
+    Cluster bulk;
+    bulk.insert(columns, 0, split);
+    bulk.insert(columns, split, columns.size());
+
+    EXPECT_EQ(bulk.hit_count(), single.hit_count());
+    EXPECT_EQ(bulk.plane(), single.plane());
+    EXPECT_EQ(bulk.time_start(), single.time_start());
+    EXPECT_EQ(bulk.time_end(), single.time_end());
+    EXPECT_EQ(bulk.coord_start(), single.coord_start());
+    EXPECT_EQ(bulk.coord_end(), single.coord_end());
+    EXPECT_EQ(bulk.weight_sum(), single.weight_sum());
+    EXPECT_EQ(bulk.weight2_sum(), single.weight2_sum());
+    EXPECT_EQ(bulk.coord_mass(), single.coord_mass());
+    EXPECT_EQ(bulk.coord_mass2(), single.coord_mass2());
+    EXPECT_EQ(bulk.time_mass(), single.time_mass());
+    EXPECT_EQ(bulk.time_mass2(), single.time_mass2());
+    EXPECT_EQ(bulk.coord_utpc(false), single.coord_utpc(false));
+    EXPECT_EQ(bulk.coord_utpc(true), single.coord_utpc(true));
+  }
+}
+
 TEST_F(ClusterTest, PrintDebug) {
   cluster.insert({0, 5, 1, 0});
   cluster.insert({7, 5, 1, 0});
@@ -0,0 +1,114 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <benchmark/benchmark.h>
+#include <common/reduction/clustering/GapClusterer.h>
+#include <random>
+
+/// \brief NMX-like hits: tracks of about 10 strips hit within 200ns,
+/// a new track every 1us on average, strips 0 - 1279, in time order
+static HitVector make_hits(size_t size) {
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> track_gap(500, 1500);
+  std::uniform_int_distribution<uint64_t> hit_time(0, 200);
+  std::uniform_int_distribution<uint16_t> strip(0, 1270);
+  std::uniform_int_distribution<uint16_t> track_strip(0, 9);
+  std::uniform_int_distribution<uint16_t> adc(50, 1000);
+  HitVector hits;
+  uint64_t time{1000000000000ULL};
+  while (hits.size() < size) {
+    time += track_gap(gen);
+    uint16_t first_strip = strip(gen);
+    HitVector track;
+    for (int i = 0; i < 10 && hits.size() + track.size() < size; i++) {
+      track.push_back({time + hit_time(gen),
+                       static_cast<uint16_t>(first_strip + track_strip(gen)),
+                       adc(gen), 0});
+    }
+    sort_chronologically(track);
+    hits.insert(hits.end(), track.begin(), track.end());
+  }
+  return hits;
+}
+
+static void ClusterAoS(benchmark::State &state) {
+  auto hits = make_hits(state.range(0));
+  GapClusterer clusterer(200, 2);
+  for (auto _ : state) {
+    clusterer.cluster(hits);
+    clusterer.flush();
+    benchmark::DoNotOptimize(clusterer.clusters.size());
+    clusterer.clusters.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ClusterAoS)->RangeMultiplier(4)->Range(256, 16384);
+
+static void ClusterSoA(benchmark::State &state) {
+  HitColumns hits(make_hits(state.range(0)));
+  GapClusterer clusterer(200, 2);
+  for (auto _ : state) {
+    clusterer.cluster(hits);
+    clusterer.flush();
+    benchmark::DoNotOptimize(clusterer.clusters.size());
+    clusterer.clusters.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ClusterSoA)->RangeMultiplier(4)->Range(256, 16384);
+
+/// \brief filling one cluster of state.range(0) hits
+static void ClusterInsertAoS(benchmark::State &state) {
+  auto hits = make_hits(state.range(0));
+  for (auto _ : state) {
+    Cluster cluster;
+    for (const auto &hit : hits) {
+      cluster.insert(hit);
+    }
+    benchmark::DoNotOptimize(cluster.weight_sum());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ClusterInsertAoS)->RangeMultiplier(4)->Range(4, 1024);
+
+static void ClusterInsertSoA(benchmark::State &state) {
+  HitColumns hits(make_hits(state.range(0)));
+  for (auto _ : state) {
+    Cluster cluster;
+    cluster.insert(hits, 0, hits.size());
+    benchmark::DoNotOptimize(cluster.weight_sum());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ClusterInsertSoA)->RangeMultiplier(4)->Range(4, 1024);
+
+static void SortByCoordinateAoS(benchmark::State &state, HitSort method) {
+  auto batch = make_hits(state.range(0));
+  HitVector hits;
+  for (auto _ : state) {
+    hits = batch;
+    sort_by_increasing_coordinate(hits, method);
+    benchmark::DoNotOptimize(hits.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(SortByCoordinateAoS, std_sort, HitSort::StdSort)
+    ->RangeMultiplier(8)->Range(64, 16384);
+BENCHMARK_CAPTURE(SortByCoordinateAoS, radix, HitSort::Radix)
+    ->RangeMultiplier(8)->Range(64, 16384);
+
+static void SortByCoordinateSoA(benchmark::State &state, HitSort method) {
+  HitColumns batch(make_hits(state.range(0)));
+  HitColumns hits;
+  for (auto _ : state) {
+    hits = batch;
+    sort_by_increasing_coordinate(hits, method);
+    benchmark::DoNotOptimize(hits.coordinate.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(SortByCoordinateSoA, std_sort, HitSort::StdSort)
+    ->RangeMultiplier(8)->Range(64, 16384);
+BENCHMARK_CAPTURE(SortByCoordinateSoA, radix, HitSort::Radix)
+    ->RangeMultiplier(8)->Range(64, 16384);
+
+BENCHMARK_MAIN();
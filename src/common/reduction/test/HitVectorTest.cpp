@@ -5,6 +5,7 @@
 
 #include <random>
 #include <chrono>
+#include <thread>
 
 class HitVectorTest : public TestBase {
 protected:
@@ -46,6 +47,151 @@ TEST_F(HitVectorTest, Visualize) {
   MESSAGE() << "\n" << visualize(hits, {}, 0, 30) << "\n";
 }
 
+bool same_hits(const HitVector &a, const HitVector &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if ((a[i].time != b[i].time) || (a[i].coordinate != b[i].coordinate) ||
+        (a[i].weight != b[i].weight))
+      return false;
+  }
+  return true;
+}
+
+// radix sort is stable, so it must give the same result as std::stable_sort
+TEST_F(HitVectorTest, RadixSort) {
+  std::uniform_int_distribution<uint64_t> time_offset(0, 100000);
+  std::uniform_int_distribution<uint16_t> coord(0, 1279);
+  for (size_t size : {0, 1, 2, 100, 511, 512, 1000, 10000}) {
+    for (uint64_t base : {0ULL, 1ULL << 40, 0xfffffffffff00000ULL}) {
+      HitVector hits;
+      for (size_t i = 0; i < size; ++i) {
+        Hit hit;
+        hit.time = base + time_offset(gen_);
+        hit.coordinate = coord(gen_);
+        hit.weight = i;
+        hits.push_back(hit);
+      }
+
+      auto by_time = hits;
+      std::stable_sort(by_time.begin(), by_time.end(),
+          [](const Hit &a, const Hit &b) { return a.time < b.time; });
+      auto radix_time = hits;
+      radix_sort_chronologically(radix_time);
+      ASSERT_TRUE(same_hits(radix_time, by_time));
+
+      auto by_coord = hits;
+      std::stable_sort(by_coord.begin(), by_coord.end(),
+          [](const Hit &a, const Hit &b) { return a.coordinate < b.coordinate; });
+      auto radix_coord = hits;
+      sort_by_increasing_coordinate(radix_coord, HitSort::Radix);
+      if (size >= RadixSortMinHits) {
+        ASSERT_TRUE(same_hits(radix_coord, by_coord));
+      }
+      for (size_t i = 1; i < radix_coord.size(); i++) {
+        ASSERT_LE(radix_coord[i - 1].coordinate, radix_coord[i].coordinate);
+      }
+    }
+  }
+}
+
+TEST_F(HitVectorTest, HitColumns) {
+  HitVector hits;
+  for (uint16_t i = 0; i < 100; ++i) {
+    hits.push_back({1000ULL - i, i, static_cast<uint16_t>(2 * i),
+                    static_cast<uint8_t>(i % 3)});
+  }
+  HitColumns columns(hits);
+  ASSERT_EQ(columns.size(), 100);
+  EXPECT_EQ(columns.time[10], 990);
+  EXPECT_EQ(columns.coordinate[10], 10);
+  EXPECT_EQ(columns.weight[10], 20);
+  EXPECT_EQ(columns.plane[10], 1);
+  EXPECT_EQ(columns.hit(10).time, 990);
+
+  HitColumns part;
+  part.append(columns, 10, 20);
+  ASSERT_EQ(part.size(), 10);
+  EXPECT_EQ(part.coordinate.front(), 10);
+
+  HitVector back;
+  columns.copy_to(back);
+  EXPECT_TRUE(same_hits(back, hits));
+  columns.clear();
+  EXPECT_TRUE(columns.empty());
+}
+
+// column sorts must give the same order as the stable sort of the AoS hits
+TEST_F(HitVectorTest, HitColumnsSort) {
+  std::uniform_int_distribution<uint64_t> time_offset(0, 100000);
+  std::uniform_int_distribution<uint16_t> coord(0, 1279);
+  for (size_t size : {0, 1, 100, 1000}) {
+    HitVector hits;
+    for (size_t i = 0; i < size; ++i) {
+      Hit hit;
+      hit.time = (1ULL << 40) + time_offset(gen_);
+      hit.coordinate = coord(gen_);
+      hit.weight = i;
+      hit.plane = i % 2;
+      hits.push_back(hit);
+    }
+
+    auto by_time = hits;
+    std::stable_sort(by_time.begin(), by_time.end(),
+        [](const Hit &a, const Hit &b) { return a.time < b.time; });
+    HitColumns columns(hits);
+    sort_chronologically(columns, HitSort::Radix);
+    HitVector sorted;
+    columns.copy_to(sorted);
+    if (size >= RadixSortMinHits) {
+      ASSERT_TRUE(same_hits(sorted, by_time));
+    }
+    for (size_t i = 1; i < sorted.size(); i++) {
+      ASSERT_LE(sorted[i - 1].time, sorted[i].time);
+      ASSERT_EQ(sorted[i].plane, sorted[i].weight % 2);
+    }
+
+    auto by_coord = hits;
+    std::stable_sort(by_coord.begin(), by_coord.end(),
+        [](const Hit &a, const Hit &b) { return a.coordinate < b.coordinate; });
+    columns = HitColumns(hits);
+    sort_by_increasing_coordinate(columns, HitSort::Radix);
+    sorted.clear();
+    columns.copy_to(sorted);
+    if (size >= RadixSortMinHits) {
+      ASSERT_TRUE(same_hits(sorted, by_coord));
+    }
+
+    columns = HitColumns(hits);
+    sort_by_increasing_coordinate(columns);
+    for (size_t i = 1; i < columns.size(); i++) {
+      ASSERT_LE(columns.coordinate[i - 1], columns.coordinate[i]);
+    }
+  }
+}
+
+// concurrent allocations must leave the largest request in MaxAllocCount
+TEST_F(HitVectorTest, MaxAllocCount) {
+  size_t Largest = HitVectorStorage::MaxAllocCount + 1000;
+  std::vector<std::thread> Threads;
+  for (size_t t = 0; t < 4; t++) {
+    Threads.emplace_back([Largest, t]() {
+      for (size_t n = Largest - 100 * (t + 1); n <= Largest - t; n++) {
+        HitVector hits;
+        hits.reserve(n);
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  ASSERT_EQ(HitVectorStorage::MaxAllocCount, Largest);
+
+  HitVector hits;
+  hits.reserve(Largest - 1);
+  ASSERT_EQ(HitVectorStorage::MaxAllocCount, Largest);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,202 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+
+#include <common/Arena.h>
+#include <test/TestBase.h>
+#include <thread>
+
+class ArenaTest : public TestBase {
+public:
+};
+
+TEST_F(ArenaTest, AllocateAligned) {
+  Arena Memory;
+  ASSERT_EQ(Memory.Stats.Chunks, 0);
+
+  void *a = Memory.allocate(1);
+  void *b = Memory.allocate(17);
+  void *c = Memory.allocate(64);
+  ASSERT_TRUE(Arena::contains(a));
+  ASSERT_TRUE(Arena::contains(b));
+  ASSERT_TRUE(Arena::contains(c));
+  ASSERT_EQ((uintptr_t)a % Arena::Alignment, 0);
+  ASSERT_EQ((unsigned char *)b - (unsigned char *)a, 16);
+  ASSERT_EQ((unsigned char *)c - (unsigned char *)b, 32);
+
+  ASSERT_EQ(Memory.Stats.AllocCount, 3);
+  ASSERT_EQ(Memory.Stats.AllocBytes, 16 + 32 + 64);
+  ASSERT_EQ(Memory.Stats.UsedBytes, 16 + 32 + 64);
+  ASSERT_EQ(Memory.Stats.Chunks, 1);
+
+  Arena::deallocate(a);
+  Arena::deallocate(b);
+  Arena::deallocate(c);
+}
+
+TEST_F(ArenaTest, NotContained) {
+  int OnStack{0};
+  ASSERT_FALSE(Arena::contains(&OnStack));
+  auto OnHeap = new int(0);
+  ASSERT_FALSE(Arena::contains(OnHeap));
+  delete OnHeap;
+}
+
+TEST_F(ArenaTest, Fallback) {
+  Arena Memory(1);
+  ASSERT_EQ(Memory.allocate(0), nullptr);
+  ASSERT_EQ(Memory.allocate(Arena::MaxAllocBytes + 1), nullptr);
+  ASSERT_EQ(Memory.Stats.FallbackCount, 2);
+
+  // a single chunk fits four of the largest allocations
+  std::vector<void *> Allocs;
+  for (int i = 0; i < 4; i++) {
+    Allocs.push_back(Memory.allocate(Arena::MaxAllocBytes));
+    ASSERT_NE(Allocs.back(), nullptr);
+  }
+  ASSERT_EQ(Memory.allocate(1), nullptr);
+  ASSERT_EQ(Memory.Stats.FallbackCount, 3);
+
+  for (auto p : Allocs) {
+    Arena::deallocate(p);
+  }
+  // all released, the chunk is rewound
+  ASSERT_NE(Memory.allocate(1), nullptr);
+  ASSERT_EQ(Memory.Stats.Rewinds, 1);
+}
+
+TEST_F(ArenaTest, ChunkShare) {
+  ASSERT_EQ(Arena::chunkShare(1), Arena::DefaultMaxChunks);
+  ASSERT_EQ(Arena::chunkShare(4), Arena::DefaultMaxChunks);
+  ASSERT_EQ(Arena::chunkShare(5), Arena::NumChunks / 5);
+  ASSERT_EQ(Arena::chunkShare(16), Arena::NumChunks / 16);
+}
+
+TEST_F(ArenaTest, PinnedChunksFallback) {
+  // one long lived allocation in each chunk, the arena stops at its share
+  const size_t MaxChunks{Arena::chunkShare(Arena::NumChunks / 4)};
+  Arena Memory(MaxChunks);
+  std::vector<void *> Live;
+  for (size_t i = 0; i < MaxChunks; i++) {
+    // fill three quarters of a new chunk, only Live stays allocated
+    std::vector<void *> Fill{Memory.allocate(Arena::MaxAllocBytes)};
+    Live.push_back(Memory.allocate(100));
+    Fill.push_back(Memory.allocate(Arena::MaxAllocBytes));
+    Fill.push_back(Memory.allocate(Arena::MaxAllocBytes));
+    for (auto p : Fill) {
+      ASSERT_NE(p, nullptr);
+      Arena::deallocate(p);
+    }
+  }
+  ASSERT_EQ(Memory.Stats.Chunks, MaxChunks);
+  ASSERT_EQ(Memory.allocate(Arena::MaxAllocBytes), nullptr);
+  ASSERT_EQ(Memory.Stats.FallbackCount, 1);
+
+  for (auto p : Live) {
+    Arena::deallocate(p);
+  }
+}
+
+TEST_F(ArenaTest, RecycleRewinds) {
+  Arena Memory;
+  void *First = Memory.allocate(100);
+  Arena::deallocate(First);
+  Memory.recycle();
+  ASSERT_EQ(Memory.Stats.UsedBytes, 0);
+  ASSERT_EQ(Memory.Stats.Rewinds, 1);
+
+  void *Again = Memory.allocate(100);
+  ASSERT_EQ(Again, First);
+  Arena::deallocate(Again);
+  ASSERT_EQ(Memory.Stats.HighWaterBytes, 112);
+}
+
+TEST_F(ArenaTest, RecycleKeepsLiveChunks) {
+  Arena Memory;
+  void *Live = Memory.allocate(1000);
+  void *Dead = Memory.allocate(1000);
+  Arena::deallocate(Dead);
+  Memory.recycle();
+  ASSERT_EQ(Memory.Stats.Rewinds, 0);
+  ASSERT_EQ(Memory.Stats.UsedBytes, 2016);
+
+  void *Next = Memory.allocate(16);
+  ASSERT_GT(Next, Live);
+  Arena::deallocate(Next);
+  Arena::deallocate(Live);
+}
+
+TEST_F(ArenaTest, HighWaterChunks) {
+  Arena Memory;
+  std::vector<void *> Allocs;
+  for (int i = 0; i < 12; i++) {
+    Allocs.push_back(Memory.allocate(Arena::MaxAllocBytes));
+  }
+  ASSERT_EQ(Memory.Stats.Chunks, 3);
+  ASSERT_EQ(Memory.Stats.HighWaterBytes, 3 * Arena::ChunkBytes);
+
+  for (auto p : Allocs) {
+    Arena::deallocate(p);
+  }
+  Memory.recycle();
+  ASSERT_EQ(Memory.Stats.Chunks, 1);
+  ASSERT_EQ(Memory.Stats.UsedBytes, 0);
+  ASSERT_EQ(Memory.Stats.HighWaterChunks, 3);
+  ASSERT_EQ(Memory.Stats.HighWaterBytes, 3 * Arena::ChunkBytes);
+}
+
+TEST_F(ArenaTest, ReleasedAfterArena) {
+  void *Orphan;
+  {
+    Arena Memory;
+    Orphan = Memory.allocate(100);
+  }
+  ASSERT_TRUE(Arena::contains(Orphan));
+  Arena::deallocate(Orphan);
+
+  // the chunk went back to the pool and is handed out again
+  Arena Memory;
+  void *p = Memory.allocate(100);
+  ASSERT_NE(p, nullptr);
+  Arena::deallocate(p);
+}
+
+TEST_F(ArenaTest, ReleasedByOtherThread) {
+  Arena Memory(1);
+  std::vector<void *> Allocs;
+  for (int i = 0; i < 1000; i++) {
+    Allocs.push_back(Memory.allocate(100));
+  }
+  std::thread Releaser([&Allocs]() {
+    for (auto p : Allocs) {
+      Arena::deallocate(p);
+    }
+  });
+  Releaser.join();
+  Memory.recycle();
+  ASSERT_EQ(Memory.Stats.UsedBytes, 0);
+}
+
+TEST_F(ArenaTest, Scope) {
+  ASSERT_EQ(Arena::current(), nullptr);
+  Arena Outer;
+  Arena Inner;
+  {
+    ArenaScope Scope1(&Outer);
+    ASSERT_EQ(Arena::current(), &Outer);
+    {
+      ArenaScope Scope2(&Inner);
+      ASSERT_EQ(Arena::current(), &Inner);
+      ArenaScope Scope3(nullptr);
+      ASSERT_EQ(Arena::current(), nullptr);
+    }
+    ASSERT_EQ(Arena::current(), &Outer);
+
+    std::thread Other([]() { ASSERT_EQ(Arena::current(), nullptr); });
+    Other.join();
+  }
+  ASSERT_EQ(Arena::current(), nullptr);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -18,6 +18,41 @@ public:
 
 DetectorFactory<TestDetector> Factory;
 
+/// detector with an input thread per receiver
+class MultiReceiverDetector : public InputDetector<> {
+public:
+  explicit MultiReceiverDetector(BaseSettings settings)
+      : InputDetector("multi receiver", settings) {
+    enableReceivers();
+  };
+};
+
+DetectorFactory<MultiReceiverDetector> MultiFactory;
+
+/// detector selecting the sequentially consistent input fifo
+class SeqCstDetector
+    : public InputDetector<memory_sequential_consistent::CircularFifo> {
+public:
+  explicit SeqCstDetector(BaseSettings settings)
+      : InputDetector("seq_cst fifo", settings) {
+    enableReceivers();
+  };
+
+  static constexpr bool seqCstFifo() {
+    return std::is_same<InputFifoType,
+        memory_sequential_consistent::CircularFifo<unsigned int,
+            EthernetBufferMaxEntries>>::value;
+  }
+
+  bool push(unsigned int Receiver, unsigned int DataIndex) {
+    return inputFifo(Receiver).push(DataIndex);
+  }
+
+  bool pop(unsigned int &Receiver, unsigned int &DataIndex) {
+    return popInputFifos(Receiver, DataIndex);
+  }
+};
+
 /** Test fixture and tests below */
 
 class DetectorTest : public TestBase {
@@ -59,6 +94,67 @@ TEST_F(DetectorTest, GetDetectorCommandFunctionsNoCommands) {
   ASSERT_EQ(0, commandmap.size());
 }
 
+TEST_F(DetectorTest, DefaultReceivers) { ASSERT_EQ(det->receivers(), 1); }
+
+TEST_F(DetectorTest, MultipleReceivers) {
+  settings.ReceiverThreads = 4;
+  auto Multi = MultiFactory.create(settings);
+  ASSERT_EQ(Multi->receivers(), 4);
+  ASSERT_TRUE(Multi->receiversSupported());
+
+  settings.ReceiverThreads = 0;
+  Multi = MultiFactory.create(settings);
+  ASSERT_EQ(Multi->receivers(), 1);
+  ASSERT_TRUE(Multi->receiversSupported());
+
+  settings.ReceiverThreads = 100;
+  Multi = MultiFactory.create(settings);
+  ASSERT_EQ(Multi->receivers(), 8);
+  ASSERT_TRUE(Multi->receiversSupported());
+}
+
+TEST_F(DetectorTest, ReceiversNotSupported) {
+  ASSERT_TRUE(det->receiversSupported());
+
+  settings.ReceiverThreads = 4;
+  auto Single = Factory.create(settings);
+  ASSERT_EQ(Single->receivers(), 1);
+  ASSERT_FALSE(Single->receiversSupported());
+}
+
+TEST_F(DetectorTest, RxInterfaceNotSupported) {
+  ASSERT_TRUE(det->rxInterfaceSupported());
+
+  settings.PacketMmapInterface = "lo";
+  auto Udp = Factory.create(settings);
+  ASSERT_FALSE(Udp->rxInterfaceSupported());
+}
+
+TEST_F(DetectorTest, SeqCstFifo) {
+  ASSERT_TRUE(SeqCstDetector::seqCstFifo());
+
+  settings.ReceiverThreads = 2;
+  SeqCstDetector SeqCst(settings);
+  ASSERT_EQ(SeqCst.receivers(), 2);
+
+  ASSERT_TRUE(SeqCst.push(0, 10));
+  ASSERT_TRUE(SeqCst.push(1, 20));
+  ASSERT_TRUE(SeqCst.push(0, 11));
+
+  unsigned int Receiver{1};
+  unsigned int DataIndex{0};
+  ASSERT_TRUE(SeqCst.pop(Receiver, DataIndex));
+  ASSERT_EQ(Receiver, 0);
+  ASSERT_EQ(DataIndex, 10);
+  ASSERT_TRUE(SeqCst.pop(Receiver, DataIndex));
+  ASSERT_EQ(Receiver, 1);
+  ASSERT_EQ(DataIndex, 20);
+  ASSERT_TRUE(SeqCst.pop(Receiver, DataIndex));
+  ASSERT_EQ(Receiver, 0);
+  ASSERT_EQ(DataIndex, 11);
+  ASSERT_FALSE(SeqCst.pop(Receiver, DataIndex));
+}
+
 class DetectorRegistration : public TestBase {
 protected:
   void SetUp() override {
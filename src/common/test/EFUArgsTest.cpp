@@ -122,6 +122,52 @@ TEST_F(EFUArgsTest, VerifyCommandLineOptions) {
   ASSERT_EQ(8989, settings.CommandServerPort);
 }
 
+TEST_F(EFUArgsTest, ReceiveBatchRange) {
+  const char *myargv[] = {"progname", "-d", "myinst", "--rxbatch", "64"};
+  int myargc = 5;
+  EFUArgs efu_args;
+  ASSERT_EQ(efu_args.parseSecondPass(myargc, (char **)myargv),
+            EFUArgs::Status::CONTINUE);
+  ASSERT_EQ(efu_args.getBaseSettings().ReceiveBatchSize, 64);
+
+  for (auto Invalid : {"0", "65", "-1"}) {
+    const char *badargv[] = {"progname", "-d", "myinst", "--rxbatch", Invalid};
+    EFUArgs bad_args;
+    ASSERT_EQ(bad_args.parseSecondPass(myargc, (char **)badargv),
+              EFUArgs::Status::EXIT);
+  }
+}
+
+TEST_F(EFUArgsTest, ReceiverThreadsRange) {
+  const char *myargv[] = {"progname", "-d", "myinst", "--rxthreads", "8"};
+  int myargc = 5;
+  EFUArgs efu_args;
+  ASSERT_EQ(efu_args.parseSecondPass(myargc, (char **)myargv),
+            EFUArgs::Status::CONTINUE);
+  ASSERT_EQ(efu_args.getBaseSettings().ReceiverThreads, 8);
+
+  for (auto Invalid : {"0", "9", "-1"}) {
+    const char *badargv[] = {"progname", "-d", "myinst", "--rxthreads", Invalid};
+    EFUArgs bad_args;
+    ASSERT_EQ(bad_args.parseSecondPass(myargc, (char **)badargv),
+              EFUArgs::Status::EXIT);
+  }
+}
+
+TEST_F(EFUArgsTest, IdleMode) {
+  const char *myargv[] = {"progname", "-d", "myinst", "--idle", "backoff"};
+  int myargc = 5;
+  EFUArgs efu_args;
+  ASSERT_EQ(efu_args.parseSecondPass(myargc, (char **)myargv),
+            EFUArgs::Status::CONTINUE);
+  ASSERT_EQ(efu_args.getBaseSettings().IdleMode, "backoff");
+
+  const char *badargv[] = {"progname", "-d", "myinst", "--idle", "nap"};
+  EFUArgs bad_args;
+  ASSERT_EQ(bad_args.parseSecondPass(myargc, (char **)badargv),
+            EFUArgs::Status::EXIT);
+}
+
 #ifdef RUN_REGEX_UNIT_TESTS
 TEST_F(EFUArgsTest, CoreAffinityOption) {
   int myargc = 5;
@@ -42,6 +42,65 @@ TEST_F(FixedSizePoolTest, Small_NoSpace) {
   ASSERT_STREQ(pool.ValidateEmptyStateAndReturnError(), nullptr);
 }
 
+TEST_F(FixedSizePoolTest, Pinned) {
+  using FixedSizePool_t = FixedSizePool<FixedSizePoolParams<64, 1024>>;
+  FixedSizePool_t *pool = FixedSizePool_t::CreatePinned();
+  ASSERT_GE(pool->MemoryBacking, PinnedMemory::Default);
+  ASSERT_LE(pool->MemoryBacking, PinnedMemory::HugePages);
+
+  void *mem = pool->AllocateSlot();
+  ASSERT_TRUE(pool->Contains(mem));
+  pool->DeallocateSlot(mem);
+
+  ASSERT_STREQ(pool->ValidateEmptyStateAndReturnError(), nullptr);
+  FixedSizePool_t::DestroyPinned(pool);
+}
+
+TEST_F(FixedSizePoolTest, SharedThreads) {
+  using FixedSizePool_t = FixedSizePool<FixedSizePoolParams<64, 1024>>;
+  FixedSizePool_t *pool = FixedSizePool_t::CreatePinned();
+  pool->Shared = true;
+
+  auto allocFree = [pool]() {
+    for (int i = 0; i < 10000; i++) {
+      void *mem[4];
+      for (auto &m : mem) {
+        m = pool->AllocateSlot();
+      }
+      for (auto &m : mem) {
+        pool->DeallocateSlot(m);
+      }
+    }
+  };
+  std::thread t1(allocFree);
+  std::thread t2(allocFree);
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ(pool->Stats.AllocCount, 80000);
+  ASSERT_STREQ(pool->ValidateEmptyStateAndReturnError(), nullptr);
+  FixedSizePool_t::DestroyPinned(pool);
+}
+
+TEST_F(FixedSizePoolTest, SharedPoolScope) {
+  FixedSizePool<FixedSizePoolParams<8, 1>> pool;
+  ASSERT_FALSE(pool.IsShared());
+  {
+    SharedPoolScope<decltype(pool)> scope1(pool);
+    ASSERT_TRUE(pool.IsShared());
+    {
+      SharedPoolScope<decltype(pool)> scope2(pool);
+      ASSERT_TRUE(pool.IsShared());
+    }
+    ASSERT_TRUE(pool.IsShared());
+  }
+  ASSERT_FALSE(pool.IsShared());
+
+  pool.Shared = true;
+  { SharedPoolScope<decltype(pool)> scope(pool); }
+  ASSERT_TRUE(pool.IsShared());
+}
+
 TEST_F(FixedSizePoolTest, Small_1_NewlyAllocatedPattern) {
   FixedSizePool<FixedSizePoolParams<8, 1>> pool;
 
@@ -0,0 +1,61 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+
+#include <common/IdleStrategy.h>
+#include <test/TestBase.h>
+
+class IdleStrategyTest : public TestBase {};
+
+TEST_F(IdleStrategyTest, ModeFromString) {
+  ASSERT_EQ(IdleStrategy::modeFromString("sleep"), IdleStrategy::Sleep);
+  ASSERT_EQ(IdleStrategy::modeFromString("spin"), IdleStrategy::BusySpin);
+  ASSERT_EQ(IdleStrategy::modeFromString("yield"), IdleStrategy::SpinYield);
+  ASSERT_EQ(IdleStrategy::modeFromString("backoff"), IdleStrategy::Backoff);
+  ASSERT_EQ(IdleStrategy::modeFromString("nosuchmode"), IdleStrategy::Sleep);
+}
+
+TEST_F(IdleStrategyTest, Sleep) {
+  IdleStrategy Idle("sleep", 1);
+  for (int i = 0; i < 10; i++) {
+    Idle.idle();
+  }
+  ASSERT_EQ(Idle.Counters.Sleeps, 10);
+  ASSERT_EQ(Idle.Counters.Spins, 0);
+}
+
+TEST_F(IdleStrategyTest, BusySpin) {
+  IdleStrategy Idle("spin", 10);
+  for (int i = 0; i < 5000; i++) {
+    Idle.idle();
+  }
+  ASSERT_EQ(Idle.Counters.Spins, 5000);
+  ASSERT_EQ(Idle.Counters.Yields, 0);
+  ASSERT_EQ(Idle.Counters.Sleeps, 0);
+}
+
+TEST_F(IdleStrategyTest, SpinThenYield) {
+  IdleStrategy Idle("yield", 10);
+  for (int i = 0; i < 1500; i++) {
+    Idle.idle();
+  }
+  ASSERT_EQ(Idle.Counters.Spins, 1000);
+  ASSERT_EQ(Idle.Counters.Yields, 500);
+
+  Idle.reset();
+  Idle.idle();
+  ASSERT_EQ(Idle.Counters.Spins, 1001);
+}
+
+TEST_F(IdleStrategyTest, Backoff) {
+  IdleStrategy Idle("backoff", 10);
+  for (int i = 0; i < 1100; i++) {
+    Idle.idle();
+  }
+  ASSERT_EQ(Idle.Counters.Spins, 1000);
+  ASSERT_EQ(Idle.Counters.Pauses, 100);
+  ASSERT_EQ(Idle.Counters.Sleeps, 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+
+#include <common/PacketMmapReceiver.h>
+#include <memory>
+#include <test/TestBase.h>
+
+/// Uses the loopback interface. AF_PACKET sockets need CAP_NET_RAW, when
+/// not available the tests are skipped.
+class PacketMmapReceiverTest : public TestBase {
+protected:
+  std::unique_ptr<PacketMmapReceiver> create(uint16_t Port) {
+    try {
+      auto Receiver = std::unique_ptr<PacketMmapReceiver>(
+          new PacketMmapReceiver("lo", Port, -1, 1 << 16, 8));
+      Receiver->setRecvTimeout(0, 100000);
+      return Receiver;
+    } catch (std::runtime_error &) {
+      return nullptr;
+    }
+  }
+
+  /// receive until Count packets are in Ring or a receive times out
+  int receive(PacketMmapReceiver &Receiver, RingBuffer<9000> &Ring, int Count) {
+    int Packets = 0;
+    while (Packets < Count) {
+      int Res = Receiver.receiveBatch(Ring, 16);
+      if (Res == 0) {
+        break;
+      }
+      for (int i = 0; i < Res; i++) {
+        Ring.getNextBuffer();
+      }
+      Packets += Res;
+    }
+    return Packets;
+  }
+};
+
+#define SKIP_WITHOUT_AF_PACKET(Receiver)                                       \
+  if (Receiver == nullptr) {                                                   \
+    MESSAGE() << "Skipped, no AF_PACKET socket (CAP_NET_RAW?)\n";              \
+    return;                                                                    \
+  }
+
+TEST_F(PacketMmapReceiverTest, InvalidInterface) {
+  ASSERT_THROW(PacketMmapReceiver Receiver("nosuchinterface", 13250),
+               std::runtime_error);
+}
+
+TEST_F(PacketMmapReceiverTest, ReceiveFilterPort) {
+  auto Receiver = create(13251);
+  SKIP_WITHOUT_AF_PACKET(Receiver);
+  char DummyData[] {0x01, 0x02, 0x03, 0x04, 0x05};
+  Socket::Endpoint Local("127.0.0.1", 13252);
+  Socket::Endpoint Remote("127.0.0.1", 13251);
+  Socket::Endpoint OtherLocal("127.0.0.1", 13253);
+  Socket::Endpoint Other("127.0.0.1", 13256);
+  UDPReceiver Sink(Remote);
+  UDPReceiver OtherSink(Other);
+  UDPTransmitter Xmitter(Local, Remote);
+  UDPTransmitter OtherXmitter(OtherLocal, Other);
+
+  for (int i = 1; i <= 5; i++) {
+    ASSERT_EQ(OtherXmitter.send(DummyData, 5), 5); // filtered out
+    ASSERT_EQ(Xmitter.send(DummyData, i), i);
+  }
+
+  RingBuffer<9000> Ring(100);
+  ASSERT_EQ(receive(*Receiver, Ring, 100), 5);
+  for (int i = 1; i <= 5; i++) {
+    ASSERT_EQ(Ring.getDataLength(i - 1), i);
+    ASSERT_EQ(Ring.getDataBuffer(i - 1)[i - 1], i);
+    Ring.release(i - 1);
+  }
+}
+
+TEST_F(PacketMmapReceiverTest, ReceiveBatch) {
+  auto Receiver = create(13254);
+  SKIP_WITHOUT_AF_PACKET(Receiver);
+  char DummyData[9000];
+  Socket::Endpoint Local("127.0.0.1", 13255);
+  Socket::Endpoint Remote("127.0.0.1", 13254);
+  UDPReceiver Sink(Remote);
+  UDPTransmitter Xmitter(Local, Remote);
+
+  for (int i = 1; i <= 20; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, i * 400), i * 400);
+  }
+
+  RingBuffer<9000> Ring(100);
+  ASSERT_EQ(receive(*Receiver, Ring, 20), 20);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(Ring.getDataLength(i), (i + 1) * 400);
+    Ring.release(i);
+  }
+  ASSERT_EQ(Receiver->receiveBatch(Ring, 16), 0);
+  ASSERT_EQ(Receiver->getDropped(), 0);
+}
+
+TEST_F(PacketMmapReceiverTest, BlocksKeptUntilReleased) {
+  auto Receiver = create(13257);
+  SKIP_WITHOUT_AF_PACKET(Receiver);
+  char DummyData[8000];
+  Socket::Endpoint Local("127.0.0.1", 13258);
+  Socket::Endpoint Remote("127.0.0.1", 13257);
+  UDPReceiver Sink(Remote);
+  UDPTransmitter Xmitter(Local, Remote);
+
+  MESSAGE() << "Ring of 8 x 64kB blocks is full after ~60 packets\n";
+  RingBuffer<9000> Ring(200);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, 8000), 8000);
+  }
+  int Packets = receive(*Receiver, Ring, 200);
+  ASSERT_GT(Packets, 0);
+  ASSERT_LT(Packets, 100);
+  ASSERT_GT(Receiver->getDropped(), 0);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, 8000), 8000);
+  }
+  ASSERT_EQ(receive(*Receiver, Ring, 200 - Packets), 0); // not released
+
+  for (int i = 0; i < Packets; i++) {
+    Ring.release(i);
+  }
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, 100), 100);
+  }
+  ASSERT_EQ(receive(*Receiver, Ring, 200 - Packets), 5);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
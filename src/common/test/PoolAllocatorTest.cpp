@@ -2,6 +2,7 @@
 
 #include <common/PoolAllocator.h>
 #include <test/TestBase.h>
+#include <thread>
 
 class PoolAllocatorTest : public TestBase {
 public:
@@ -90,19 +91,19 @@ TEST_F(PoolAllocatorTest, Share_2) {
   AllocConfig::PoolType pool;
   PoolAllocator<AllocConfig> alloc(pool);
   {
-    ASSERT_EQ(alloc.Pool.NumSlotsUsed, 0);
+    ASSERT_EQ(alloc.Pool->NumSlotsUsed, 0);
 
     std::vector<int, decltype(alloc)> v1(alloc);
     v1.reserve(1);
     v1.push_back(1);
 
-    ASSERT_EQ(alloc.Pool.NumSlotsUsed, 1);
+    ASSERT_EQ(alloc.Pool->NumSlotsUsed, 1);
 
     std::vector<int, decltype(alloc)> v2(alloc);
     v2.reserve(1);
     v2.push_back(2);
 
-    ASSERT_EQ(alloc.Pool.NumSlotsUsed, 2);
+    ASSERT_EQ(alloc.Pool->NumSlotsUsed, 2);
 
     ASSERT_EQ(v1[0], 1);
     ASSERT_EQ(v2[0], 2);
@@ -110,3 +111,56 @@ TEST_F(PoolAllocatorTest, Share_2) {
   ASSERT_EQ(pool.NumSlotsUsed, 0);
   ASSERT_STREQ(pool.ValidateEmptyStateAndReturnError(), nullptr);
 }
+
+TEST_F(PoolAllocatorTest, MallocFallbackCountShared) {
+  using AllocConfig = PoolAllocatorConfig<int, sizeof(int) * 16, 1, true>;
+  auto pool = new AllocConfig::PoolType();
+  PoolAllocator<AllocConfig> alloc(*pool);
+  SharedPoolScope<AllocConfig::PoolType> scope(*pool);
+
+  // more than one slot always falls back to malloc
+  auto allocFree = [&alloc]() {
+    for (int i = 0; i < 10000; i++) {
+      alloc.deallocate(alloc.allocate(2), 2);
+    }
+  };
+  std::thread t1(allocFree);
+  std::thread t2(allocFree);
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ(pool->Stats.MallocFallbackCount, 20000);
+  delete pool;
+}
+
+TEST_F(PoolAllocatorTest, UsePinnedPool) {
+  using AllocConfig = PoolAllocatorConfig<int, sizeof(int) * 16, 1, true>;
+  auto pool = new AllocConfig::PoolType();
+  PoolAllocator<AllocConfig> alloc(*pool);
+  pool->Shared = true;
+
+  int *p = alloc.allocate(1);
+  MESSAGE() << "Pool in use is kept\n";
+  ASSERT_EQ(usePinnedPool(pool, alloc, -1), PinnedMemory::Default);
+  ASSERT_EQ(alloc.Pool, pool);
+  alloc.deallocate(p, 1);
+
+  {
+    MESSAGE() << "Pool in a SharedPoolScope is kept\n";
+    SharedPoolScope<AllocConfig::PoolType> scope(*pool);
+    ASSERT_EQ(usePinnedPool(pool, alloc, -1), PinnedMemory::Default);
+    ASSERT_EQ(alloc.Pool, pool);
+  }
+
+  auto backing = usePinnedPool(pool, alloc, -1);
+  ASSERT_GE(backing, PinnedMemory::Default);
+  ASSERT_EQ(pool->MemoryBacking, backing);
+  ASSERT_EQ(alloc.Pool, pool);
+  ASSERT_TRUE(pool->Shared);
+
+  p = alloc.allocate(1);
+  ASSERT_TRUE(pool->Contains(p));
+  alloc.deallocate(p, 1);
+  ASSERT_STREQ(pool->ValidateEmptyStateAndReturnError(), nullptr);
+  AllocConfig::PoolType::DestroyPinned(pool);
+}
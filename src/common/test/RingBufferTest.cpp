@@ -1,6 +1,7 @@
 /** Copyright (C) 2016, 2017 European Spallation Source ERIC */
 
 #include <common/RingBuffer.h>
+#include <vector>
 #include <test/TestBase.h>
 
 class RingBufferTest : public TestBase {
@@ -85,6 +86,110 @@ TEST_F(RingBufferTest, OverWriteNext) {
   ASSERT_FALSE(buf.verifyBufferCookies(index));
 }
 
+TEST_F(RingBufferTest, AcquireCommitRelease) {
+  RingBuffer<9000> buf(2);
+  ASSERT_EQ(buf.acquire(), 1);
+  ASSERT_EQ(buf.acquire(), 1); // already owned by producer
+  buf.commit();
+  ASSERT_EQ(buf.acquire(), 1);
+  buf.commit();
+  ASSERT_EQ(buf.getDataIndex(), 0);
+  ASSERT_EQ(buf.getOverruns(), 0);
+
+  MESSAGE() << "Consumer still owns buffer 0\n";
+  ASSERT_EQ(buf.acquire(), 0);
+  ASSERT_EQ(buf.getOverruns(), 1);
+
+  buf.release(0);
+  ASSERT_EQ(buf.acquire(), 1);
+  ASSERT_EQ(buf.getOverruns(), 1);
+}
+
+TEST_F(RingBufferTest, AcquireMultiple) {
+  RingBuffer<9000> buf(10);
+  ASSERT_EQ(buf.acquire(4), 4);
+  for (int i = 0; i < 4; i++) {
+    buf.commit();
+  }
+  buf.release(2);
+
+  ASSERT_EQ(buf.acquire(100), 6); // does not wrap
+  for (int i = 0; i < 6; i++) {
+    buf.commit();
+  }
+  ASSERT_EQ(buf.getDataIndex(), 0);
+  ASSERT_EQ(buf.acquire(4), 0); // buffer 0 not released
+  buf.release(0);
+  buf.release(1);
+  ASSERT_EQ(buf.acquire(4), 3); // stops at buffer 3
+  ASSERT_EQ(buf.getOverruns(), 1);
+}
+
+TEST_F(RingBufferTest, OverrunCountedOnce) {
+  RingBuffer<9000> buf(2);
+  ASSERT_EQ(buf.acquire(2), 2);
+  buf.commit();
+  buf.commit();
+
+  MESSAGE() << "Producer retries while the Consumer owns buffer 0\n";
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(buf.acquire(), 0);
+  }
+  ASSERT_EQ(buf.getOverruns(), 1);
+
+  buf.release(0);
+  ASSERT_EQ(buf.acquire(), 1);
+  buf.commit();
+  ASSERT_EQ(buf.acquire(), 0); // buffer 1 not released, new overrun
+  ASSERT_EQ(buf.acquire(), 0);
+  ASSERT_EQ(buf.getOverruns(), 2);
+}
+
+/// records the tokens of released data views
+class TestDataOwner : public RingBufferDataOwner {
+public:
+  void releaseData(uint32_t Token) override { Released.push_back(Token); }
+  std::vector<uint32_t> Released;
+};
+
+TEST_F(RingBufferTest, DataView) {
+  RingBuffer<9000> buf(4);
+  TestDataOwner Owner;
+  char External[100];
+
+  ASSERT_EQ(buf.acquire(2), 2);
+  buf.setDataView(0, External, 100, &Owner, 7);
+  ASSERT_EQ(buf.getDataBuffer(0), External);
+  ASSERT_EQ(buf.getDataLength(0), 100);
+  buf.commit();
+
+  MESSAGE() << "Acquired slot is reused, old view is handed back\n";
+  buf.setDataView(1, External + 10, 50, &Owner, 8);
+  buf.setDataView(1, External + 20, 50, &Owner, 9);
+  ASSERT_EQ(Owner.Released, std::vector<uint32_t>({8}));
+  buf.discard(1);
+  ASSERT_EQ(Owner.Released, std::vector<uint32_t>({8, 9}));
+  ASSERT_NE(buf.getDataBuffer(1), External + 20);
+
+  buf.release(0);
+  ASSERT_EQ(Owner.Released, std::vector<uint32_t>({8, 9, 7}));
+  ASSERT_NE(buf.getDataBuffer(0), External);
+  buf.release(0); // no view, nothing handed back
+  ASSERT_EQ(Owner.Released.size(), 3);
+}
+
+TEST_F(RingBufferTest, PinnedMemory) {
+  RingBuffer<9000> buf(100, true);
+  ASSERT_EQ(buf.getMaxElements(), 100);
+  ASSERT_GE(buf.getBacking(), PinnedMemory::Default);
+  ASSERT_LE(buf.getBacking(), PinnedMemory::HugePages);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(buf.verifyBufferCookies(i));
+    std::fill_n(buf.getDataBuffer(i), 9000, 0xff);
+    ASSERT_TRUE(buf.verifyBufferCookies(i));
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
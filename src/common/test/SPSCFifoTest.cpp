@@ -0,0 +1,115 @@
+/** Copyright (C) 2021 European Spallation Source ERIC */
+
+#include <common/SPSCFifo.h>
+#include <test/TestBase.h>
+#include <thread>
+
+template <typename T> class SPSCFifoTest : public TestBase {
+protected:
+  T Fifo;
+};
+
+using FifoTypes = ::testing::Types<
+    memory_sequential_consistent::CircularFifo<unsigned int, 100>,
+    memory_relaxed_aquire_release::CircularFifo<unsigned int, 100>>;
+TYPED_TEST_SUITE(SPSCFifoTest, FifoTypes);
+
+TYPED_TEST(SPSCFifoTest, Constructor) {
+  auto &Fifo = this->Fifo;
+  ASSERT_TRUE(Fifo.wasEmpty());
+  ASSERT_FALSE(Fifo.wasFull());
+  ASSERT_TRUE(Fifo.isLockFree());
+}
+
+TYPED_TEST(SPSCFifoTest, PushPopOrder) {
+  auto &Fifo = this->Fifo;
+  unsigned int Value;
+  ASSERT_FALSE(Fifo.pop(Value));
+  for (unsigned int i = 0; i < 100; i++) {
+    ASSERT_TRUE(Fifo.push(i));
+  }
+  ASSERT_TRUE(Fifo.wasFull());
+  ASSERT_FALSE(Fifo.push(100));
+
+  for (unsigned int i = 0; i < 100; i++) {
+    ASSERT_TRUE(Fifo.pop(Value));
+    ASSERT_EQ(Value, i);
+  }
+  ASSERT_TRUE(Fifo.wasEmpty());
+  ASSERT_FALSE(Fifo.pop(Value));
+}
+
+TYPED_TEST(SPSCFifoTest, ProducerConsumerThreads) {
+  auto &Fifo = this->Fifo;
+  const unsigned int Elements{100000};
+
+  std::thread Producer([&Fifo]() {
+    for (unsigned int i = 0; i < Elements; i++) {
+      while (not Fifo.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  unsigned int Value;
+  for (unsigned int i = 0; i < Elements; i++) {
+    while (not Fifo.pop(Value)) {
+      std::this_thread::yield();
+    }
+    ASSERT_EQ(Value, i);
+  }
+  Producer.join();
+  ASSERT_TRUE(Fifo.wasEmpty());
+}
+
+class SPSCFifoBatchTest : public TestBase {
+protected:
+  memory_relaxed_aquire_release::CircularFifo<unsigned int, 100> Fifo;
+  unsigned int Data[200];
+  void SetUp() override {
+    for (unsigned int i = 0; i < 200; i++) {
+      Data[i] = i;
+    }
+  }
+};
+
+TEST_F(SPSCFifoBatchTest, Free) {
+  ASSERT_EQ(Fifo.free(), 100);
+  Fifo.push(1);
+  ASSERT_EQ(Fifo.free(), 99);
+}
+
+TEST_F(SPSCFifoBatchTest, PushBatchUntilFull) {
+  ASSERT_EQ(Fifo.push_batch(Data, 60), 60);
+  ASSERT_EQ(Fifo.push_batch(Data + 60, 60), 40);
+  ASSERT_TRUE(Fifo.wasFull());
+  ASSERT_EQ(Fifo.push_batch(Data, 1), 0);
+
+  unsigned int Value;
+  for (unsigned int i = 0; i < 100; i++) {
+    ASSERT_TRUE(Fifo.pop(Value));
+    ASSERT_EQ(Value, i);
+  }
+}
+
+TEST_F(SPSCFifoBatchTest, PopBatchWrap) {
+  unsigned int Out[200];
+  // Move head and tail close to the end of the array
+  ASSERT_EQ(Fifo.push_batch(Data, 90), 90);
+  ASSERT_EQ(Fifo.pop_batch(Out, 200), 90);
+  ASSERT_EQ(Fifo.pop_batch(Out, 200), 0);
+
+  ASSERT_EQ(Fifo.push_batch(Data, 50), 50);
+  ASSERT_TRUE(Fifo.push(50));
+  ASSERT_EQ(Fifo.pop_batch(Out, 20), 20);
+  ASSERT_EQ(Fifo.pop_batch(Out + 20, 200), 31);
+  for (unsigned int i = 0; i < 51; i++) {
+    ASSERT_EQ(Out[i], i);
+  }
+  ASSERT_TRUE(Fifo.wasEmpty());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -118,6 +118,64 @@ TEST_F(SocketTest, MultiCastSetReceive) {
   ASSERT_NO_THROW(udpsocket.setLocalSocket("224.1.2.1", 9729));
 }
 
+TEST_F(SocketTest, ReceiveBatch) {
+  char DummyData[] {0x01, 0x02, 0x03, 0x04, 0x05};
+  Socket::Endpoint local("127.0.0.1", 13242);
+  Socket::Endpoint remote("127.0.0.1", 13243);
+  UDPReceiver Receiver(remote);
+  Receiver.setRecvTimeout(0, 100000);
+  UDPTransmitter Xmitter(local, remote);
+
+  for (int i = 1; i <= 5; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, i), i);
+  }
+
+  RingBuffer<9000> Ring(100);
+  int Packets = 0;
+  while (Packets < 5) {
+    int Res = Receiver.receiveBatch(Ring, 16);
+    ASSERT_GT(Res, 0);
+    for (int i = 0; i < Res; i++) {
+      unsigned int Index = Ring.getDataIndex();
+      Packets++;
+      ASSERT_EQ(Ring.getDataLength(Index), Packets);
+      ASSERT_EQ(Ring.getDataBuffer(Index)[Packets - 1], Packets);
+      Ring.getNextBuffer();
+    }
+  }
+  // Nothing more to receive - times out
+  ASSERT_EQ(Receiver.receiveBatch(Ring, 16), 0);
+}
+
+TEST_F(SocketTest, ReceiveBatchNoWrap) {
+  char DummyData[] {0x01, 0x02, 0x03, 0x04};
+  Socket::Endpoint local("127.0.0.1", 13244);
+  Socket::Endpoint remote("127.0.0.1", 13245);
+  UDPReceiver Receiver(remote);
+  Receiver.setRecvTimeout(0, 100000);
+  UDPTransmitter Xmitter(local, remote);
+
+  RingBuffer<9000> Ring(3);
+  Ring.getNextBuffer();
+  Ring.getNextBuffer();
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(Xmitter.send(DummyData, sizeof(DummyData)), sizeof(DummyData));
+  }
+  usleep(10000);
+
+  // Only one buffer left before the ring wraps
+  ASSERT_EQ(Receiver.receiveBatch(Ring, 16), 1);
+  ASSERT_EQ(Ring.getDataLength(2), sizeof(DummyData));
+}
+
+TEST_F(SocketTest, ReusePort) {
+  Socket::Endpoint local("127.0.0.1", 13246);
+  UDPReceiver Receiver1(local, true);
+  ASSERT_NO_THROW(UDPReceiver Receiver2(local, true));
+  ASSERT_THROW(UDPReceiver Receiver3(local), std::runtime_error);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -154,6 +154,24 @@ int main(int argc, char *argv[]) {
   mainStats.setPrefix(DetectorSettings.GraphitePrefix, DetectorSettings.GraphiteRegion);
   mainStats.create("main.uptime", statUpTime);
 
+  if (detector and not detector->receiversSupported()) {
+    LOG(MAIN, Sev::Error, "Detector {} does not support --rxthreads {}",
+        DetectorName, DetectorSettings.ReceiverThreads);
+    LOG(MAIN, Sev::Error, "exiting...");
+    detector.reset(); //De-allocate detector before we unload detector module
+    EmptyGraylogMessageQueue();
+    return -1;
+  }
+
+  if (detector and not detector->rxInterfaceSupported()) {
+    LOG(MAIN, Sev::Error, "Detector {} does not support --rxinterface {}",
+        DetectorName, DetectorSettings.PacketMmapInterface);
+    LOG(MAIN, Sev::Error, "exiting...");
+    detector.reset(); //De-allocate detector before we unload detector module
+    EmptyGraylogMessageQueue();
+    return -1;
+  }
+
   LOG(MAIN, Sev::Info, "Starting Event Formation Unit");
   LOG(MAIN, Sev::Info, "Event Formation Unit version: {}", efu_version());
   LOG(MAIN, Sev::Info, "Event Formation Unit build: {}", efu_buildstr());
@@ -17,7 +17,9 @@ struct Counters {
   int64_t RxBytes;
   int64_t FifoPushErrors;
   int64_t RxIdle;
-  int64_t PaddingFor64ByteAlignment[4]; // cppcheck-suppress unusedStructMember
+  int64_t RingOverruns;
+  int64_t KernelDrops;
+  int64_t PaddingFor64ByteAlignment[2]; // cppcheck-suppress unusedStructMember
 
   // Processing Counters - accessed in processing thread
   int64_t FifoSeqErrors;
@@ -38,7 +40,7 @@ struct Counters {
   int64_t ErrorBytes;
 
   //
-  int64_t ProcessingIdle;
+  int64_t RxMemoryBacking;
   int64_t Events;
   int64_t EventsUdder;
   int64_t MappingErrors;
@@ -13,6 +13,13 @@
 static Jalousie::DreamSettings LocalDreamSettings;
 
 void SetCLIArguments(CLI::App __attribute__((unused)) & parser) {
+  parser.add_flag("!--no_pixel_lut", LocalDreamSettings.PixelLookup,
+                  "Calculate pixels from the geometry (else use lookup table)")
+                  ->group("DREAM");
+
+  parser.add_option("--workers", LocalDreamSettings.Workers,
+                    "Threads for pixel calculations (0: use processing thread)")
+                    ->group("DREAM");
 }
 
 PopulateCLIParser PopulateParser{SetCLIArguments};
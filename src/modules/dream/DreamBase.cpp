@@ -9,6 +9,7 @@
 #include "DreamBase.h"
 
 #include <cinttypes>
+#include <cstring>
 #include <common/EFUArgs.h>
 #include <common/Log.h>
 #include <common/monitor/HistogramSerializer.h>
@@ -32,7 +33,11 @@ namespace Jalousie {
 const char *classname = "DREAM detector with ESS readout";
 
 DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDreamSettings)
-    : Detector("Dream", Settings), DreamModuleSettings(LocalDreamSettings) {
+    : InputDetector("Dream", Settings), DreamModuleSettings(LocalDreamSettings) {
+
+  // one input thread per receiver, see inputThread()
+  enableReceivers();
+  PacketMmapSupported = true;
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -42,6 +47,8 @@ DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDr
   Stats.create("receive.bytes", Counters.RxBytes);
   Stats.create("receive.dropped", Counters.FifoPushErrors);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
+  Stats.create("receive.ring_overruns", Counters.RingOverruns);
+  Stats.create("receive.kernel_drops", Counters.KernelDrops);
 
   // ESS Readout
   Stats.create("readouts.error_buffer", Counters.ErrorBuffer);
@@ -62,7 +69,11 @@ DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDr
 
   //
   Stats.create("thread.input_idle", Counters.RxIdle);
-  Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin", ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield", ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause", ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep", ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing", Counters.RxMemoryBacking);
 
   Stats.create("events.count", Counters.Events);
   Stats.create("events.udder", Counters.EventsUdder);
@@ -72,6 +83,18 @@ DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDr
 
   Stats.create("transmit.bytes", Counters.TxBytes);
 
+  PipelineWorkers = DreamModuleSettings.Workers;
+  if (PipelineWorkers > DreamPipeline::MaxWorkers) {
+    PipelineWorkers = DreamPipeline::MaxWorkers;
+  }
+  for (unsigned int Worker = 0; Worker < PipelineWorkers; Worker++) {
+    std::string Name = "pipeline.worker" + std::to_string(Worker) + ".";
+    Stats.create(Name + "sections", PipelineStats[Worker].Sections);
+    Stats.create(Name + "readouts", PipelineStats[Worker].Readouts);
+    Stats.create(Name + "events", PipelineStats[Worker].Events);
+    Stats.create(Name + "queue_depth", PipelineStats[Worker].QueueDepth);
+  }
+
   /// \todo below stats are common to all detectors and could/should be moved
   Stats.create("kafka.produce_fails", Counters.kafka_produce_fails);
   Stats.create("kafka.ev_errors", Counters.kafka_ev_errors);
@@ -79,9 +102,15 @@ DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDr
   Stats.create("kafka.dr_errors", Counters.kafka_dr_errors);
   Stats.create("kafka.dr_others", Counters.kafka_dr_noerrors);
   // clang-format on
-
-  std::function<void()> inputFunc = [this]() { DreamBase::inputThread(); };
-  Detector::AddThreadFunction(inputFunc, "input");
+  Counters.RxMemoryBacking = rxMemoryBacking(); // 2 is huge pages
+
+  for (unsigned int Receiver = 0; Receiver < receivers(); Receiver++) {
+    std::function<void()> inputFunc = [this, Receiver]() {
+      DreamBase::inputThread(Receiver);
+    };
+    std::string Name = (Receiver == 0) ? "input" : "input_" + std::to_string(Receiver);
+    Detector::AddThreadFunction(inputFunc, Name);
+  }
 
   std::function<void()> processingFunc = [this]() {
     DreamBase::processingThread();
@@ -93,43 +122,86 @@ DreamBase::DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDr
 }
 
 
-void DreamBase::inputThread() {
-  /** Connection setup */
-  Socket::Endpoint local(EFUSettings.DetectorAddress.c_str(),
-                         EFUSettings.DetectorPort);
+void DreamBase::inputThread(unsigned int Receiver) {
+  if (not EFUSettings.PacketMmapInterface.empty()) {
+    packetMmapReceiveLoop(Receiver);
+  } else {
+    /** Connection setup */
+    Socket::Endpoint local(EFUSettings.DetectorAddress.c_str(),
+                           EFUSettings.DetectorPort);
+
+    UDPReceiver dataReceiver(local, receivers() > 1);
+    dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
+                                EFUSettings.RxSocketBufferSize);
+    dataReceiver.printBufferSizes();
+    dataReceiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
+    receiveLoop(dataReceiver, Receiver);
+  }
+  XTRACE(INPUT, ALW, "Stopping input thread.");
+}
 
-  UDPReceiver dataReceiver(local);
-  dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
-                              EFUSettings.RxSocketBufferSize);
-  dataReceiver.printBufferSizes();
-  dataReceiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
+void DreamBase::receiveLoop(UDPReceiver &dataReceiver, unsigned int Receiver) {
+  auto &Fifo = inputFifo(Receiver);
+  auto &Ringbuffer = rxRingbuffer(Receiver);
+  auto &RxStats = RxCounters[Receiver];
 
   while (runThreads) {
+    if (EFUSettings.ReceiveBatchSize > 1) {
+      receiveBatch(dataReceiver, Receiver);
+      continue;
+    }
+
     int readSize;
 
-    unsigned int rxBufferIndex = RxRingbuffer.getDataIndex();
+    unsigned int rxBufferIndex = Ringbuffer.getDataIndex();
+    if (Ringbuffer.acquire() == 0) { // still owned by the processing thread
+      usleep(10);
+      continue;
+    }
 
-    RxRingbuffer.setDataLength(rxBufferIndex, 0);
+    Ringbuffer.setDataLength(rxBufferIndex, 0);
 
-    if ((readSize = dataReceiver.receive(RxRingbuffer.getDataBuffer(rxBufferIndex),
-                                   RxRingbuffer.getMaxBufSize())) > 0) {
-      RxRingbuffer.setDataLength(rxBufferIndex, readSize);
+    if ((readSize = dataReceiver.receive(Ringbuffer.getDataBuffer(rxBufferIndex),
+                                   Ringbuffer.getMaxBufSize())) > 0) {
+      Ringbuffer.setDataLength(rxBufferIndex, readSize);
       XTRACE(INPUT, DEB, "Received an udp packet of length %d bytes", readSize);
-      Counters.RxPackets++;
-      Counters.RxBytes += readSize;
+      RxStats.RxPackets++;
+      RxStats.RxBytes += readSize;
 
-      if (InputFifo.push(rxBufferIndex) == false) {
-        Counters.FifoPushErrors++;
+      if (Fifo.push(rxBufferIndex) == false) {
+        RxStats.FifoPushErrors++;
       } else {
-        RxRingbuffer.getNextBuffer();
+        Ringbuffer.commit();
       }
     } else {
-      Counters.RxIdle++;
+      RxStats.RxIdle++;
     }
 
   }
-  XTRACE(INPUT, ALW, "Stopping input thread.");
-  return;
+}
+
+/// \brief copy the summed receiver counters to Counters
+void DreamBase::updateReceiveStats() {
+  auto RxSum = sumReceiverCounters();
+  Counters.RxPackets = RxSum.RxPackets;
+  Counters.RxBytes = RxSum.RxBytes;
+  Counters.FifoPushErrors = RxSum.FifoPushErrors;
+  Counters.RxIdle = RxSum.RxIdle;
+  Counters.RingOverruns = RxSum.RingOverruns;
+  Counters.KernelDrops = RxSum.KernelDrops;
+}
+
+/// \brief copy the worker stats and sum the worker instrument counters
+void DreamBase::updatePipelineCounters(DreamPipeline &Pipeline,
+                                       struct Counters *WorkerCounters) {
+  Counters.MappingErrors = 0;
+  Counters.GeometryErrors = 0;
+  for (unsigned int Worker = 0; Worker < Pipeline.workers(); Worker++) {
+    auto &WC = WorkerCounters[Worker];
+    Counters.MappingErrors += WC.MappingErrors;
+    Counters.GeometryErrors += WC.GeometryErrors;
+    PipelineStats[Worker] = Pipeline.workerStats(Worker);
+  }
 }
 
 ///
@@ -152,17 +224,45 @@ void DreamBase::processingThread() {
 
   RuntimeStat RtStat({Counters.RxPackets, Counters.Events, Counters.TxBytes});
 
+  // Each worker has its own instrument and counters, the counters are
+  // summed in the processing thread
+  struct Counters WorkerCounters[DreamPipeline::MaxWorkers];
+  memset(WorkerCounters, 0, sizeof(WorkerCounters));
+  std::unique_ptr<DreamPipeline> Pipeline;
+  if (PipelineWorkers > 0) {
+    XTRACE(INIT, ALW, "Using %u pipeline workers", PipelineWorkers);
+    auto Factory = [this, &WorkerCounters](unsigned int Worker) {
+      return std::unique_ptr<DreamInstrument>(
+          new DreamInstrument(WorkerCounters[Worker], DreamModuleSettings));
+    };
+    auto Produce = [this](uint64_t PulseTime, std::vector<ReadoutEvent> &Events) {
+      Serializer->pulseTime(PulseTime);
+      for (auto &Event : Events) {
+        Counters.TxBytes += Serializer->addEvent(Event.Time, Event.PixelId);
+      }
+      Counters.Events += Events.size();
+    };
+    Pipeline.reset(new DreamPipeline(PipelineWorkers, Factory, Produce,
+                                     1024, EFUSettings.IdleMode));
+  }
+
+  unsigned int Receiver{0};
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    // Packets from a given source always arrive on the same receiver, so
+    // per OutputQueue sequence number checks in validate() remain valid
+    if (popInputFifos(Receiver, DataIndex)) { // There is data in the FIFO - do processing
+      ProcessingIdle.reset();
+      auto &Ringbuffer = rxRingbuffer(Receiver);
+      auto DataLen = Ringbuffer.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
+        Ringbuffer.release(DataIndex);
         continue;
       }
 
       /// \todo use the Buffer<T> class here and in parser?
       /// \todo avoid copying by passing reference to stats like for gdgem?
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = Ringbuffer.getDataBuffer(DataIndex);
 
       auto Res = Dream.ESSReadoutParser.validate(DataPtr, DataLen, ReadoutParser::DREAM);
       Counters.ErrorBuffer = Dream.ESSReadoutParser.Stats.ErrorBuffer;
@@ -175,28 +275,48 @@ void DreamBase::processingThread() {
       if (Res != ReadoutParser::OK) {
         XTRACE(DATA, DEB, "Error parsing ESS readout header");
         Counters.ErrorHeaders++;
+        Ringbuffer.release(DataIndex);
         continue;
       }
       XTRACE(DATA, DEB, "PulseHigh %u, PulseLow %u",
         Dream.ESSReadoutParser.Packet.HeaderPtr->PulseHigh,
         Dream.ESSReadoutParser.Packet.HeaderPtr->PulseLow);
 
-      // We have good header information, now parse readout data
-      Res = Dream.DreamParser.parse(Dream.ESSReadoutParser.Packet.DataPtr, Dream.ESSReadoutParser.Packet.DataLength);
-
-      // Process readouts, generate (end produce) events
-      Dream.processReadouts();
+      // We have good header information, now parse readout data and
+      // process readouts, generate (end produce) events
+      auto ReadoutPtr = Dream.ESSReadoutParser.Packet.DataPtr;
+      auto ReadoutLength = Dream.ESSReadoutParser.Packet.DataLength;
+      if (Pipeline) {
+        // the pipeline outlives the buffer, so readouts are copied and the
+        // sections swapped into the pipeline
+        Res = Dream.DreamParser.parse(ReadoutPtr, ReadoutLength);
+        Pipeline->addPacket(*Dream.ESSReadoutParser.Packet.HeaderPtr,
+                            Dream.DreamParser.Result);
+        Ringbuffer.release(DataIndex);
+        Pipeline->collect();
+      } else {
+        // readouts are used in place, release the buffer when done
+        Res = Dream.DreamParser.parseViews(ReadoutPtr, ReadoutLength);
+        Dream.processReadouts();
+        Ringbuffer.release(DataIndex);
+      }
 
     } else { // There is NO data in the FIFO - do stop checks and sleep a little
-      Counters.ProcessingIdle++;
-      usleep(10);
+      if ((not Pipeline) or (Pipeline->collect() == 0)) {
+        ProcessingIdle.idle();
+      }
     }
 
     if (ProduceTimer.timetsc() >=
         EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ) {
 
+      updateReceiveStats();
       RuntimeStatusMask =  RtStat.getRuntimeStatusMask({Counters.RxPackets, Counters.Events, Counters.TxBytes});
 
+      if (Pipeline) {
+        Pipeline->flush();
+        updatePipelineCounters(*Pipeline, WorkerCounters);
+      }
       Counters.TxBytes += Serializer->produce();
 
       /// Kafka stats update - common to all detectors
@@ -210,6 +330,7 @@ void DreamBase::processingThread() {
       ProduceTimer.now();
     }
   }
+  updateReceiveStats();
   XTRACE(INPUT, ALW, "Stopping processing thread.");
   return;
 }
@@ -10,29 +10,52 @@
 
 #include <common/Detector.h>
 #include <common/EV42Serializer.h>
+#include <common/Socket.h>
 #include <dream/Counters.h>
+#include <dream/readout/DataParser.h>
+#include <readout/ReadoutPipeline.h>
 
 namespace Jalousie {
 
+class DreamInstrument;
+
+/// \brief multi threaded pixel calculations, enabled by --workers
+using DreamPipeline = ReadoutPipeline<DataParser::ParsedData, DreamInstrument>;
+
 struct DreamSettings {
   //std::string ConfigFile;
   //
   //
   //
+  bool PixelLookup{true}; ///< use the precalculated pixel id table
+  unsigned int Workers{0}; ///< pixel calculation threads, 0: processing thread
 };
 
 
 
-class DreamBase : public Detector {
+class DreamBase : public InputDetector<> {
 public:
   explicit DreamBase(BaseSettings const &Settings, struct DreamSettings &LocalDreamSettings);
   ~DreamBase() = default;
 
-  void inputThread();
+  /// \brief receive packets into the ringbuffer and fifo of Receiver
+  void inputThread(unsigned int Receiver = 0);
   void processingThread();
 
+  /// \brief receive loop for UDPReceiver, see also packetMmapReceiveLoop()
+  void receiveLoop(UDPReceiver &dataReceiver, unsigned int Receiver);
+
+  /// \brief copy the summed receiver counters to Counters
+  void updateReceiveStats();
+
+  /// \brief update Counters and PipelineStats from the pipeline workers
+  void updatePipelineCounters(DreamPipeline &Pipeline,
+                              struct Counters *WorkerCounters);
+
 protected:
   struct Counters Counters;
+  unsigned int PipelineWorkers{0}; ///< 0: no ReadoutPipeline
+  ReadoutWorkerStats PipelineStats[DreamPipeline::MaxWorkers];
   DreamSettings DreamModuleSettings;
   EV42Serializer * Serializer;
 };
@@ -21,12 +21,21 @@ namespace Jalousie {
   DreamInstrument::DreamInstrument(struct Counters & counters,
       DreamSettings &moduleSettings)
         : counters(counters)
-        , ModuleSettings(moduleSettings) { }
+        , ModuleSettings(moduleSettings) {
+    if (ModuleSettings.PixelLookup) {
+      XTRACE(INIT, ALW, "Creating pixel id lookup table");
+      PixelLookup.reset(new DreamGeometry::PixelIdLookup());
+    }
+  }
 
 
   uint32_t DreamInstrument::calcPixel(
       uint8_t Sector, uint8_t Sumo, uint8_t Strip,
       uint8_t Wire, uint8_t Cassette, uint8_t Counter) {
+    if (PixelLookup) {
+      return PixelLookup->pixel(Sector, Sumo, Strip, Wire, Cassette, Counter);
+    }
+
     DreamGeometry::EndCapParams endcap = {Sector, Sumo, Strip, Wire, Cassette, Counter};
 
     uint32_t Pixel{0};
@@ -34,6 +43,44 @@ namespace Jalousie {
     return Pixel;
   }
 
+  /// \brief calculate the events of a single Ring/FEN section, returns
+  /// false if the section doesn't match the configuration
+  bool DreamInstrument::processSection(const ReadoutParser::PacketHeaderV0 & Header,
+      const DataParser::SectionView & Section, std::vector<ReadoutEvent> & Events) {
+    XTRACE(DATA, DEB, "Ring %u, FEN %u", Section.RingId, Section.FENId);
+    Time.setReference(Header.PulseHigh, Header.PulseLow);
+
+    // if (Section.RingId >= LokiConfiguration.Panels.size()) {
+    //   XTRACE(DATA, WAR, "RINGId %d is incompatible with configuration", Section.RingId);
+    //   counters.MappingErrors++;
+    //   return false;
+    // }
+    //
+    //
+    if (Section.FENId == 0) {
+      XTRACE(DATA, WAR, "FENId == 0");
+      counters.MappingErrors++;
+      return false;
+    }
+
+    for (auto & Data : Section.Data) {
+      auto TimeOfFlight =  Time.getTOF(0, Data.Tof); // TOF in ns
+
+      XTRACE(DATA, DEB, "  Data: time (0, %u), mod %u, sumo %u, strip %u, wire %u, seg %u, ctr %u",
+        Data.Tof, Data.Module, Data.Sumo, Data.Strip, Data.Wire, Data.Segment, Data.Counter);
+
+      // Calculate pixelid and apply calibration
+      uint32_t PixelId = calcPixel(Data.Module, Data.Sumo, Data.Strip, Data.Wire, Data.Segment, Data.Counter);
+
+      if (PixelId == 0) {
+        counters.GeometryErrors++;
+      } else {
+        Events.push_back({TimeOfFlight, PixelId});
+      }
+    }
+    return true;
+  }
+
   void DreamInstrument::processReadouts() {
     // Dont fake pulse time, but could do something like
     // PulseTime = 1000000000LU * (uint64_t)time(NULL); // ns since 1970
@@ -46,38 +93,15 @@ namespace Jalousie {
     Serializer->pulseTime(PulseTime);
 
     /// Traverse readouts, calculate pixels
-    for (auto & Section : DreamParser.Result) {
-      XTRACE(DATA, DEB, "Ring %u, FEN %u", Section.RingId, Section.FENId);
-
-      // if (Section.RingId >= LokiConfiguration.Panels.size()) {
-      //   XTRACE(DATA, WAR, "RINGId %d is incompatible with configuration", Section.RingId);
-      //   counters.MappingErrors++;
-      //   continue;
-      // }
-    //
-    //
-      if (Section.FENId == 0) {
-        XTRACE(DATA, WAR, "FENId == 0");
-        counters.MappingErrors++;
+    for (auto & Section : DreamParser.Views) {
+      Events.clear();
+      if (not processSection(*PacketHeader, Section, Events)) {
         continue;
       }
 
-      for (auto & Data : Section.Data) {
-        auto TimeOfFlight =  Time.getTOF(0, Data.Tof); // TOF in ns
-
-        XTRACE(DATA, DEB, "  Data: time (0, %u), mod %u, sumo %u, strip %u, wire %u, seg %u, ctr %u",
-          Data.Tof, Data.Module, Data.Sumo, Data.Strip, Data.Wire, Data.Segment, Data.Counter);
-
-        // Calculate pixelid and apply calibration
-        uint32_t PixelId = calcPixel(Data.Module, Data.Sumo, Data.Strip, Data.Wire, Data.Segment, Data.Counter);
-
-
-        if (PixelId == 0) {
-          counters.GeometryErrors++;
-        } else {
-          counters.TxBytes += Serializer->addEvent(TimeOfFlight, PixelId);
-          counters.Events++;
-        }
+      for (auto & Event : Events) {
+        counters.TxBytes += Serializer->addEvent(Event.Time, Event.PixelId);
+        counters.Events++;
       }
     }
   }
@@ -16,6 +16,12 @@
 #include <dream/readout/DataParser.h>
 #include <modules/readout/ReadoutParser.h>
 #include <modules/readout/ESSTime.h>
+#include <readout/ReadoutPipeline.h>
+#include <memory>
+
+namespace DreamGeometry {
+class PixelIdLookup;
+}
 
 
 namespace Jalousie {
@@ -35,11 +41,24 @@ public:
   //
   void processReadouts();
 
+  /// \brief calculate events for one Ring/FEN section, used directly by
+  /// processReadouts() and by the ReadoutPipeline workers
+  bool processSection(const ReadoutParser::PacketHeaderV0 & Header,
+                      const DataParser::SectionView & Section,
+                      std::vector<ReadoutEvent> & Events);
+
+  /// \brief ReadoutPipeline version, the section owns its readouts
+  bool processSection(const ReadoutParser::PacketHeaderV0 & Header,
+                      DataParser::ParsedData & Section,
+                      std::vector<ReadoutEvent> & Events) {
+    return processSection(Header, {Section.RingId, Section.FENId, Section.Data}, Events);
+  }
 
   //
   void setSerializer(EV42Serializer * serializer) { Serializer = serializer; }
 
-  //
+  /// \brief pixel id from the lookup table if created (default), else
+  /// calculated by DreamGeometry::PixelIdFromEndCapParams()
   uint32_t calcPixel(uint8_t Sector, uint8_t Sumo, uint8_t Strip,
                      uint8_t Wire, uint8_t Cassette, uint8_t Counter);
 
@@ -51,6 +70,8 @@ public:
   DataParser DreamParser{counters};
   ESSTime Time;
   EV42Serializer * Serializer;
+  std::vector<ReadoutEvent> Events; ///< events of the current section
+  std::unique_ptr<DreamGeometry::PixelIdLookup> PixelLookup;
 };
 
 } // namespace
@@ -6,6 +6,9 @@
 /// \brief Encoder/decoder from PixelId to the physics EndCap parameters for
 ///        the DREAM detector.
 ///
+/// \brief PixelIdLookup is a dense table of PixelIdFromEndCapParams() for
+///        all combinations of EndCap parameters, built once.
+///
 /// \brief PixelIdFromEndCapParams() encodes the PixelId from EndCap parameters
 ///        The input is checked for validity and true is returned on success.
 ///
@@ -19,6 +22,7 @@
 
 #include <common/Assert.h>
 #include <stdint.h>
+#include <vector>
 
 namespace DreamGeometry {
 
@@ -344,4 +348,68 @@ bool PixelIdFromEndCapParams(EndCapParams EndCap, uint32_t &OutPixelId) {
   return true;
 }
 
+/// \brief precalculated PixelIdFromEndCapParams() for all combinations of
+/// EndCap parameters. Parameters are range checked and used as a dense
+/// index, entries for invalid combinations (cassettes not present on a
+/// SUMO) are 0, so pixel() returns 0 for all invalid parameters.
+/// The table has 471040 entries (1.8 MB).
+class PixelIdLookup {
+public:
+  enum : uint32_t {
+    Sectors = SectorCount,
+    Strips = 16,
+    Sumos = 4, // SUMO 3 - 6
+    Wires = 16,
+    Cassettes = 10, // max for SUMO 6
+    Counters = 2,
+    Entries = Sectors * Strips * Sumos * Wires * Cassettes * Counters
+  };
+
+  PixelIdLookup() : Table(Entries, 0) {
+    EndCapParams EndCap;
+    for (EndCap.Sector = 1; EndCap.Sector <= Sectors; EndCap.Sector++) {
+      for (EndCap.Strip = 1; EndCap.Strip <= Strips; EndCap.Strip++) {
+        for (EndCap.SumoId = 3; EndCap.SumoId <= 6; EndCap.SumoId++) {
+          for (EndCap.Wire = 1; EndCap.Wire <= Wires; EndCap.Wire++) {
+            for (EndCap.Cassette = 1; EndCap.Cassette <= Cassettes; EndCap.Cassette++) {
+              for (EndCap.Counter = 1; EndCap.Counter <= Counters; EndCap.Counter++) {
+                uint32_t PixelId{0};
+                PixelIdFromEndCapParams(EndCap, PixelId);
+                Table[index(EndCap.Sector - 1, EndCap.Strip - 1, EndCap.SumoId - 3,
+                            EndCap.Wire - 1, EndCap.Cassette - 1, EndCap.Counter - 1)] = PixelId;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// \brief same result as PixelIdFromEndCapParams(), 0 if invalid
+  uint32_t pixel(uint32_t Sector, uint32_t SumoId, uint32_t Strip,
+                 uint32_t Wire, uint32_t Cassette, uint32_t Counter) const {
+    // unsigned wrap around makes values below the range large
+    uint32_t SectorIdx = Sector - 1;
+    uint32_t StripIdx = Strip - 1;
+    uint32_t SumoIdx = SumoId - 3;
+    uint32_t WireIdx = Wire - 1;
+    uint32_t CassetteIdx = Cassette - 1;
+    uint32_t CounterIdx = Counter - 1;
+    if ((SectorIdx >= Sectors) | (StripIdx >= Strips) | (SumoIdx >= Sumos) |
+        (WireIdx >= Wires) | (CassetteIdx >= Cassettes) | (CounterIdx >= Counters)) {
+      return 0;
+    }
+    return Table[index(SectorIdx, StripIdx, SumoIdx, WireIdx, CassetteIdx, CounterIdx)];
+  }
+
+private:
+  static uint32_t index(uint32_t SectorIdx, uint32_t StripIdx, uint32_t SumoIdx,
+                        uint32_t WireIdx, uint32_t CassetteIdx, uint32_t CounterIdx) {
+    return ((((SectorIdx * Strips + StripIdx) * Sumos + SumoIdx) * Wires + WireIdx) *
+                Cassettes + CassetteIdx) * Counters + CounterIdx;
+  }
+
+  std::vector<uint32_t> Table;
+};
+
 } // namespace DreamGeometry
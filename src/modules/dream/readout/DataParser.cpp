@@ -19,8 +19,28 @@ constexpr unsigned int DataHeaderSize{sizeof(ReadoutParser::DataHeader)};
 constexpr unsigned int DreamReadoutSize{sizeof(DataParser::DreamReadout)};
 
 // Assume we start after the PacketHeader
+// Sections already in Result are overwritten in place so the capacity of
+// their readout vectors is reused instead of reallocated for every packet
 int DataParser::parse(const char *Buffer, unsigned int Size) {
-  Result.clear();
+  int ParsedReadouts = parseViews(Buffer, Size);
+  if (Result.size() > Views.size()) {
+    Result.resize(Views.size());
+  }
+  for (size_t i = 0; i < Views.size(); i++) {
+    auto & View = Views[i];
+    if (i == Result.size()) {
+      Result.push_back({View.RingId, View.FENId, {}});
+    }
+    Result[i].RingId = View.RingId;
+    Result[i].FENId = View.FENId;
+    Result[i].Data.assign(View.Data.begin(), View.Data.end());
+  }
+  return ParsedReadouts;
+}
+
+// Assume we start after the PacketHeader
+int DataParser::parseViews(const char *Buffer, unsigned int Size) {
+  Views.clear();
   unsigned int ParsedReadouts = 0;
 
   unsigned int BytesLeft = Size;
@@ -64,26 +84,12 @@ int DataParser::parse(const char *Buffer, unsigned int Size) {
       return ParsedReadouts;
     }
 
-    ParsedData CurrentDataSection;
-    CurrentDataSection.RingId = DataHdrPtr->RingId;
-    CurrentDataSection.FENId = DataHdrPtr->FENId;
-
-    // Loop through data here
     auto ReadoutsInDataSection = (DataHdrPtr->DataLength - DataHeaderSize) / DreamReadoutSize;
-    for (unsigned int i = 0; i < ReadoutsInDataSection; i++) {
-      auto Data = (DreamReadout *)((char *)DataHdrPtr + DataHeaderSize +
-                                  i * DreamReadoutSize);
-      // XTRACE(DATA, DEB, "%3u: ring %u, fen %u, t(%11u,%11u) SeqNo %6u TubeId %3u , A 0x%04x B "
-      //                   "0x%04x C 0x%04x D 0x%04x",
-      //        i, DataHdrPtr->RingId, DataHdrPtr->FENId,
-      //        Data->TimeHigh, Data->TimeLow, Data->DataSeqNum, Data->TubeId, Data->AmpA,
-      //        Data->AmpB, Data->AmpC, Data->AmpD);
-
-      CurrentDataSection.Data.push_back(*Data);
-      ParsedReadouts++;
-      Stats.Readouts++;
-    }
-    Result.push_back(CurrentDataSection);
+    auto FirstReadout = (const char *)DataHdrPtr + DataHeaderSize;
+    ParsedReadouts += ReadoutsInDataSection;
+    Stats.Readouts += ReadoutsInDataSection;
+    Views.push_back({DataHdrPtr->RingId, DataHdrPtr->FENId,
+                     {(const DreamReadout *)FirstReadout, ReadoutsInDataSection}});
     BytesLeft -= DataHdrPtr->DataLength;
     DataPtr += DataHdrPtr->DataLength;
   }
@@ -11,6 +11,8 @@
 #include <readout/ReadoutParser.h>
 #include <dream/Counters.h>
 #include <vector>
+#include <stdexcept> // needed by span.hpp
+#include <common/span.hpp>
 
 namespace Jalousie {
 
@@ -36,12 +38,18 @@ public:
 
   DataParser(struct Counters & counters) : Stats(counters){
     Result.reserve(MaxReadoutsInPacket);
+    Views.reserve(MaxReadoutsInPacket);
   };
   ~DataParser(){};
 
-  //
+  /// \brief parse into Result, readouts are copied so Result stays valid
+  /// after the buffer is reused
   int parse(const char *buffer, unsigned int size);
 
+  /// \brief parse into Views, no readouts are copied so Views are only
+  /// valid as long as the buffer is
+  int parseViews(const char *buffer, unsigned int size);
+
   //
   struct ParsedData {
     uint8_t RingId;
@@ -49,8 +57,16 @@ public:
     std::vector<DreamReadout> Data;
   };
 
+  /// \brief a Ring/FEN section referring to the readouts in the buffer
+  struct SectionView {
+    uint8_t RingId;
+    uint8_t FENId;
+    nonstd::span<const DreamReadout> Data;
+  };
+
   // To be iterated over in processing thread
   std::vector<struct ParsedData> Result;
+  std::vector<struct SectionView> Views;
 
   struct Counters & Stats;
 };
@@ -91,6 +91,19 @@ TEST_F(DataParserTest, ParseThree) {
   ASSERT_EQ(Parser.Result.size(), 1);
 }
 
+TEST_F(DataParserTest, ParseViews) {
+  auto Res = Parser.parseViews((char *)&OkThreeDreamReadouts[0],
+                               OkThreeDreamReadouts.size());
+  ASSERT_EQ(Res, 3);
+  ASSERT_EQ(Parser.Stats.Readouts, 3);
+  ASSERT_EQ(Parser.Stats.Headers, 1);
+  ASSERT_EQ(Parser.Result.size(), 0);
+  ASSERT_EQ(Parser.Views.size(), 1);
+  ASSERT_EQ(Parser.Views[0].Data.size(), 3);
+  ASSERT_EQ((char *)Parser.Views[0].Data.data(),
+            (char *)&OkThreeDreamReadouts[4]);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -44,4 +44,56 @@ static void DreamDecode_Bulk(benchmark::State &state) {
 }
 BENCHMARK(DreamDecode_Bulk);
 
+/// \brief encode a slice (all strips, wires and counters) for each
+/// sector, sumo and cassette
+template <typename EncodeFunc> uint32_t encodeAll(EncodeFunc Encode) {
+  uint32_t Pixels{0};
+  for (uint32_t Sector = 1; Sector <= SectorCount; Sector++) {
+    for (uint32_t SumoId = 3; SumoId <= 6; SumoId++) {
+      for (uint32_t Cassette = 1; Cassette <= SumoCassetteCount[SumoId]; Cassette++) {
+        for (uint32_t Strip = 1; Strip <= 16; Strip++) {
+          for (uint32_t Wire = 1; Wire <= 16; Wire++) {
+            for (uint32_t Counter = 1; Counter <= 2; Counter++) {
+              uint32_t PixelId = Encode(Sector, SumoId, Strip, Wire, Cassette, Counter);
+              ::benchmark::DoNotOptimize(PixelId);
+              Pixels++;
+            }
+          }
+        }
+      }
+    }
+  }
+  return Pixels;
+}
+
+static void DreamEncode(benchmark::State &state) {
+  uint32_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    Total += encodeAll([](uint32_t Sector, uint32_t SumoId, uint32_t Strip,
+                          uint32_t Wire, uint32_t Cassette, uint32_t Counter) {
+      EndCapParams EndCap{Sector, SumoId, Strip, Wire, Cassette, Counter};
+      uint32_t PixelId{0};
+      PixelIdFromEndCapParams(EndCap, PixelId);
+      return PixelId;
+    });
+  });
+  state.SetItemsProcessed(Total);
+  state.SetBytesProcessed(Total * sizeof(EndCapParams));
+}
+BENCHMARK(DreamEncode);
+
+static void DreamEncode_Lookup(benchmark::State &state) {
+  PixelIdLookup Lookup;
+  uint32_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    Total += encodeAll([&Lookup](uint32_t Sector, uint32_t SumoId, uint32_t Strip,
+                                 uint32_t Wire, uint32_t Cassette, uint32_t Counter) {
+      return Lookup.pixel(Sector, SumoId, Strip, Wire, Cassette, Counter);
+    });
+  });
+  state.SetItemsProcessed(Total);
+  state.SetBytesProcessed(Total * sizeof(EndCapParams));
+}
+BENCHMARK(DreamEncode_Lookup);
+
 BENCHMARK_MAIN();
@@ -1152,6 +1152,33 @@ TEST_F(DreamGeometryTest, EncodeDecodeAllPixels) {
   ASSERT_EQ(VisitedPixels.count(), DreamGeometry::TotalPixels);
 }
 
+// the lookup table must give exactly the same pixels as the calculation,
+// including 0 for invalid parameters just outside the valid ranges
+TEST_F(DreamGeometryTest, PixelIdLookupSameAsCalculated) {
+  PixelIdLookup Lookup;
+  uint32_t Valid{0};
+  for (uint32_t Sector = 0; Sector <= DreamGeometry::SectorCount + 1; Sector++) {
+    for (uint32_t SumoId = 2; SumoId <= 7; SumoId++) {
+      for (uint32_t Strip = 0; Strip <= 17; Strip++) {
+        for (uint32_t Wire = 0; Wire <= 17; Wire++) {
+          for (uint32_t Cassette = 0; Cassette <= 11; Cassette++) {
+            for (uint32_t Counter = 0; Counter <= 3; Counter++) {
+              EndCapParams EndCap{Sector, SumoId, Strip, Wire, Cassette, Counter};
+              uint32_t PixelId{0};
+              if (PixelIdFromEndCapParams(EndCap, PixelId)) {
+                Valid++;
+              }
+              ASSERT_EQ(Lookup.pixel(Sector, SumoId, Strip, Wire, Cassette, Counter),
+                        PixelId);
+            }
+          }
+        }
+      }
+    }
+  }
+  ASSERT_EQ(Valid, DreamGeometry::TotalPixels);
+}
+
 // this tests that test-only asserts assert
 TEST_F(DreamGeometryTest, SlicePixelFromPixelId_TestEnvInput) {
   ASSERT_DEATH({ SlicePixelFromPixelId(0); }, "Bad PixelId");
@@ -34,6 +34,25 @@ TEST_F(DreamInstrumentTest, CalcPixel) {
   ASSERT_EQ(Dream.calcPixel(1, 6, 1, 16, 10, 2), 1);
 }
 
+TEST_F(DreamInstrumentTest, ProcessSection) {
+  DreamInstrument Dream(counters, ModuleSettings);
+  ReadoutParser::PacketHeaderV0 Header{};
+  std::vector<ReadoutEvent> Events;
+
+  DataParser::ParsedData BadFEN{0, 0, {}};
+  ASSERT_FALSE(Dream.processSection(Header, BadFEN, Events));
+  ASSERT_EQ(counters.MappingErrors, 1);
+
+  DataParser::ParsedData Valid{0, 1, {}};
+  Valid.Data.push_back({0, 0, 1, 6, 1, 16, 10, 2});
+  Valid.Data.push_back({0, 0, 0, 0, 0, 0, 0, 0});
+  ASSERT_TRUE(Dream.processSection(Header, Valid, Events));
+  ASSERT_EQ(counters.MappingErrors, 1);
+  ASSERT_EQ(counters.GeometryErrors, 1);
+  ASSERT_EQ(Events.size(), 1);
+  ASSERT_EQ(Events[0].PixelId, 1);
+}
+
 
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
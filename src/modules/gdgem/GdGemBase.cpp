@@ -62,7 +62,7 @@ int GdGemBase::getCalibration(std::vector<std::string> CmdArgs,
 }
 
 GdGemBase::GdGemBase(BaseSettings const &Settings, struct NMXSettings &LocalSettings) :
-       Detector("NMX", Settings), NMXSettings(LocalSettings) {
+       InputDetector("NMX", Settings), NMXSettings(LocalSettings) {
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -78,6 +78,7 @@ GdGemBase::GdGemBase(BaseSettings const &Settings, struct NMXSettings &LocalSett
 
   Stats.create("thread.input_idle", stats_.RxIdle);
   Stats.create("thread.processing_idle", stats_.ProcessingIdle);
+  Stats.create("memory.rx_backing", stats_.RxMemoryBacking);
 
   // Parser
   Stats.create("readouts.good_frames", stats_.ParserGoodFrames);
@@ -127,19 +128,27 @@ GdGemBase::GdGemBase(BaseSettings const &Settings, struct NMXSettings &LocalSett
   Stats.create("kafka.dr_errors", stats_.KafkaDrErrors);
   Stats.create("kafka.dr_others", stats_.KafkaDrNoErrors);
 
+  if (EFUSettings.HugePages) {
+    HitVectorStorage::pin(EFUSettings.NumaNode);
+    ClusterPoolStorage::pin(EFUSettings.NumaNode);
+  }
+
   Stats.create("memory.hitvec_storage.alloc_count", HitVectorStorage::Pool->Stats.AllocCount);
   Stats.create("memory.hitvec_storage.alloc_bytes", HitVectorStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.hitvec_storage.dealloc_count", HitVectorStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.hitvec_storage.dealloc_bytes", HitVectorStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.hitvec_storage.malloc_fallback_count", HitVectorStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.hitvec_storage.backing", HitVectorStorage::Pool->MemoryBacking);
 
   Stats.create("memory.cluster_storage.alloc_count", ClusterPoolStorage::Pool->Stats.AllocCount);
   Stats.create("memory.cluster_storage.alloc_bytes", ClusterPoolStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.cluster_storage.dealloc_count", ClusterPoolStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.cluster_storage.dealloc_bytes", ClusterPoolStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.cluster_storage.malloc_fallback_count", ClusterPoolStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.cluster_storage.backing", ClusterPoolStorage::Pool->MemoryBacking);
 
   // clang-format on
+  stats_.RxMemoryBacking = rxMemoryBacking(); // 2 is huge pages
 
   if (!NMXSettings.FilePrefix.empty())
     LOG(INIT, Sev::Info, "Dump h5 data in path: {}",
@@ -240,22 +249,28 @@ void GdGemBase::applyConfiguration() {
     LOG(INIT, Sev::Error, "Unrecognized builder type in config");
   }
 
-  clusterer_x_ = std::make_shared<GapClusterer>(
+  auto clusterer_x = std::make_shared<GapClusterer>(
       NMXOpts.clusterer_x.max_time_gap, NMXOpts.clusterer_x.max_strip_gap);
-  clusterer_y_ = std::make_shared<GapClusterer>(
+  auto clusterer_y = std::make_shared<GapClusterer>(
       NMXOpts.clusterer_y.max_time_gap, NMXOpts.clusterer_y.max_strip_gap);
+  clusterer_x->set_sort_method(NMXOpts.clusterer_sort);
+  clusterer_y->set_sort_method(NMXOpts.clusterer_sort);
+  clusterer_x_ = clusterer_x;
+  clusterer_y_ = clusterer_y;
 
   if(NMXOpts.matcher_name == "CenterMatcher") {
     auto Matcher = std::make_shared<CenterMatcher>(
         NMXOpts.time_config.acquisition_window()*5, 0, 1);
     Matcher->set_max_delta_time(NMXOpts.matcher_max_delta_time);
     Matcher->set_time_algorithm(NMXOpts.time_algorithm);
+    Matcher->set_ordered_queue(NMXOpts.matcher_ordered_queue);
     matcher_ = Matcher;
   }
   else {
     auto Matcher = std::make_shared<GapMatcher>(
         NMXOpts.time_config.acquisition_window()*5, 0, 1);
     Matcher->set_minimum_time_gap(NMXOpts.matcher_max_delta_time);
+    Matcher->set_ordered_queue(NMXOpts.matcher_ordered_queue);
     matcher_ = Matcher;
   }
 
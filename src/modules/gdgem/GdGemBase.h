@@ -35,7 +35,7 @@ struct NMXSettings {
 
 
 
-class GdGemBase : public Detector {
+class GdGemBase : public InputDetector<> {
 public:
   GdGemBase(BaseSettings const & settings, NMXSettings & LocalSettings);
 
@@ -122,6 +122,16 @@ NMXConfig::NMXConfig(std::string configfile, std::string calibrationfile) {
 	if(root.count("clusterer")) {
       clusterer_name = root["clusterer"].get<std::string>();
     }
+    if(root.count("clusterer_sort")) {
+      auto sort = root["clusterer_sort"].get<std::string>();
+      if (sort == "radix") {
+        clusterer_sort = HitSort::Radix;
+      } else if (sort == "std_sort") {
+        clusterer_sort = HitSort::StdSort;
+      } else {
+        throw std::runtime_error("NMXConfig error - Invalid clusterer_sort.");
+      }
+    }
     auto cx = root["clusterer x"];
     clusterer_x.max_strip_gap = cx["max_strip_gap"].get<unsigned int>();
     clusterer_x.max_time_gap = cx["max_time_gap"].get<double>();
@@ -134,6 +144,9 @@ NMXConfig::NMXConfig(std::string configfile, std::string calibrationfile) {
       matcher_name = root["matcher"].get<std::string>();
     }
     matcher_max_delta_time = root["matcher_max_delta_time"].get<double>();
+    if(root.count("matcher_ordered_queue")) {
+      matcher_ordered_queue = root["matcher_ordered_queue"].get<bool>();
+    }
 
     if (root.count("analyzer")) {
       analyzer_name = root["analyzer"];
@@ -210,6 +223,8 @@ std::string NMXConfig::debug() const {
   ret += fmt::format("Perform clustering = {}\n", (perform_clustering ? "YES" : "no"));
 
   if (perform_clustering) {
+    ret += fmt::format("  Clusterer sort = {}\n",
+        (clusterer_sort == HitSort::Radix ? "radix" : "std_sort"));
     ret += "  Clusterer-X:\n";
     ret += fmt::format("    max_time_gap = {}\n", clusterer_x.max_time_gap);
     ret += fmt::format("    max_strip_gap = {}\n", clusterer_x.max_strip_gap);
@@ -220,6 +235,8 @@ std::string NMXConfig::debug() const {
 
     ret += fmt::format("  Matcher\n    max_delta_time = {}\n",
         matcher_max_delta_time);
+    ret += fmt::format("    ordered_queue = {}\n",
+        (matcher_ordered_queue ? "YES" : "no"));
     ret += fmt::format("  Send tracks = {}\n", (send_tracks ? "YES" : "no"));
     if (send_tracks) {
       ret += fmt::format("    sample_minhits = {}\n", track_sample_minhits);
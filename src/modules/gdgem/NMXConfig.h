@@ -68,9 +68,15 @@ struct NMXConfig {
   // Name of the matcher
   std::string matcher_name{"CenterMatcher"};
 
+  // Matcher keeps unmatched clusters in an ordered queue
+  bool matcher_ordered_queue{false};
+
   // Name of the clusterer
   std::string clusterer_name{"GapClusterer"};
 
+  // Sort used by the clusterers, "std_sort" or "radix"
+  HitSort clusterer_sort{HitSort::StdSort};
+
   // analysis
   std::shared_ptr<AbstractAnalyzer> analyzer_;
 
@@ -18,7 +18,8 @@ namespace Gem {
     int64_t RxBytes{0};
     int64_t RxIdle{0};
     int64_t FifoPushErrors{0};
-    int64_t PaddingFor64ByteAlignment[4]; // cppcheck-suppress unusedStructMember
+    int64_t RxMemoryBacking{0};
+    int64_t PaddingFor64ByteAlignment[3]; // cppcheck-suppress unusedStructMember
 
     // Processing thread
     int64_t ProcessingIdle {0};
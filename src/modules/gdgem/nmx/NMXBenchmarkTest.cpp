@@ -9,6 +9,7 @@
 #include <common/reduction/matching/CenterMatcher.h>
 
 #include <gdgem/generators/BuilderHits.h>
+#include <gdgem/srs/ParserVMM3.h>
 #include <gdgem/tests/HitGenerator.h>
 
 #include <fmt/format.h>
@@ -159,6 +160,51 @@ BENCHMARK_REGISTER_F(NmxBenchmarkTest, Dummy)
     ->Complexity();
 // BENCHMARK(NmxBenchmarkTest);
 
+/// \brief jumbo SRS frame with a marker for each of 16 vmms followed by hits
+std::vector<uint8_t> makeSRSFrame() {
+  std::vector<uint8_t> frame {0x00, 0x00, 0x00, 0x01,  // frame counter
+                              0x56, 0x4d, 0x33, 0x10,  // VMM3, fec 1
+                              0x00, 0x00, 0x00, 0x00,  // udp timestamp
+                              0x00, 0x00, 0x00, 0x00}; // offset overflow
+  while (frame.size() + ParserVMM3::HitAndMarkerSize <= 9000) {
+    uint32_t i = frame.size() / ParserVMM3::HitAndMarkerSize;
+    uint8_t vmm = i % MaxVMMs;
+    if (i < MaxVMMs) {
+      frame.insert(frame.end(), {0x00, 0x00, 0x10, 0x00, uint8_t(vmm << 2), 0x00});
+    } else {
+      frame.insert(frame.end(), {uint8_t(vmm >> 2), uint8_t((vmm << 6) | (i & 0x3f)),
+                                 uint8_t(i * 3), uint8_t(i * 5),
+                                 uint8_t(0x80 | (i & 0x3f)), uint8_t(i * 7)});
+    }
+  }
+  return frame;
+}
+
+static void ParserVMM3Receive(benchmark::State &state, bool batch) {
+  NMXStats stats;
+  SRSTime srsTime;
+  ParserVMM3 parser(1500, stats, srsTime);
+  parser.BatchDecode = batch;
+  auto frame = makeSRSFrame();
+  int64_t hits = 0;
+  BenchmarkLoop(state, [&] {
+    hits += parser.receive((char *)frame.data(), frame.size());
+    ::benchmark::ClobberMemory();
+  });
+  state.SetItemsProcessed(hits);
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+static void ParserVMM3_Batch(benchmark::State &state) {
+  ParserVMM3Receive(state, true);
+}
+BENCHMARK(ParserVMM3_Batch);
+
+static void ParserVMM3_Single(benchmark::State &state) {
+  ParserVMM3Receive(state, false);
+}
+BENCHMARK(ParserVMM3_Single);
+
 static void ClusterPlaneNoinline(benchmark::State &state) {
   Cluster &c = *new Cluster();
   uint8_t p;
@@ -91,8 +91,10 @@ void BuilderVMM3::process_buffer(char *buf, size_t size) {
       }
 
       if(data_processing_) {
-        hit.plane = digital_geometry_.get_plane(readout);
-        hit.coordinate = digital_geometry_.get_strip(readout);
+        auto &mapping = digital_geometry_.get_mapping(readout.fec,
+            readout.chip_id, readout.channel);
+        hit.plane = mapping.plane;
+        hit.coordinate = mapping.coordinate;
         hit.weight = readout.adc;
         hit.time = readout.srs_timestamp;
         if (readout.chiptime >= 0)
@@ -99,9 +99,17 @@ void CalibrationFile::addCalibration(size_t fecId, size_t vmmId,
     vmm.resize(chNo + 1);
 
   vmm[chNo] = {adc_offset, adc_slope, time_offset, time_slope};
+
+  if ((vmmId >= MAX_VMM) or (chNo >= MAX_CH))
+    return;
+
+  size_t Index = flatIndex(fecId, vmmId, chNo);
+  if (Index >= FlatCalibrations.size())
+    FlatCalibrations.resize(flatIndex(fecId + 1, 0, 0), NoCorr);
+  FlatCalibrations[Index] = vmm[chNo];
 }
 
-const Calibration& CalibrationFile::getCalibration(size_t fecId, size_t vmmId,
+const Calibration& CalibrationFile::getCalibrationNested(size_t fecId, size_t vmmId,
                                 size_t chNo) const {
   if (fecId >= Calibrations.size())
     return NoCorr;
@@ -51,13 +51,33 @@ public:
   /// \brief get calibration data for (fec, vmm, channel)
   /// \todo check how vmm3 data is supplied, maybe getting an array for a given
   /// (fec, vmm) is better?
-  const Calibration& getCalibration(size_t fecId, size_t vmmId, size_t chNo) const;
+  const Calibration& getCalibration(size_t fecId, size_t vmmId, size_t chNo) const {
+    if ((vmmId < MAX_VMM) and (chNo < MAX_CH)) {
+      size_t Index = flatIndex(fecId, vmmId, chNo);
+      if (Index < FlatCalibrations.size())
+        return FlatCalibrations[Index];
+      return NoCorr;
+    }
+    return getCalibrationNested(fecId, vmmId, chNo);
+  }
+
+  /// \brief index into the flat calibration table
+  static size_t flatIndex(size_t fecId, size_t vmmId, size_t chNo) {
+    return (fecId * MAX_VMM + vmmId) * MAX_CH + chNo;
+  }
 
   std::string debug() const;
 
 private:
+  /// \brief lookup for vmm or channel outside the flat table
+  const Calibration& getCalibrationNested(size_t fecId, size_t vmmId, size_t chNo) const;
+
   std::vector<std::vector<std::vector<Calibration>>> Calibrations;
 
+  /// Dense copy of Calibrations indexed by flatIndex(), MAX_VMM * MAX_CH
+  /// entries per fec up to the highest fec seen, unset entries are NoCorr
+  std::vector<Calibration> FlatCalibrations;
+
   /// Default correction
   Calibration NoCorr {0.0, 1.0, 0.0, 1.0};
   
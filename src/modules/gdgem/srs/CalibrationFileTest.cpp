@@ -56,6 +56,28 @@ TEST_F(CalibrationFileTest, AddCalibration) {
   }
 }
 
+TEST_F(CalibrationFileTest, AddCalibrationOutsideFlatTable) {
+  CalibrationFile cf;
+  cf.addCalibration(2, 20, 70, 1.0, 2.0, 3.0, 4.0);
+  cf.addCalibration(1, 3, 5, 5.0, 6.0, 7.0, 8.0);
+
+  auto calib = cf.getCalibration(2, 20, 70);
+  EXPECT_FLOAT_EQ(calib.adc_offset, 1.0);
+  EXPECT_FLOAT_EQ(calib.time_slope, 4.0);
+
+  calib = cf.getCalibration(1, 3, 5);
+  EXPECT_FLOAT_EQ(calib.adc_offset, 5.0);
+  EXPECT_FLOAT_EQ(calib.time_slope, 8.0);
+
+  // unset entries in the flat table and fecs above it
+  calib = cf.getCalibration(1, 3, 6);
+  EXPECT_FLOAT_EQ(calib.adc_slope, 1.0);
+  EXPECT_FLOAT_EQ(calib.time_offset, 0.0);
+  calib = cf.getCalibration(200, 3, 5);
+  EXPECT_FLOAT_EQ(calib.adc_slope, 1.0);
+  EXPECT_FLOAT_EQ(calib.time_offset, 0.0);
+}
+
 TEST_F(CalibrationFileTest, LoadCalibrationInvalidJsonFile) {
   CalibrationFile cf;
   EXPECT_THROW(cf.loadCalibration(TestData_InvalidJson), std::runtime_error);
@@ -14,6 +14,11 @@
 #include <string.h>
 #include <common/Trace.h>
 #include <gdgem/srs/ParserVMM3.h>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <tmmintrin.h>
+#endif
 
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_DEB
@@ -29,64 +34,197 @@ int ParserVMM3::parse(uint32_t data1, uint16_t data2, struct VMM3Data *vd) {
     XTRACE(PROCESS, DEB, "SRS Data");
 
     vd->overThreshold = (data2 >> 14) & 0x01;
-    stats.ParserOverThreshold += vd->overThreshold;
     vd->chno = (data2 >> 8) & 0x3f;
     vd->tdc = data2 & 0xff;
     vd->vmmid = (data1 >> 22) & 0x1F;
     vd->triggerOffset = (data1 >> 27) & 0x1F;
-    uint16_t idx = (pd.fecId - 1) * MaxVMMs + vd->vmmid;
-    if(vd->triggerOffset < markers[idx].lastTriggerOffset) {
-      if(markers[idx].calcTimeStamp != 0) {
-        markers[idx].calcTimeStamp +=32*srsTime.trigger_period_ns()/SRSTime::internal_SRS_clock_period_ns;
-      }
-      if(markers[idx].fecTimeStamp != markers[idx].calcTimeStamp){
-        stats.ParserTimestampLostErrors++;
-        XTRACE(PROCESS, WAR, "ParserTimestampLostErrors: fc %d vmm %d: fec ts %llu, calc ts %llu, diff %f",
-          pd.nextFrameCounter-1, vd->vmmid, markers[idx].fecTimeStamp,
-          markers[idx].calcTimeStamp, (double)markers[idx].fecTimeStamp-
-          (double)markers[idx].calcTimeStamp);
-      }
-    }
-    markers[idx].lastTriggerOffset = vd->triggerOffset;
     vd->adc = (data1 >> 12) & 0x3FF;
     vd->bcid = BitMath::gray2bin32(data1 & 0xFFF);
-    /// \todo Maybe here use the calculated timestamp instead
-    /// vd->fecTimeStamp = markers[idx].calcTimeStamp;
-    vd->fecTimeStamp = markers[idx].fecTimeStamp;
-    if(vd->fecTimeStamp > 0) {
-      markers[idx].hasDataMarker = true;
-      vd->hasDataMarker = true;
-    }
-    XTRACE(PROCESS, DEB, "SRS Data: vmm: %d, channel: %d. adc: %d",
-      vd->vmmid, vd->chno, vd->adc);
+    stats.ParserOverThreshold += vd->overThreshold;
+    updateHit(vd, markers[(pd.fecId - 1) * MaxVMMs + vd->vmmid]);
     return 1;
   } else {
-    /// Marker
-    uint8_t vmmid = (data2 >> 10) & 0x1F;
-    uint16_t idx = (pd.fecId - 1) * MaxVMMs + vmmid;
-    uint64_t timestamp_lower_10bit = data2 & 0x03FF;
-    uint64_t timestamp_upper_32bit = data1;
-
-    uint64_t timestamp_42bit = (timestamp_upper_32bit << 10)
-        + timestamp_lower_10bit;
-    XTRACE(PROCESS, DEB, "SRS Marker vmmid %d: timestamp lower 10bit %u, timestamp upper 32 bit %u, 42 bit timestamp %"
-        PRIu64"", vmmid, timestamp_lower_10bit, timestamp_upper_32bit, timestamp_42bit);
-
-    if(markers[idx].fecTimeStamp > timestamp_42bit) {
-      if (markers[idx].fecTimeStamp < 0x1FFFFFFF + timestamp_42bit) {
-        stats.ParserTimestampSeqErrors++;
-        XTRACE(PROCESS, DEB, "ParserTimestampSeqErrors:  fc %d, ts %llu, marker ts %llu", timestamp_42bit, markers[idx].fecTimeStamp);
+    parseMarker(data1, data2);
+    return 0;
+  }
+}
+
+void ParserVMM3::updateHit(struct VMM3Data *vd, struct VMM3Marker &marker) {
+  if(vd->triggerOffset < marker.lastTriggerOffset) {
+    if(marker.calcTimeStamp != 0) {
+      marker.calcTimeStamp +=32*srsTime.trigger_period_ns()/SRSTime::internal_SRS_clock_period_ns;
+    }
+    if(marker.fecTimeStamp != marker.calcTimeStamp){
+      stats.ParserTimestampLostErrors++;
+      XTRACE(PROCESS, WAR, "ParserTimestampLostErrors: fc %d vmm %d: fec ts %llu, calc ts %llu, diff %f",
+        pd.nextFrameCounter-1, vd->vmmid, marker.fecTimeStamp,
+        marker.calcTimeStamp, (double)marker.fecTimeStamp-
+        (double)marker.calcTimeStamp);
+    }
+  }
+  marker.lastTriggerOffset = vd->triggerOffset;
+  /// \todo Maybe here use the calculated timestamp instead
+  /// vd->fecTimeStamp = marker.calcTimeStamp;
+  vd->fecTimeStamp = marker.fecTimeStamp;
+  vd->hasDataMarker = false;
+  if(vd->fecTimeStamp > 0) {
+    marker.hasDataMarker = true;
+    vd->hasDataMarker = true;
+  }
+  XTRACE(PROCESS, DEB, "SRS Data: vmm: %d, channel: %d. adc: %d",
+    vd->vmmid, vd->chno, vd->adc);
+}
+
+void ParserVMM3::parseMarker(uint32_t data1, uint16_t data2) {
+  uint8_t vmmid = (data2 >> 10) & 0x1F;
+  uint16_t idx = (pd.fecId - 1) * MaxVMMs + vmmid;
+  uint64_t timestamp_lower_10bit = data2 & 0x03FF;
+  uint64_t timestamp_upper_32bit = data1;
+
+  uint64_t timestamp_42bit = (timestamp_upper_32bit << 10)
+      + timestamp_lower_10bit;
+  XTRACE(PROCESS, DEB, "SRS Marker vmmid %d: timestamp lower 10bit %u, timestamp upper 32 bit %u, 42 bit timestamp %"
+      PRIu64"", vmmid, timestamp_lower_10bit, timestamp_upper_32bit, timestamp_42bit);
+
+  if(markers[idx].fecTimeStamp > timestamp_42bit) {
+    if (markers[idx].fecTimeStamp < 0x1FFFFFFF + timestamp_42bit) {
+      stats.ParserTimestampSeqErrors++;
+      XTRACE(PROCESS, DEB, "ParserTimestampSeqErrors:  fc %d, ts %llu, marker ts %llu", timestamp_42bit, markers[idx].fecTimeStamp);
+    }
+    else {
+      stats.ParserTimestampOverflows++;
+    }
+  }
+  if(markers[idx].calcTimeStamp == 0) {
+    markers[idx].calcTimeStamp = timestamp_42bit;
+  }
+  markers[idx].fecTimeStamp = timestamp_42bit;
+}
+
+bool ParserVMM3::cpuSupportsSSSE3() {
+#if defined(__x86_64__)
+  static const bool Supported = __builtin_cpu_supports("ssse3");
+  return Supported;
+#else
+  return false;
+#endif
+}
+
+#if defined(__x86_64__)
+// compiled for SSSE3 independent of the -march of the build, only called
+// if SimdDecode is set
+__attribute__((target("ssse3")))
+int ParserVMM3::unpackBatchSSSE3(const char *readouts, int Count) {
+  int i = 0;
+  // four 6 byte readouts (24 bytes) from two overlapping 16 byte loads
+  const __m128i Data1LoA = _mm_setr_epi8(3, 2, 1, 0, 9, 8, 7, 6,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m128i Data1HiB = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         7, 6, 5, 4, 13, 12, 11, 10);
+  const __m128i Data2LoA = _mm_setr_epi8(5, 4, 11, 10, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m128i Data2HiB = _mm_setr_epi8(-1, -1, -1, -1, 9, 8, 15, 14,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+  for (; i + 4 <= Count; i += 4) {
+    const char *Readout = readouts + i * HitAndMarkerSize;
+    __m128i A = _mm_loadu_si128((const __m128i *)Readout);
+    __m128i B = _mm_loadu_si128((const __m128i *)(Readout + 8));
+    __m128i Data1 = _mm_or_si128(_mm_shuffle_epi8(A, Data1LoA),
+                                 _mm_shuffle_epi8(B, Data1HiB));
+    __m128i Data2 = _mm_or_si128(_mm_shuffle_epi8(A, Data2LoA),
+                                 _mm_shuffle_epi8(B, Data2HiB));
+    _mm_storeu_si128((__m128i *)&Batch.data1[i], Data1);
+    _mm_storel_epi64((__m128i *)&Batch.data2[i], Data2);
+    // data flag (bit 15) of each readout as one byte
+    __m128i Flags = _mm_srli_epi16(Data2, 15);
+    Flags = _mm_packus_epi16(Flags, Flags);
+    uint32_t IsHit = _mm_cvtsi128_si32(Flags);
+    memcpy(&Batch.isHit[i], &IsHit, sizeof(IsHit));
+  }
+  return i;
+}
+#else
+int ParserVMM3::unpackBatchSSSE3(const char *, int) { return 0; }
+#endif
+
+void ParserVMM3::unpackBatch(const char *readouts, int Count) {
+  int i = 0;
+  if (SimdDecode) {
+    i = unpackBatchSSSE3(readouts, Count);
+  }
+  for (; i < Count; i++) {
+    const char *Readout = readouts + i * HitAndMarkerSize;
+    uint32_t data1;
+    uint16_t data2;
+    memcpy(&data1, Readout, sizeof(data1));
+    memcpy(&data2, Readout + Data1Size, sizeof(data2));
+    Batch.data1[i] = ntohl(data1);
+    Batch.data2[i] = ntohs(data2);
+    Batch.isHit[i] = Batch.data2[i] >> 15;
+  }
+
+  // unpack the hit fields of all readouts, ignored for markers
+  for (i = 0; i < Count; i++) {
+    uint32_t data1 = Batch.data1[i];
+    uint16_t data2 = Batch.data2[i];
+    Batch.overThreshold[i] = (data2 >> 14) & 0x01;
+    Batch.chno[i] = (data2 >> 8) & 0x3f;
+    Batch.tdc[i] = data2 & 0xff;
+    Batch.vmmid[i] = (data1 >> 22) & 0x1F;
+    Batch.triggerOffset[i] = (data1 >> 27) & 0x1F;
+    Batch.adc[i] = (data1 >> 12) & 0x3FF;
+    Batch.bcid[i] = BitMath::gray2bin32(data1 & 0xFFF);
+  }
+}
+
+int ParserVMM3::parseBatch(const char *readouts, int datalen) {
+  // counted locally, the stats are updated once per frame
+  int hits = 0;
+  int markerCount = 0;
+  int64_t overThreshold = 0;
+  struct VMM3Marker *fecMarkers = markers + (pd.fecId - 1) * MaxVMMs;
+  struct VMM3Data *hitData = data;
+  int hitCapacity = maxHits;
+
+  int readoutIndex = 0;
+  while (datalen >= HitAndMarkerSize) {
+    int Count = std::min(datalen / HitAndMarkerSize, (int)BatchSize);
+    unpackBatch(readouts + readoutIndex * HitAndMarkerSize, Count);
+
+    for (int i = 0; i < Count; i++) {
+      if (Batch.isHit[i]) {
+        struct VMM3Data *vd = &hitData[hits];
+        vd->overThreshold = Batch.overThreshold[i];
+        vd->chno = Batch.chno[i];
+        vd->tdc = Batch.tdc[i];
+        vd->vmmid = Batch.vmmid[i];
+        vd->triggerOffset = Batch.triggerOffset[i];
+        vd->adc = Batch.adc[i];
+        vd->bcid = Batch.bcid[i];
+        overThreshold += Batch.overThreshold[i];
+        updateHit(vd, fecMarkers[Batch.vmmid[i]]);
+        hits++;
+      } else {
+        parseMarker(Batch.data1[i], Batch.data2[i]);
+        markerCount++;
       }
-      else {
-        stats.ParserTimestampOverflows++;
+
+      datalen -= HitAndMarkerSize;
+      if (hits == hitCapacity && datalen > 0) {
+        XTRACE(PROCESS, WAR, "Data overflow, skipping %d bytes", datalen);
+        stats.ParserErrorBytes += datalen;
+        datalen = 0;
+        break;
       }
     }
-    if(markers[idx].calcTimeStamp == 0) {
-      markers[idx].calcTimeStamp = timestamp_42bit;
-    }
-    markers[idx].fecTimeStamp = timestamp_42bit;
-    return 0;
+    readoutIndex += Count;
   }
+
+  stats.ParserData += hits;
+  stats.ParserMarkers += markerCount;
+  stats.ParserReadouts += hits + markerCount;
+  stats.ParserOverThreshold += overThreshold;
+  return hits;
 }
 
 
@@ -172,6 +310,12 @@ int ParserVMM3::receive(const char *buffer, int size) {
     return 0;
   }
 
+  if (BatchDecode) {
+    hits = parseBatch(buffer + SRSHeaderSize, datalen);
+    stats.ParserGoodFrames++;
+    return hits;
+  }
+
   int dataIndex = 0;
   int readoutIndex = 0;
   while (datalen >= HitAndMarkerSize) {
@@ -90,6 +90,39 @@ public:
   /// \param vmd VMM2Data structure holding the parsed data (tdc, bcid, adc, ...)
   int parse(uint32_t data1, uint16_t data2, struct VMM3Data *vmd);
 
+  /// \brief parse the readouts of a frame in batches: byte swap and
+  /// classify all readouts (SIMD if available), unpack the hit fields
+  /// into Batch, then do the marker and timestamp bookkeeping in order.
+  /// Same results and stats as calling parse() for each readout.
+  /// \return number of hits
+  int parseBatch(const char *readouts, int datalen);
+
+  /// Decode frames with parseBatch() (default), else parse()
+  bool BatchDecode{true};
+
+  /// \brief is the SSSE3 byte swapping of parseBatch() supported by the CPU
+  static bool cpuSupportsSSSE3();
+
+  /// Use SSSE3 in parseBatch(), defaults to what the CPU supports
+  bool SimdDecode{cpuSupportsSSSE3()};
+
+  /// readouts per parseBatch() pass
+  static const int BatchSize{256};
+
+  /// byte swapped readouts and unpacked hit fields of a batch
+  struct {
+    uint32_t data1[BatchSize];
+    uint16_t data2[BatchSize];
+    uint8_t isHit[BatchSize];
+    uint16_t bcid[BatchSize];
+    uint16_t adc[BatchSize];
+    uint8_t tdc[BatchSize];
+    uint8_t chno[BatchSize];
+    uint8_t overThreshold[BatchSize];
+    uint8_t vmmid[BatchSize];
+    uint8_t triggerOffset[BatchSize];
+  } Batch;
+
   /// Holds data common to all readouts in a packet
   struct SRSHeader hdr;
 
@@ -107,6 +140,19 @@ public:
   NMXStats & stats;
   SRSTime srsTime;
 
+private:
+  /// \brief timestamp bookkeeping of a hit with the readout fields set
+  void updateHit(struct VMM3Data *vd, struct VMM3Marker &marker);
+
+  /// \brief update the vmm timestamp from a marker
+  void parseMarker(uint32_t data1, uint16_t data2);
+
+  /// \brief byte swap and classify Count readouts into Batch
+  void unpackBatch(const char *readouts, int Count);
+
+  /// \brief SSSE3 version of the byte swapping and classification in
+  /// unpackBatch(), returns number of readouts done (a multiple of 4)
+  int unpackBatchSSSE3(const char *readouts, int Count);
  };
 
 }
@@ -213,6 +213,110 @@ TEST_F(ParserVMM3Test, DataLengthOverflow) {
   EXPECT_EQ(6, shortvmmbuffer.stats.ParserErrorBytes);
 }
 
+class ParserVMM3BatchTest : public TestBase {
+protected:
+  NMXStats batchStats;
+  NMXStats singleStats;
+  SRSTime srsTime;
+  std::unique_ptr<ParserVMM3> batch;
+  std::unique_ptr<ParserVMM3> single;
+
+  void SetUp() override {
+    srsTime.bc_clock_MHz(40);
+    srsTime.tac_slope_ns(60);
+    srsTime.trigger_resolution_ns(1);
+    batch = std::make_unique<ParserVMM3>(1125, batchStats, srsTime);
+    single = std::make_unique<ParserVMM3>(1125, singleStats, srsTime);
+    single->BatchDecode = false;
+  }
+
+  void receiveBoth(std::vector<uint8_t> &frame) {
+    int hits = batch->receive((char *)frame.data(), frame.size());
+    ASSERT_EQ(hits, single->receive((char *)frame.data(), frame.size()));
+    for (int i = 0; i < hits; i++) {
+      auto &b = batch->data[i];
+      auto &s = single->data[i];
+      ASSERT_EQ(b.fecTimeStamp, s.fecTimeStamp);
+      ASSERT_EQ(b.bcid, s.bcid);
+      ASSERT_EQ(b.adc, s.adc);
+      ASSERT_EQ(b.tdc, s.tdc);
+      ASSERT_EQ(b.chno, s.chno);
+      ASSERT_EQ(b.overThreshold, s.overThreshold);
+      ASSERT_EQ(b.vmmid, s.vmmid);
+      ASSERT_EQ(b.triggerOffset, s.triggerOffset);
+      ASSERT_EQ(b.hasDataMarker, s.hasDataMarker);
+    }
+    ASSERT_EQ(batchStats.ParserFrameSeqErrors, singleStats.ParserFrameSeqErrors);
+    ASSERT_EQ(batchStats.ParserFrameMissingErrors, singleStats.ParserFrameMissingErrors);
+    ASSERT_EQ(batchStats.ParserFramecounterOverflows, singleStats.ParserFramecounterOverflows);
+    ASSERT_EQ(batchStats.ParserTimestampLostErrors, singleStats.ParserTimestampLostErrors);
+    ASSERT_EQ(batchStats.ParserTimestampSeqErrors, singleStats.ParserTimestampSeqErrors);
+    ASSERT_EQ(batchStats.ParserTimestampOverflows, singleStats.ParserTimestampOverflows);
+    ASSERT_EQ(batchStats.ParserBadFrames, singleStats.ParserBadFrames);
+    ASSERT_EQ(batchStats.ParserGoodFrames, singleStats.ParserGoodFrames);
+    ASSERT_EQ(batchStats.ParserErrorBytes, singleStats.ParserErrorBytes);
+    ASSERT_EQ(batchStats.ParserMarkers, singleStats.ParserMarkers);
+    ASSERT_EQ(batchStats.ParserData, singleStats.ParserData);
+    ASSERT_EQ(batchStats.ParserReadouts, singleStats.ParserReadouts);
+    ASSERT_EQ(batchStats.ParserOverThreshold, singleStats.ParserOverThreshold);
+  }
+};
+
+TEST_F(ParserVMM3BatchTest, AllTestData) {
+  std::vector<std::vector<uint8_t> *> frames {
+    &header_only, &data_3_ch0, &marker_3_vmm1_3, &marker_3_data_3,
+    &marker_data_mixed_3, &no_data, &invalid_fec_id, &invalid_dataid,
+    &inconsistent_datalen, &timestamp_error, &timestamp_overflow,
+    &timestamp_lost, &timestamp_not_lost, &framecounter_error1,
+    &framecounter_error2, &framecounter_overflow1, &framecounter_overflow2};
+  for (auto frame : frames) {
+    receiveBoth(*frame);
+  }
+  ASSERT_GT(batchStats.ParserData, 0);
+  ASSERT_GT(batchStats.ParserMarkers, 0);
+}
+
+// more readouts than ParserVMM3::BatchSize, not a multiple of the SIMD width
+TEST_F(ParserVMM3BatchTest, LargeFrame) {
+  std::vector<uint8_t> frame(data_3_ch0.begin(),
+                             data_3_ch0.begin() + ParserVMM3::SRSHeaderSize);
+  for (uint32_t i = 0; i < 2 * ParserVMM3::BatchSize + 3; i++) {
+    uint8_t vmm = i % MaxVMMs;
+    if (i % 7 == 0) { // marker, data flag 0
+      uint32_t time = i * 1000;
+      frame.insert(frame.end(), {uint8_t(time >> 24), uint8_t(time >> 16),
+                                 uint8_t(time >> 8), uint8_t(time),
+                                 uint8_t(vmm << 2), uint8_t(i)});
+    } else { // hit, data flag 1
+      frame.insert(frame.end(), {uint8_t(i * 8 + vmm), uint8_t(i * 7),
+                                 uint8_t(i * 5), uint8_t(i * 3),
+                                 uint8_t(0x80 | (i & 0x7f)), uint8_t(i * 11)});
+    }
+  }
+  receiveBoth(frame);
+  ASSERT_EQ(batchStats.ParserReadouts, 2 * ParserVMM3::BatchSize + 3);
+  ASSERT_EQ(batchStats.ParserMarkers, 74);
+
+  // and without SIMD
+  batch->SimdDecode = false;
+  receiveBoth(frame);
+  ASSERT_EQ(batchStats.ParserReadouts, 2 * (2 * ParserVMM3::BatchSize + 3));
+}
+
+TEST_F(ParserVMM3BatchTest, SimdDecodeDefault) {
+  ASSERT_EQ(batch->SimdDecode, ParserVMM3::cpuSupportsSSSE3());
+}
+
+TEST_F(ParserVMM3BatchTest, DataLengthOverflow) {
+  ParserVMM3 shortBatch(2, batchStats, srsTime);
+  ParserVMM3 shortSingle(2, singleStats, srsTime);
+  shortSingle.BatchDecode = false;
+  int hits = shortBatch.receive((char *)data_3_ch0.data(), data_3_ch0.size());
+  ASSERT_EQ(hits, shortSingle.receive((char *)data_3_ch0.data(), data_3_ch0.size()));
+  ASSERT_EQ(hits, 2);
+  ASSERT_EQ(batchStats.ParserErrorBytes, singleStats.ParserErrorBytes);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -51,39 +51,19 @@ void SRSMappings::set_mapping(uint16_t fecID, uint16_t vmmID, uint16_t channel,
     VMM.resize(channel + 1u);
 
   VMM[channel] = {plane, coord};
+
+  size_t Index = flat_index(fecID, vmmID, channel);
+  if (flat_mappings_.size() <= Index)
+    flat_mappings_.resize(flat_index(fecID + 1u, 0, 0));
+  flat_mappings_[Index] = VMM[channel];
 }
 
-/// \todo this seems to validate too much, plane can be
-/// valid but channel still invalid?
 uint8_t SRSMappings::get_plane(const Readout &readout) const {
-  if (readout.fec >= mappings_.size())
-    return Hit::InvalidPlane;
-  const auto &fec = mappings_[readout.fec];
-  if (readout.chip_id >= fec.size())
-    return Hit::InvalidPlane;
-  const auto &vmm = fec[readout.chip_id];
-  if (readout.channel >= vmm.size())
-    return Hit::InvalidPlane;
-  return vmm[readout.channel].plane;
+  return get_mapping(readout.fec, readout.chip_id, readout.channel).plane;
 }
 
 uint16_t SRSMappings::get_strip(const Readout &readout) const {
-  if (readout.fec >= mappings_.size()) {
-    XTRACE(DATA, DEB, "fec %d >= mappings size %d",
-      readout.fec, mappings_.size());
-    return Hit::InvalidCoord;
-  }
-  const auto &fec = mappings_[readout.fec];
-  if (readout.chip_id >= fec.size()) {
-    XTRACE(DATA, DEB, "chip_id %d >= fec size %d",
-      readout.chip_id, fec.size());
-    return Hit::InvalidCoord;
-  }
-  const auto &vmm = fec[readout.chip_id];
-  if (readout.channel >= vmm.size()) {
-    return Hit::InvalidCoord;
-  }
-  return vmm[readout.channel].coordinate;
+  return get_mapping(readout.fec, readout.chip_id, readout.channel).coordinate;
 }
 
 std::string SRSMappings::debug() const {
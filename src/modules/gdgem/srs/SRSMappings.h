@@ -20,6 +20,12 @@ public:
   static constexpr size_t MaxChannelsInVMM {64};
   static constexpr size_t MaxChipsInFEC {16};
 
+  struct MappingResult
+  {
+    uint8_t plane {Hit::InvalidPlane};
+    uint16_t coordinate {Hit::InvalidCoord};
+  };
+
   //// \brief define mappings for sequence of chips in one plane
   /// \param planeID ID of plane (edge of panel) being defined
   /// \param chips list of (FEC, VMM) pairs in the order of increasing strip
@@ -42,20 +48,34 @@ public:
 
   uint8_t get_plane(const Readout &readout) const;
 
+  /// \brief plane and strip for (fec, vmm, channel) from a single lookup
+  /// in the flat table, both invalid if no mapping is defined
+  const MappingResult &get_mapping(uint16_t fecID, uint16_t vmmID,
+                                   uint16_t channel) const {
+    if ((vmmID < MaxChipsInFEC) and (channel < MaxChannelsInVMM)) {
+      size_t Index = flat_index(fecID, vmmID, channel);
+      if (Index < flat_mappings_.size())
+        return flat_mappings_[Index];
+    }
+    return invalid_mapping_;
+  }
+
   /// \brief prints out configuration
   std::string debug() const;
 
 private:
-  struct MappingResult
-  {
-    uint8_t plane {Hit::InvalidPlane};
-    uint16_t coordinate {Hit::InvalidCoord};
-  };
+  static size_t flat_index(size_t fecID, size_t vmmID, size_t channel) {
+    return (fecID * MaxChipsInFEC + vmmID) * MaxChannelsInVMM + channel;
+  }
 
   using ChipMappings = std::vector<MappingResult>;
   using FecMappings = std::vector<ChipMappings>;
 
   std::vector<FecMappings> mappings_;
+
+  /// dense copy of mappings_ indexed by flat_index()
+  std::vector<MappingResult> flat_mappings_;
+  MappingResult invalid_mapping_;
 };
 
 }
@@ -72,6 +72,26 @@ TEST_F(SRSMappingsTest, PlaneDefinition) {
   EXPECT_EQ(geometry.get_strip(r), 64);
 }
 
+TEST_F(SRSMappingsTest, GetMapping) {
+  geometry.define_plane(0, {{1, 0}, {1, 1}});
+  geometry.define_plane(1, {{2, 15}});
+
+  for (uint16_t ch = 0; ch < SRSMappings::MaxChannelsInVMM; ch++) {
+    auto &m0 = geometry.get_mapping(1, 1, ch);
+    EXPECT_EQ(m0.plane, 0);
+    EXPECT_EQ(m0.coordinate, 64 + ch);
+    auto &m1 = geometry.get_mapping(2, 15, ch);
+    EXPECT_EQ(m1.plane, 1);
+    EXPECT_EQ(m1.coordinate, ch);
+  }
+
+  EXPECT_EQ(geometry.get_mapping(0, 0, 0).plane, bad_plane);
+  EXPECT_EQ(geometry.get_mapping(1, 2, 0).coordinate, bad_coord);
+  EXPECT_EQ(geometry.get_mapping(1, 0, 64).plane, bad_plane);
+  EXPECT_EQ(geometry.get_mapping(1, 16, 0).plane, bad_plane);
+  EXPECT_EQ(geometry.get_mapping(3, 0, 0).coordinate, bad_coord);
+}
+
 TEST_F(SRSMappingsTest, DebugString) {
   MESSAGE() << "This is not a test, just calling the debug function\n";
   geometry.define_plane(0, {{0, 0}, {0, 1}});
@@ -7,6 +7,7 @@
 #include <gdgem/nmx/Readout.h>
 #include <common/reduction/clustering/GapClusterer.h>
 #include <common/reduction/matching/GapMatcher.h>
+#include <random>
 
 using namespace Gem;
 
@@ -31,7 +32,7 @@ public:
   }
 
   void flush() {
-    sort_chronologically(buffer);
+    sort_chronologically(buffer, sort_method);
     if (clusterer)
       clusterer->cluster(buffer);
     buffer.clear();
@@ -40,6 +41,7 @@ public:
   }
 
   std::shared_ptr<AbstractClusterer> clusterer;
+  HitSort sort_method{HitSort::StdSort};
 
   HitVector buffer;
   uint64_t prev_srs_time {0};
@@ -51,19 +53,25 @@ private:
   SRSMappings pChips;
 };
 
-static void Doit(benchmark::State &state) {
+static void Doit(benchmark::State &state, HitSort method) {
 	std::string DataPath = TEST_DATA_PATH;
   auto opts = NMXConfig(DataPath + "/config.json", "");
 
     HitSorter sorter_x(opts.time_config, opts.srs_mappings);
   HitSorter sorter_y(opts.time_config, opts.srs_mappings);
 
-  sorter_x.clusterer =
+  auto clusterer_x =
       std::make_shared<GapClusterer>(opts.clusterer_x.max_time_gap,
                                      opts.clusterer_x.max_strip_gap);
-  sorter_y.clusterer =
+  auto clusterer_y =
       std::make_shared<GapClusterer>(opts.clusterer_y.max_time_gap,
                                      opts.clusterer_y.max_strip_gap);
+  clusterer_x->set_sort_method(method);
+  clusterer_y->set_sort_method(method);
+  sorter_x.clusterer = clusterer_x;
+  sorter_y.clusterer = clusterer_y;
+  sorter_x.sort_method = method;
+  sorter_y.sort_method = method;
 
   GapMatcher matcher (opts.time_config.acquisition_window()*5, 0, 1);
   matcher.set_minimum_time_gap(opts.matcher_max_delta_time);
@@ -103,6 +111,55 @@ static void Doit(benchmark::State &state) {
 	state.SetItemsProcessed(items);
 }
 
-BENCHMARK (Doit);
+BENCHMARK_CAPTURE(Doit, std_sort, HitSort::StdSort);
+BENCHMARK_CAPTURE(Doit, radix, HitSort::Radix);
+
+/// \brief state.range(0) hits as from an NMX packet: times within about
+/// 100us, strips 0 - 1279, in random order
+static HitVector make_batch(size_t size) {
+  std::default_random_engine gen;
+  std::uniform_int_distribution<uint64_t> time(0, 100000);
+  std::uniform_int_distribution<uint16_t> strip(0, 1279);
+  HitVector hits;
+  for (size_t i = 0; i < size; i++) {
+    Hit hit;
+    hit.time = 1000000000000ULL + time(gen);
+    hit.coordinate = strip(gen);
+    hit.weight = 100;
+    hit.plane = 0;
+    hits.push_back(hit);
+  }
+  return hits;
+}
+
+static void SortChronologically(benchmark::State &state, HitSort method) {
+  auto batch = make_batch(state.range(0));
+  HitVector hits;
+  for (auto _ : state) {
+    hits = batch;
+    sort_chronologically(hits, method);
+    benchmark::DoNotOptimize(hits.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(SortChronologically, std_sort, HitSort::StdSort)
+    ->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK_CAPTURE(SortChronologically, radix, HitSort::Radix)
+    ->RangeMultiplier(4)->Range(16, 16384);
+
+static void SortByCoordinate(benchmark::State &state, HitSort method) {
+  auto batch = make_batch(state.range(0));
+  HitVector hits;
+  for (auto _ : state) {
+    hits = batch;
+    sort_by_increasing_coordinate(hits, method);
+    benchmark::DoNotOptimize(hits.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(SortByCoordinate, std_sort, HitSort::StdSort)
+    ->RangeMultiplier(4)->Range(16, 16384);
+BENCHMARK_CAPTURE(SortByCoordinate, radix, HitSort::Radix)
+    ->RangeMultiplier(4)->Range(16, 16384);
 
 BENCHMARK_MAIN();
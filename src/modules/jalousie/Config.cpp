@@ -75,7 +75,7 @@ Config::Config(std::string jsonfile) {
   geometry.np(i);
 
   maximum_latency = root["maximum_latency"];
-  merger = ChronoMerger(maximum_latency, i);
+  merger = ChronoHeapMerger(maximum_latency, i);
 }
 
 std::string Config::debug() const {
@@ -11,7 +11,7 @@
 
 #include <jalousie/SumoMappings.h>
 #include <jalousie/Readout.h>
-#include <common/reduction/ChronoMerger.h>
+#include <common/reduction/ChronoHeapMerger.h>
 #include <common/EV42Serializer.h>
 #include <logical_geometry/ESSGeometry.h>
 
@@ -39,7 +39,7 @@ struct Config {
 
   /// Will be replaced upon configuration
   /// Has 0s just to make default initialization possible
-  ChronoMerger merger {0,0};
+  ChronoHeapMerger merger {0,0};
 
   std::string debug() const;
 };
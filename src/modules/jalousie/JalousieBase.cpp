@@ -34,7 +34,7 @@ const char *classname = "Jalousie detector";
 
 
 JalousieBase::JalousieBase(BaseSettings const &settings, CLISettings const &LocalSettings)
-    : Detector("JALOUSIE", settings), ModuleSettings(LocalSettings) {
+    : InputDetector("JALOUSIE", settings), ModuleSettings(LocalSettings) {
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -56,7 +56,11 @@ JalousieBase::JalousieBase(BaseSettings const &settings, CLISettings const &Loca
 
   Stats.create("thread.seq_errors", Counters.FifoSeqErrors);
   Stats.create("thread.input_idle", Counters.RxIdle);
-  Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin", ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield", ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause", ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep", ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing", Counters.RxMemoryBacking);
 
   /// \todo below stats are common to all detectors and could/should be moved
   Stats.create("kafka.produce_fails", Counters.kafka_produce_fails);
@@ -65,6 +69,7 @@ JalousieBase::JalousieBase(BaseSettings const &settings, CLISettings const &Loca
   Stats.create("kafka.dr_errors", Counters.kafka_dr_errors);
   Stats.create("kafka.dr_others", Counters.kafka_dr_noerrors);
   // clang-format on
+  Counters.RxMemoryBacking = rxMemoryBacking(); // 2 is huge pages
 
   std::function<void()> inputFunc = [this]() { JalousieBase::inputThread(); };
   Detector::AddThreadFunction(inputFunc, "input");
@@ -205,6 +210,7 @@ void JalousieBase::processingThread() {
   TSCTimer produce_timer;
   while (true) {
     if (InputFifo.pop(data_index)) { // There is data in the FIFO - do processing
+      ProcessingIdle.reset();
       auto datalen = RxRingbuffer.getDataLength(data_index);
       if (datalen == 0) {
         Counters.FifoSeqErrors++;
@@ -232,8 +238,7 @@ void JalousieBase::processingThread() {
 
     } else {
       /// There is NO data in the FIFO - do stop checks and sleep a little
-      Counters.ProcessingIdle++;
-      usleep(10);
+      ProcessingIdle.idle();
     }
 
     /// Periodic producing regardless of rates
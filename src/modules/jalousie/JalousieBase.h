@@ -20,7 +20,7 @@ struct CLISettings {
 
 
 
-class JalousieBase : public Detector {
+class JalousieBase : public InputDetector<> {
 public:
   explicit JalousieBase(BaseSettings const &settings, CLISettings const &LocalSettings);
   ~JalousieBase() = default;
@@ -35,10 +35,10 @@ protected:
     int64_t RxBytes;
     int64_t RxIdle;
     int64_t FifoPushErrors;
-    int64_t PaddingFor64ByteAlignment[4]; // cppcheck-suppress unusedStructMember
+    int64_t RxMemoryBacking;
+    int64_t PaddingFor64ByteAlignment[3]; // cppcheck-suppress unusedStructMember
 
     // Processing Counters
-    int64_t ProcessingIdle;
     int64_t FifoSeqErrors;
     int64_t ReadoutCount;
     int64_t BadModuleId;
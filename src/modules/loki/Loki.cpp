@@ -19,12 +19,19 @@ void SetCLIArguments(CLI::App __attribute__((unused)) & parser) {
   parser.add_option("--calibration", LocalLokiSettings.CalibFile,
                     "LoKI specific calibration (json) file")
                     ->group("LOKI");
+  parser.add_option("--calibration_lut", LocalLokiSettings.CalibLookupBins,
+                    "Bins per straw in calibration lookup table (0: evaluate polynomials)")
+                    ->group("LOKI");
   parser.add_option("--dumptofile", LocalLokiSettings.FilePrefix,
                     "dump to specified file")->group("LOKI");
 
   parser.add_flag("--2D", LocalLokiSettings.DetectorImage2D,
                     "Generate Pixels for 2D detector (else 3D)")
                     ->group("LOKI");
+
+  parser.add_option("--workers", LocalLokiSettings.Workers,
+                    "Threads for pixel calculations (0: use processing thread)")
+                    ->group("LOKI");
 }
 
 PopulateCLIParser PopulateParser{SetCLIArguments};
@@ -9,6 +9,7 @@
 #include "LokiBase.h"
 
 #include <cinttypes>
+#include <cstring>
 #include <common/EFUArgs.h>
 #include <common/Log.h>
 #include <common/monitor/HistogramSerializer.h>
@@ -34,7 +35,11 @@ namespace Loki {
 const char *classname = "Loki detector with ESS readout";
 
 LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiSettings)
-    : Detector("Loki", Settings), LokiModuleSettings(LocalLokiSettings) {
+    : InputDetector("Loki", Settings), LokiModuleSettings(LocalLokiSettings) {
+
+  // one input thread per receiver, see inputThread()
+  enableReceivers();
+  PacketMmapSupported = true;
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -44,6 +49,8 @@ LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiS
   Stats.create("receive.bytes", Counters.RxBytes);
   Stats.create("receive.dropped", Counters.FifoPushErrors);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
+  Stats.create("receive.ring_overruns", Counters.RingOverruns);
+  Stats.create("receive.kernel_drops", Counters.KernelDrops);
 
   // ESS Readout
   Stats.create("readouts.error_buffer", Counters.ErrorBuffer);
@@ -67,7 +74,11 @@ LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiS
 
   //
   Stats.create("thread.input_idle", Counters.RxIdle);
-  Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin", ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield", ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause", ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep", ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing", Counters.RxMemoryBacking);
 
   Stats.create("events.count", Counters.Events);
   Stats.create("events.udder", Counters.EventsUdder);
@@ -77,6 +88,22 @@ LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiS
 
   Stats.create("transmit.bytes", Counters.TxBytes);
 
+  // Readout dumping needs the packet order, so it keeps the single
+  // threaded processing
+  if (LokiModuleSettings.FilePrefix.empty()) {
+    PipelineWorkers = LokiModuleSettings.Workers;
+    if (PipelineWorkers > LokiPipeline::MaxWorkers) {
+      PipelineWorkers = LokiPipeline::MaxWorkers;
+    }
+  }
+  for (unsigned int Worker = 0; Worker < PipelineWorkers; Worker++) {
+    std::string Name = "pipeline.worker" + std::to_string(Worker) + ".";
+    Stats.create(Name + "sections", PipelineStats[Worker].Sections);
+    Stats.create(Name + "readouts", PipelineStats[Worker].Readouts);
+    Stats.create(Name + "events", PipelineStats[Worker].Events);
+    Stats.create(Name + "queue_depth", PipelineStats[Worker].QueueDepth);
+  }
+
   /// \todo below stats are common to all detectors and could/should be moved
   Stats.create("kafka.produce_fails", Counters.kafka_produce_fails);
   Stats.create("kafka.ev_errors", Counters.kafka_ev_errors);
@@ -84,9 +111,15 @@ LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiS
   Stats.create("kafka.dr_errors", Counters.kafka_dr_errors);
   Stats.create("kafka.dr_others", Counters.kafka_dr_noerrors);
   // clang-format on
-
-  std::function<void()> inputFunc = [this]() { LokiBase::inputThread(); };
-  Detector::AddThreadFunction(inputFunc, "input");
+  Counters.RxMemoryBacking = rxMemoryBacking(); // 2 is huge pages
+
+  for (unsigned int Receiver = 0; Receiver < receivers(); Receiver++) {
+    std::function<void()> inputFunc = [this, Receiver]() {
+      LokiBase::inputThread(Receiver);
+    };
+    std::string Name = (Receiver == 0) ? "input" : "input_" + std::to_string(Receiver);
+    Detector::AddThreadFunction(inputFunc, Name);
+  }
 
   std::function<void()> processingFunc = [this]() {
     LokiBase::processingThread();
@@ -98,43 +131,81 @@ LokiBase::LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiS
 }
 
 
-void LokiBase::inputThread() {
-  /** Connection setup */
-  Socket::Endpoint local(EFUSettings.DetectorAddress.c_str(),
-                         EFUSettings.DetectorPort);
+void LokiBase::inputThread(unsigned int Receiver) {
+  if (not EFUSettings.PacketMmapInterface.empty()) {
+    packetMmapReceiveLoop(Receiver);
+  } else {
+    /** Connection setup */
+    Socket::Endpoint local(EFUSettings.DetectorAddress.c_str(),
+                           EFUSettings.DetectorPort);
+
+    UDPReceiver dataReceiver(local, receivers() > 1);
+    dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
+                                EFUSettings.RxSocketBufferSize);
+    dataReceiver.printBufferSizes();
+    dataReceiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
+    receiveLoop(dataReceiver, Receiver);
+  }
+  XTRACE(INPUT, ALW, "Stopping input thread.");
+}
 
-  UDPReceiver dataReceiver(local);
-  dataReceiver.setBufferSizes(EFUSettings.TxSocketBufferSize,
-                              EFUSettings.RxSocketBufferSize);
-  dataReceiver.printBufferSizes();
-  dataReceiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
+void LokiBase::receiveLoop(UDPReceiver &dataReceiver, unsigned int Receiver) {
+  auto &Fifo = inputFifo(Receiver);
+  auto &Ringbuffer = rxRingbuffer(Receiver);
+  auto &RxStats = RxCounters[Receiver];
 
   while (runThreads) {
+    if (EFUSettings.ReceiveBatchSize > 1) {
+      receiveBatch(dataReceiver, Receiver);
+      continue;
+    }
+
     int readSize;
 
-    unsigned int rxBufferIndex = RxRingbuffer.getDataIndex();
+    unsigned int rxBufferIndex = Ringbuffer.getDataIndex();
+    if (Ringbuffer.acquire() == 0) { // still owned by the processing thread
+      usleep(10);
+      continue;
+    }
 
-    RxRingbuffer.setDataLength(rxBufferIndex, 0);
+    Ringbuffer.setDataLength(rxBufferIndex, 0);
 
-    if ((readSize = dataReceiver.receive(RxRingbuffer.getDataBuffer(rxBufferIndex),
-                                   RxRingbuffer.getMaxBufSize())) > 0) {
-      RxRingbuffer.setDataLength(rxBufferIndex, readSize);
+    if ((readSize = dataReceiver.receive(Ringbuffer.getDataBuffer(rxBufferIndex),
+                                   Ringbuffer.getMaxBufSize())) > 0) {
+      Ringbuffer.setDataLength(rxBufferIndex, readSize);
       XTRACE(INPUT, DEB, "Received an udp packet of length %d bytes", readSize);
-      Counters.RxPackets++;
-      Counters.RxBytes += readSize;
+      RxStats.RxPackets++;
+      RxStats.RxBytes += readSize;
 
-      if (InputFifo.push(rxBufferIndex) == false) {
-        Counters.FifoPushErrors++;
+      if (Fifo.push(rxBufferIndex) == false) {
+        RxStats.FifoPushErrors++;
       } else {
-        RxRingbuffer.getNextBuffer();
+        Ringbuffer.commit();
       }
     } else {
-      Counters.RxIdle++;
+      RxStats.RxIdle++;
     }
 
   }
-  XTRACE(INPUT, ALW, "Stopping input thread.");
-  return;
+}
+
+/// \brief copy the worker stats and sum the worker instrument counters
+void LokiBase::updatePipelineCounters(LokiPipeline &Pipeline,
+                                      struct Counters *WorkerCounters) {
+  Counters.ReadoutsBadAmpl = 0;
+  Counters.ReadoutsClampLow = 0;
+  Counters.ReadoutsClampHigh = 0;
+  Counters.MappingErrors = 0;
+  Counters.GeometryErrors = 0;
+  for (unsigned int Worker = 0; Worker < Pipeline.workers(); Worker++) {
+    auto &WC = WorkerCounters[Worker];
+    Counters.ReadoutsBadAmpl += WC.ReadoutsBadAmpl;
+    Counters.ReadoutsClampLow += WC.ReadoutsClampLow;
+    Counters.ReadoutsClampHigh += WC.ReadoutsClampHigh;
+    Counters.MappingErrors += WC.MappingErrors;
+    Counters.GeometryErrors += WC.GeometryErrors;
+    PipelineStats[Worker] = Pipeline.workerStats(Worker);
+  }
 }
 
 /// \brief Generate an Udder test image
@@ -173,6 +244,17 @@ void LokiBase::testImageUdder() {
   return;
 }
 
+/// \brief copy the summed receiver counters to Counters
+void LokiBase::updateReceiveStats() {
+  auto RxSum = sumReceiverCounters();
+  Counters.RxPackets = RxSum.RxPackets;
+  Counters.RxBytes = RxSum.RxBytes;
+  Counters.FifoPushErrors = RxSum.FifoPushErrors;
+  Counters.RxIdle = RxSum.RxIdle;
+  Counters.RingOverruns = RxSum.RingOverruns;
+  Counters.KernelDrops = RxSum.KernelDrops;
+}
+
 ///
 /// \brief Normal processing thread
 void LokiBase::processingThread() {
@@ -197,17 +279,45 @@ void LokiBase::processingThread() {
 
   RuntimeStat RtStat({Counters.RxPackets, Counters.Events, Counters.TxBytes});
 
+  // Each worker has its own instrument and counters, the counters are
+  // summed in the processing thread
+  struct Counters WorkerCounters[LokiPipeline::MaxWorkers];
+  memset(WorkerCounters, 0, sizeof(WorkerCounters));
+  std::unique_ptr<LokiPipeline> Pipeline;
+  if (PipelineWorkers > 0) {
+    XTRACE(INIT, ALW, "Using %u pipeline workers", PipelineWorkers);
+    auto Factory = [this, &WorkerCounters](unsigned int Worker) {
+      return std::unique_ptr<LokiInstrument>(
+          new LokiInstrument(WorkerCounters[Worker], LokiModuleSettings));
+    };
+    auto Produce = [this](uint64_t PulseTime, std::vector<ReadoutEvent> &Events) {
+      Serializer->pulseTime(PulseTime);
+      for (auto &Event : Events) {
+        Counters.TxBytes += Serializer->addEvent(Event.Time, Event.PixelId);
+      }
+      Counters.Events += Events.size();
+    };
+    Pipeline.reset(new LokiPipeline(PipelineWorkers, Factory, Produce,
+                                    1024, EFUSettings.IdleMode));
+  }
+
+  unsigned int Receiver{0};
   while (runThreads) {
-    if (InputFifo.pop(DataIndex)) { // There is data in the FIFO - do processing
-      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+    // Packets from a given source always arrive on the same receiver, so
+    // per OutputQueue sequence number checks in validate() remain valid
+    if (popInputFifos(Receiver, DataIndex)) { // There is data in the FIFO - do processing
+      ProcessingIdle.reset();
+      auto &Ringbuffer = rxRingbuffer(Receiver);
+      auto DataLen = Ringbuffer.getDataLength(DataIndex);
       if (DataLen == 0) {
         Counters.FifoSeqErrors++;
+        Ringbuffer.release(DataIndex);
         continue;
       }
 
       /// \todo use the Buffer<T> class here and in parser?
       /// \todo avoid copying by passing reference to stats like for gdgem?
-      auto DataPtr = RxRingbuffer.getDataBuffer(DataIndex);
+      auto DataPtr = Ringbuffer.getDataBuffer(DataIndex);
 
       auto Res = Loki.ESSReadoutParser.validate(DataPtr, DataLen, ReadoutParser::Loki4Amp);
       Counters.ErrorBuffer = Loki.ESSReadoutParser.Stats.ErrorBuffer;
@@ -222,22 +332,36 @@ void LokiBase::processingThread() {
       if (Res != ReadoutParser::OK) {
         XTRACE(DATA, DEB, "Error parsing ESS readout header");
         Counters.ErrorHeaders++;
+        Ringbuffer.release(DataIndex);
         continue;
       }
       XTRACE(DATA, DEB, "PulseHigh %u, PulseLow %u",
         Loki.ESSReadoutParser.Packet.HeaderPtr->PulseHigh,
         Loki.ESSReadoutParser.Packet.HeaderPtr->PulseLow);
 
-      // We have good header information, now parse readout data
-      Res = Loki.LokiParser.parse(Loki.ESSReadoutParser.Packet.DataPtr, Loki.ESSReadoutParser.Packet.DataLength);
-
-      // Process readouts, generate (end produce) events
-      Loki.processReadouts();
+      // We have good header information, now parse readout data and
+      // process readouts, generate (end produce) events
+      auto ReadoutPtr = Loki.ESSReadoutParser.Packet.DataPtr;
+      auto ReadoutLength = Loki.ESSReadoutParser.Packet.DataLength;
+      if (Pipeline) {
+        // the pipeline outlives the buffer, so readouts are copied and the
+        // sections swapped into the pipeline
+        Res = Loki.LokiParser.parse(ReadoutPtr, ReadoutLength);
+        Pipeline->addPacket(*Loki.ESSReadoutParser.Packet.HeaderPtr,
+                            Loki.LokiParser.Result);
+        Ringbuffer.release(DataIndex);
+        Pipeline->collect();
+      } else {
+        // readouts are used in place, release the buffer when done
+        Res = Loki.LokiParser.parseViews(ReadoutPtr, ReadoutLength);
+        Loki.processReadouts();
+        Ringbuffer.release(DataIndex);
+      }
 
     } else { // There is NO data in the FIFO - do stop checks and sleep a little
-      Counters.ProcessingIdle++;
-      usleep(10);
-
+      if ((not Pipeline) or (Pipeline->collect() == 0)) {
+        ProcessingIdle.idle();
+      }
     }
 
 
@@ -261,8 +385,13 @@ void LokiBase::processingThread() {
     if (ProduceTimer.timetsc() >=
         EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ) {
 
+      updateReceiveStats();
       RuntimeStatusMask =  RtStat.getRuntimeStatusMask({Counters.RxPackets, Counters.Events, Counters.TxBytes});
 
+      if (Pipeline) {
+        Pipeline->flush();
+        updatePipelineCounters(*Pipeline, WorkerCounters);
+      }
       Counters.TxBytes += Serializer->produce();
 
       /// Kafka stats update - common to all detectors
@@ -276,6 +405,7 @@ void LokiBase::processingThread() {
       ProduceTimer.now();
     }
   }
+  updateReceiveStats();
   XTRACE(INPUT, ALW, "Stopping processing thread.");
   return;
 }
@@ -10,33 +10,56 @@
 
 #include <common/Detector.h>
 #include <common/EV42Serializer.h>
+#include <common/Socket.h>
 #include <loki/Counters.h>
+#include <loki/readout/DataParser.h>
+#include <readout/ReadoutPipeline.h>
 
 namespace Loki {
 
+class LokiInstrument;
+
+/// \brief multi threaded pixel calculations, enabled by --workers
+using LokiPipeline = ReadoutPipeline<DataParser::ParsedData, LokiInstrument>;
+
 struct LokiSettings {
   std::string ConfigFile{""}; ///< panel mappings
   std::string CalibFile{""}; ///< calibration file
+  uint32_t CalibLookupBins{0}; ///< calibration lookup table, 0: polynomials
   std::string FilePrefix{""}; ///< HDF5 file dumping
   bool DetectorImage2D{false}; ///< generate pixels for 2D detector (else 3D)
+  unsigned int Workers{0}; ///< pixel calculation threads, 0: processing thread
 };
 
 
 
-class LokiBase : public Detector {
+class LokiBase : public InputDetector<> {
 public:
   LokiBase(BaseSettings const &Settings, struct LokiSettings &LocalLokiSettings);
   ~LokiBase() = default;
 
-  void inputThread();
+  /// \brief receive packets into the ringbuffer and fifo of Receiver
+  void inputThread(unsigned int Receiver = 0);
   void processingThread();
 
+  /// \brief receive loop for UDPReceiver, see also packetMmapReceiveLoop()
+  void receiveLoop(UDPReceiver &dataReceiver, unsigned int Receiver);
+
+  /// \brief copy the summed receiver counters to Counters
+  void updateReceiveStats();
+
+  /// \brief update Counters and PipelineStats from the pipeline workers
+  void updatePipelineCounters(LokiPipeline &Pipeline,
+                              struct Counters *WorkerCounters);
+
   /// \brief generate a Udder test image
   void testImageUdder();
 
 
 protected:
   struct Counters Counters;
+  unsigned int PipelineWorkers{0}; ///< 0: no ReadoutPipeline
+  ReadoutWorkerStats PipelineStats[LokiPipeline::MaxWorkers];
   LokiSettings LokiModuleSettings;
   EV42Serializer * Serializer;
 };
@@ -54,6 +54,12 @@ LokiInstrument::LokiInstrument(struct Counters & counters,
       throw std::runtime_error("Pixel mismatch");
     }
 
+    if (ModuleSettings.CalibLookupBins != 0) {
+      XTRACE(INIT, ALW, "Calibration lookup table with %u bins per straw",
+        ModuleSettings.CalibLookupBins);
+      LokiCalibration.createLookupTable(ModuleSettings.CalibLookupBins);
+    }
+
     if (!ModuleSettings.FilePrefix.empty()) {
       DumpFile = ReadoutFile::create(ModuleSettings.FilePrefix + "loki_" + timeString());
     }
@@ -71,9 +77,8 @@ LokiInstrument::~LokiInstrument() {
 ///
 /// also applies the calibration
 uint32_t LokiInstrument::calcPixel(PanelGeometry & Panel, uint8_t FEN,
-    DataParser::LokiReadout & Data) {
+    const DataParser::LokiReadout & Data) {
 
-  uint8_t TubeGroup = FEN - 1;
   uint8_t LocalTube = Data.TubeId;
 
   /// \todo debug REMOVE!
@@ -88,10 +93,18 @@ uint32_t LokiInstrument::calcPixel(PanelGeometry & Panel, uint8_t FEN,
     return 0;
   }
 
-  auto Straw = Amp2Pos.StrawId;
-  /// Position (and CalibratedPos) are per definition == X
-  double Position = Amp2Pos.PosVal; // position along the straw
+  return calcPixel(Panel, FEN, LocalTube, Amp2Pos.StrawId, Amp2Pos.PosVal);
+}
+
+/// \brief pixel from straw and position along the straw, used with the
+/// batched TubeAmps calculations
+///
+/// also applies the calibration
+uint32_t LokiInstrument::calcPixel(PanelGeometry & Panel, uint8_t FEN,
+    uint8_t LocalTube, uint8_t Straw, double Position) {
+  uint8_t TubeGroup = FEN - 1;
 
+  /// Position (and CalibratedPos) are per definition == X
   /// Globalstraw is per its definition == Y
   uint32_t GlobalStraw = Panel.getGlobalStrawId(TubeGroup, LocalTube, Straw);
   XTRACE(EVENT, DEB, "global straw: %u", GlobalStraw);
@@ -112,8 +125,8 @@ uint32_t LokiInstrument::calcPixel(PanelGeometry & Panel, uint8_t FEN,
 }
 
 
-void LokiInstrument::dumpReadoutToFile(DataParser::ParsedData & Section,
-    DataParser::LokiReadout & Data) {
+void LokiInstrument::dumpReadoutToFile(const DataParser::SectionView & Section,
+    const DataParser::LokiReadout & Data) {
   Readout CurrentReadout;
   CurrentReadout.PulseTimeHigh = ESSReadoutParser.Packet.HeaderPtr->PulseHigh;
   CurrentReadout.PulseTimeLow = ESSReadoutParser.Packet.HeaderPtr->PulseLow;
@@ -131,6 +144,71 @@ void LokiInstrument::dumpReadoutToFile(DataParser::ParsedData & Section,
 }
 
 
+/// \brief calculate the events of a single Ring/FEN section, returns
+/// false if the section doesn't match the configuration
+bool LokiInstrument::processSection(const ReadoutParser::PacketHeaderV0 & Header,
+    const DataParser::SectionView & Section, std::vector<ReadoutEvent> & Events) {
+  XTRACE(DATA, DEB, "Ring %u, FEN %u", Section.RingId, Section.FENId);
+  Time.setReference(Header.PulseHigh, Header.PulseLow);
+
+  if (Section.RingId >= LokiConfiguration.Panels.size()) {
+    XTRACE(DATA, WAR, "RINGId %d is incompatible with configuration", Section.RingId);
+    counters.MappingErrors++;
+    return false;
+  }
+
+  PanelGeometry & Panel = LokiConfiguration.Panels[Section.RingId];
+
+  if ((Section.FENId == 0) or (Section.FENId > Panel.getMaxGroup())) {
+    XTRACE(DATA, WAR, "FENId %d outside valid range 1 - %d", Section.FENId, Panel.getMaxGroup());
+    counters.MappingErrors++;
+    return false;
+  }
+
+  // Straws and positions for the whole section at once
+  unsigned int Readouts = Section.Data.size();
+  AmpA.resize(Readouts);
+  AmpB.resize(Readouts);
+  AmpC.resize(Readouts);
+  AmpD.resize(Readouts);
+  Straws.resize(Readouts);
+  Positions.resize(Readouts);
+  for (unsigned int i = 0; i < Readouts; i++) {
+    AmpA[i] = Section.Data[i].AmpA;
+    AmpB[i] = Section.Data[i].AmpB;
+    AmpC[i] = Section.Data[i].AmpC;
+    AmpD[i] = Section.Data[i].AmpD;
+  }
+  Amp2Pos.calcPositions(AmpA.data(), AmpB.data(), AmpC.data(), AmpD.data(),
+                        Readouts, Straws.data(), Positions.data());
+  counters.ReadoutsBadAmpl = Amp2Pos.Stats.AmplitudeZero;
+
+  for (unsigned int i = 0; i < Readouts; i++) {
+    auto & Data = Section.Data[i];
+    auto TimeOfFlight =  Time.getTOF(Data.TimeHigh, Data.TimeLow); // TOF in ns
+
+    XTRACE(DATA, DEB, "  Data: time (%u, %u), SeqNo %u, Tube %u, A %u, B %u, C %u, D %u",
+      Data.TimeHigh, Data.TimeLow, Data.DataSeqNum, Data.TubeId, Data.AmpA, Data.AmpB, Data.AmpC, Data.AmpD);
+
+    // Calculate pixelid and apply calibration, pixel 0 for invalid
+    // amplitudes
+    uint32_t PixelId = 0;
+    if (Straws[i] < TubeAmps::NStraws) {
+      PixelId = calcPixel(Panel, Section.FENId, Data.TubeId, Straws[i], Positions[i]);
+    }
+
+    if (PixelId == 0) {
+      counters.GeometryErrors++;
+    } else {
+      Events.push_back({TimeOfFlight, PixelId});
+    }
+  }
+  counters.ReadoutsClampLow = LokiCalibration.Stats.ClampLow;
+  counters.ReadoutsClampHigh = LokiCalibration.Stats.ClampHigh;
+  return true;
+}
+
+
 void LokiInstrument::processReadouts() {
   // Dont fake pulse time, but could do something like
   // PulseTime = 1000000000LU * (uint64_t)time(NULL); // ns since 1970
@@ -143,52 +221,23 @@ void LokiInstrument::processReadouts() {
   Serializer->pulseTime(PulseTime);
 
   /// Traverse readouts, calculate pixels
-  for (auto & Section : LokiParser.Result) {
-    XTRACE(DATA, DEB, "Ring %u, FEN %u", Section.RingId, Section.FENId);
-
-    if (Section.RingId >= LokiConfiguration.Panels.size()) {
-      XTRACE(DATA, WAR, "RINGId %d is incompatible with configuration", Section.RingId);
-      counters.MappingErrors++;
+  for (auto & Section : LokiParser.Views) {
+    Events.clear();
+    if (not processSection(*PacketHeader, Section, Events)) {
       continue;
     }
 
-    PanelGeometry & Panel = LokiConfiguration.Panels[Section.RingId];
-
-    if ((Section.FENId == 0) or (Section.FENId > Panel.getMaxGroup())) {
-      XTRACE(DATA, WAR, "FENId %d outside valid range 1 - %d", Section.FENId, Panel.getMaxGroup());
-      counters.MappingErrors++;
-      continue;
+    for (auto & Event : Events) {
+      counters.TxBytes += Serializer->addEvent(Event.Time, Event.PixelId);
+      counters.Events++;
     }
 
-    for (auto & Data : Section.Data) {
-      auto TimeOfFlight =  Time.getTOF(Data.TimeHigh, Data.TimeLow); // TOF in ns
-
-      XTRACE(DATA, DEB, "  Data: time (%u, %u), SeqNo %u, Tube %u, A %u, B %u, C %u, D %u",
-        Data.TimeHigh, Data.TimeLow, Data.DataSeqNum, Data.TubeId, Data.AmpA, Data.AmpB, Data.AmpC, Data.AmpD);
-
-      // uint64_t DataTime = Data.TimeHigh * 1000000000LU;
-      // DataTime += (uint64_t)(Data.TimeLow * NsPerClock);
-      // XTRACE(DATA, DEB, "DataTime %" PRIu64 "", DataTime);
-
-      // Calculate pixelid and apply calibration
-      uint32_t PixelId = calcPixel(Panel, Section.FENId, Data);
-
-
-      if (PixelId == 0) {
-        counters.GeometryErrors++;
-      } else {
-        counters.TxBytes += Serializer->addEvent(TimeOfFlight, PixelId);
-        counters.Events++;
-      }
-
-      if (DumpFile) {
+    if (DumpFile) {
+      for (auto & Data : Section.Data) {
         dumpReadoutToFile(Section, Data);
       }
-
     }
   } // for()
-  counters.ReadoutsClampLow = LokiCalibration.Stats.ClampLow;
-  counters.ReadoutsClampHigh = LokiCalibration.Stats.ClampHigh;
 }
 
 } // namespace
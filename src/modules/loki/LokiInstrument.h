@@ -19,6 +19,7 @@
 #include <loki/geometry/TubeAmps.h>
 #include <loki/geometry/PanelGeometry.h>
 #include <modules/readout/ReadoutParser.h>
+#include <readout/ReadoutPipeline.h>
 #include <readout/DataParser.h>
 #include <readout/ESSTime.h>
 
@@ -40,17 +41,36 @@ public:
   //
   void processReadouts();
 
+  /// \brief calculate events for one Ring/FEN section, used directly by
+  /// processReadouts() and by the ReadoutPipeline workers
+  bool processSection(const ReadoutParser::PacketHeaderV0 & Header,
+                      const DataParser::SectionView & Section,
+                      std::vector<ReadoutEvent> & Events);
+
+  /// \brief ReadoutPipeline version, the section owns its readouts
+  bool processSection(const ReadoutParser::PacketHeaderV0 & Header,
+                      DataParser::ParsedData & Section,
+                      std::vector<ReadoutEvent> & Events) {
+    return processSection(Header, {Section.RingId, Section.FENId, Section.Data}, Events);
+  }
+
 
   //
   void setSerializer(EV42Serializer * serializer) { Serializer = serializer; }
 
   /// \brief LoKI pixel calculations
   uint32_t calcPixel(PanelGeometry & Panel, uint8_t FEN,
-                     DataParser::LokiReadout & Data);
+                     const DataParser::LokiReadout & Data);
+
+  /// \brief LoKI pixel calculations from already calculated straw and
+  /// position
+  uint32_t calcPixel(PanelGeometry & Panel, uint8_t FEN, uint8_t LocalTube,
+                     uint8_t Straw, double Position);
 
 
   /// \brief writes a single readout to file
-  void dumpReadoutToFile(DataParser::ParsedData & Section, DataParser::LokiReadout & Data);
+  void dumpReadoutToFile(const DataParser::SectionView & Section,
+                         const DataParser::LokiReadout & Data);
 
 public:
   /// \brief Stuff that 'ties' LoKI together
@@ -64,6 +84,11 @@ public:
   ESSTime Time;
   EV42Serializer * Serializer;
   std::shared_ptr<ReadoutFile> DumpFile;
+  std::vector<ReadoutEvent> Events; ///< events of the current section
+  /// structure-of-arrays buffers for the batched TubeAmps calculations
+  std::vector<uint16_t> AmpA, AmpB, AmpC, AmpD;
+  std::vector<uint8_t> Straws;
+  std::vector<double> Positions;
   // uint32_t StrawHist[200]; ///< \todo debug - remove eventually
 };
 
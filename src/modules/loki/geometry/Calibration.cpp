@@ -94,7 +94,60 @@ void Calibration::nullCalibration(uint32_t Straws, uint16_t Resolution) {
   MaxPixelId = Straws * Resolution;
 }
 
+/// \brief tabulate corrections, positions are in the range 0 to
+/// StrawResolution
+void Calibration::createLookupTable(uint32_t BinsPerStraw) {
+  if ((BinsPerStraw == 0) or (StrawResolution > PositionMask)) {
+    throw std::runtime_error("Invalid calibration lookup table dimensions");
+  }
+
+  LookupBins = BinsPerStraw;
+  LookupScale = (double)BinsPerStraw / StrawResolution;
+  LookupTable.resize((size_t)NumberOfStraws * LookupBins);
+
+  for (uint32_t Straw = 0; Straw < NumberOfStraws; Straw++) {
+    for (uint32_t Bin = 0; Bin < LookupBins; Bin++) {
+      int Clamp{0};
+      double Pos = (Bin + 0.5) / LookupScale;
+      uint16_t Entry = polynomialCorrection(Straw, Pos, Clamp);
+      if (Clamp < 0) {
+        Entry |= ClampLowFlag;
+      } else if (Clamp > 0) {
+        Entry |= ClampHighFlag;
+      }
+      LookupTable[Straw * LookupBins + Bin] = Entry;
+    }
+  }
+  LOG(INIT, Sev::Info, "Loki calibration lookup table: {} straws, {} bins, {} bytes",
+      NumberOfStraws, LookupBins, lookupTableBytes());
+}
+
 uint32_t Calibration::strawCorrection(uint32_t StrawId, double Pos) {
+  if (not LookupTable.empty()) {
+    uint32_t Bin = (Pos > 0) ? (uint32_t)(Pos * LookupScale) : 0;
+    if (Bin >= LookupBins) {
+      Bin = LookupBins - 1;
+    }
+    uint16_t Entry = LookupTable[StrawId * LookupBins + Bin];
+    if (Entry & ClampLowFlag) {
+      Stats.ClampLow++;
+    } else if (Entry & ClampHighFlag) {
+      Stats.ClampHigh++;
+    }
+    return Entry & PositionMask;
+  }
+
+  int Clamp{0};
+  uint32_t CorrectedPos = polynomialCorrection(StrawId, Pos, Clamp);
+  if (Clamp < 0) {
+    Stats.ClampLow++;
+  } else if (Clamp > 0) {
+    Stats.ClampHigh++;
+  }
+  return CorrectedPos;
+}
+
+uint32_t Calibration::polynomialCorrection(uint32_t StrawId, double Pos, int &Clamp) {
   double a = StrawCalibration[StrawId][0];
   double b = StrawCalibration[StrawId][1];
   double c = StrawCalibration[StrawId][2];
@@ -105,12 +158,13 @@ uint32_t Calibration::strawCorrection(uint32_t StrawId, double Pos) {
   XTRACE(EVENT, DEB, "straw: %u, pos: %g, delta %g" , StrawId, Pos , Delta);
   double CorrectedPos = Pos - Delta;
 
+  Clamp = 0;
   if (CorrectedPos < 0) {
-    Stats.ClampLow++;
+    Clamp = -1;
     CorrectedPos = 0;
   }
   if (CorrectedPos > StrawResolution) {
-    Stats.ClampHigh++;
+    Clamp = 1;
     CorrectedPos = StrawResolution - 1;
   }
   return (uint32_t)CorrectedPos;
@@ -36,9 +36,23 @@ public:
   /// \brief return the maximum pixel id
   uint32_t getMaxPixel() { return MaxPixelId; }
 
-  /// \brief apply the position correction
+  /// \brief apply the position correction, uses the lookup table
+  /// if created
   uint32_t strawCorrection(uint32_t StrawId, double Pos);
 
+  /// \brief position correction by evaluating the polynomial, Clamp
+  /// is set to -1 (1) if the result was clamped low (high), else 0
+  uint32_t polynomialCorrection(uint32_t StrawId, double Pos, int &Clamp);
+
+  /// \brief expand the polynomials into a table of BinsPerStraw
+  /// precalculated corrections per straw, each entry is the correction
+  /// at the center of its bin. strawCorrection() then does a single
+  /// lookup. Memory use is 2 bytes per entry.
+  void createLookupTable(uint32_t BinsPerStraw);
+
+  /// \brief size of the lookup table in bytes, 0 if not created
+  size_t lookupTableBytes() { return LookupTable.size() * sizeof(uint16_t); }
+
   /// \brief vector of (vector of) polynomial coefficients
   std::vector<std::vector<double>> StrawCalibration;
 
@@ -52,5 +66,13 @@ private:
   uint16_t StrawResolution{0}; ///< resolution along a straw
   uint32_t MaxPixelId{0}; ///< The maximum pixelid in the map
 
+  /// lookup table entries hold the corrected position and clamp flags
+  static constexpr uint16_t ClampLowFlag{0x8000};
+  static constexpr uint16_t ClampHighFlag{0x4000};
+  static constexpr uint16_t PositionMask{0x3fff};
+  std::vector<uint16_t> LookupTable;
+  uint32_t LookupBins{0}; ///< entries per straw
+  double LookupScale{0}; ///< from position to bin
+
 };
 } // namespace
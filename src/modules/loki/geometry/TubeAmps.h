@@ -12,14 +12,23 @@
 
 #pragma once
 #include <common/Trace.h>
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TUBEAMPS_SIMD
+#endif
+
 // #undef TRC_LEVEL
 // #define TRC_LEVEL TRC_L_ERR
 
 namespace Loki {
 
+/// upper limits of the scaled straw value for straws 0 - 5
+constexpr double StrawLimits[] = {0.7, 1.56, 2.52, 3.54, 4.44, 5.3};
+
 class TubeAmps {
 public:
   /// \brief The four amplitudes measured at certain points in the
@@ -59,8 +68,75 @@ public:
     uint64_t AmplitudeZero{0};
   } Stats;
 
+  static constexpr std::uint8_t NStraws{7}; ///< number of straws per tube
+
+  /// \brief instruction sets for the batch calculations, the best one
+  /// supported by the CPU is selected at runtime
+  enum class Simd { None, SSE41, AVX2 };
+
+  /// \brief best instruction set supported by the CPU
+  static Simd cpuSimd() {
+#if defined(TUBEAMPS_SIMD)
+    static const Simd Supported = __builtin_cpu_supports("avx2") ? Simd::AVX2
+        : __builtin_cpu_supports("sse4.1") ? Simd::SSE41 : Simd::None;
+    return Supported;
+#else
+    return Simd::None;
+#endif
+  }
+
+  /// \brief select the batch instruction set, limited to what the CPU
+  /// supports (used by tests and benchmarks)
+  void setSimd(Simd Level) {
+    SimdLevel = std::min(Level, cpuSimd());
+  }
+
+  Simd simd() { return SimdLevel; }
+
+  /// \brief batch version of calcPositions() for Count readouts in
+  /// structure-of-arrays layout. StrawIds[i] and Positions[i] get the
+  /// values StrawId and PosVal would get for readout i, including the
+  /// out-of-range values for readouts with all zero amplitudes
+  /// \return number of valid readouts
+  unsigned int calcPositions(const std::uint16_t *AmplitudeA,
+                             const std::uint16_t *AmplitudeB,
+                             const std::uint16_t *AmplitudeC,
+                             const std::uint16_t *AmplitudeD,
+                             unsigned int Count, std::uint8_t *StrawIds,
+                             double *Positions) {
+    unsigned int i = 0;
+    unsigned int Invalid = 0;
+#if defined(TUBEAMPS_SIMD)
+    if (SimdLevel != Simd::None) {
+      i = Count & ~3U;
+      if (SimdLevel == Simd::AVX2) {
+        Invalid = calcPositionsAVX2(AmplitudeA, AmplitudeB, AmplitudeC,
+                                    AmplitudeD, i, StrawIds, Positions);
+      } else {
+        Invalid = calcPositionsSSE41(AmplitudeA, AmplitudeB, AmplitudeC,
+                                     AmplitudeD, i, StrawIds, Positions);
+      }
+    }
+#endif
+    for (; i < Count; i++) {
+      std::uint32_t Denominator = AmplitudeA[i] + AmplitudeB[i] + AmplitudeC[i] + AmplitudeD[i];
+      if (Denominator == 0) {
+        StrawIds[i] = NStraws;
+        Positions[i] = NPos;
+        Invalid++;
+        continue;
+      }
+      std::uint32_t StrawNum = AmplitudeA[i] + AmplitudeC[i];
+      std::uint32_t PosNum = AmplitudeA[i] + AmplitudeB[i];
+      StrawIds[i] = strawCalc(((NStraws - 1) * StrawNum * 1.0) / Denominator);
+      Positions[i] = ((NPos - 1) * PosNum * 1.0) / Denominator;
+    }
+    Stats.AmplitudeZero += Invalid;
+    return Count - Invalid;
+  }
+
   uint8_t strawCalc(double straw) {
-    std::vector<double> limits = {0.7, 1.56, 2.52, 3.54, 4.44, 5.3};
+    const double *limits = StrawLimits;
     if (straw <= limits[0])
       return 0;
     else if (straw <= limits[1])
@@ -78,8 +154,115 @@ public:
   }
 
 private:
-  const std::uint8_t NStraws{7}; ///< number of straws per tube
+#if defined(TUBEAMPS_SIMD)
+  // The SIMD functions are compiled for their instruction set with the
+  // target attribute, independent of the -march of the build, and are only
+  // called if cpuSimd() reports support. Count must be a multiple of 4.
+  // The straw is the number of limits below the scaled straw value, which
+  // is what strawCalc() does. Return the number of invalid readouts.
+
+  __attribute__((target("avx2")))
+  unsigned int calcPositionsAVX2(const std::uint16_t *A, const std::uint16_t *B,
+                                 const std::uint16_t *C, const std::uint16_t *D,
+                                 unsigned int Count, std::uint8_t *StrawIds,
+                                 double *Positions) {
+    unsigned int Invalid = 0;
+    for (unsigned int i = 0; i < Count; i += 4) {
+      __m128i AmpA = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(A + i)));
+      __m128i AmpB = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(B + i)));
+      __m128i AmpC = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(C + i)));
+      __m128i AmpD = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(D + i)));
+      __m128i StrawNum = _mm_add_epi32(AmpA, AmpC);
+      __m128i PosNum = _mm_add_epi32(AmpA, AmpB);
+      __m128i Denominator = _mm_add_epi32(StrawNum, _mm_add_epi32(AmpB, AmpD));
+      __m128i Zero = _mm_cmpeq_epi32(Denominator, _mm_setzero_si128());
+
+      __m256d Den = _mm256_cvtepi32_pd(Denominator);
+      __m256d Straw = _mm256_div_pd(
+          _mm256_mul_pd(_mm256_set1_pd(NStraws - 1), _mm256_cvtepi32_pd(StrawNum)), Den);
+      __m256d Pos = _mm256_div_pd(
+          _mm256_mul_pd(_mm256_set1_pd(NPos - 1), _mm256_cvtepi32_pd(PosNum)), Den);
+      __m256d One = _mm256_set1_pd(1.0);
+      __m256d StrawSum = _mm256_setzero_pd();
+      for (auto Limit : StrawLimits) {
+        __m256d Above = _mm256_cmp_pd(Straw, _mm256_set1_pd(Limit), _CMP_GT_OQ);
+        StrawSum = _mm256_add_pd(StrawSum, _mm256_and_pd(Above, One));
+      }
+      alignas(16) std::int32_t Straws[4];
+      _mm_store_si128((__m128i *)Straws, _mm256_cvtpd_epi32(StrawSum));
+      _mm256_storeu_pd(Positions + i, Pos);
+      Invalid += storeStraws4(Straws, _mm_movemask_ps(_mm_castsi128_ps(Zero)),
+                              StrawIds + i, Positions + i);
+    }
+    return Invalid;
+  }
+
+  __attribute__((target("sse4.1")))
+  unsigned int calcPositionsSSE41(const std::uint16_t *A, const std::uint16_t *B,
+                                  const std::uint16_t *C, const std::uint16_t *D,
+                                  unsigned int Count, std::uint8_t *StrawIds,
+                                  double *Positions) {
+    unsigned int Invalid = 0;
+    for (unsigned int i = 0; i < Count; i += 4) {
+      __m128i AmpA = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(A + i)));
+      __m128i AmpB = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(B + i)));
+      __m128i AmpC = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(C + i)));
+      __m128i AmpD = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(D + i)));
+      __m128i StrawNum = _mm_add_epi32(AmpA, AmpC);
+      __m128i PosNum = _mm_add_epi32(AmpA, AmpB);
+      __m128i Denominator = _mm_add_epi32(StrawNum, _mm_add_epi32(AmpB, AmpD));
+      __m128i Zero = _mm_cmpeq_epi32(Denominator, _mm_setzero_si128());
+
+      alignas(16) std::int32_t Straws[4];
+      for (int Half = 0; Half < 2; Half++) {
+        __m128d Den = _mm_cvtepi32_pd(Denominator);
+        __m128d Straw = _mm_div_pd(
+            _mm_mul_pd(_mm_set1_pd(NStraws - 1), _mm_cvtepi32_pd(StrawNum)), Den);
+        __m128d Pos = _mm_div_pd(
+            _mm_mul_pd(_mm_set1_pd(NPos - 1), _mm_cvtepi32_pd(PosNum)), Den);
+        __m128d One = _mm_set1_pd(1.0);
+        __m128d StrawSum = _mm_setzero_pd();
+        for (auto Limit : StrawLimits) {
+          __m128d Above = _mm_cmpgt_pd(Straw, _mm_set1_pd(Limit));
+          StrawSum = _mm_add_pd(StrawSum, _mm_and_pd(Above, One));
+        }
+        _mm_storel_epi64((__m128i *)(Straws + 2 * Half), _mm_cvtpd_epi32(StrawSum));
+        _mm_storeu_pd(Positions + i + 2 * Half, Pos);
+        // move the upper two readouts down
+        Denominator = _mm_srli_si128(Denominator, 8);
+        StrawNum = _mm_srli_si128(StrawNum, 8);
+        PosNum = _mm_srli_si128(PosNum, 8);
+      }
+      Invalid += storeStraws4(Straws, _mm_movemask_ps(_mm_castsi128_ps(Zero)),
+                              StrawIds + i, Positions + i);
+    }
+    return Invalid;
+  }
+
+  /// \brief copy four straws and set the out-of-range values for the
+  /// readouts in ZeroMask, returns the number of those
+  unsigned int storeStraws4(const std::int32_t *Straws, int ZeroMask,
+                            std::uint8_t *StrawIds, double *Positions) {
+    for (int i = 0; i < 4; i++) {
+      StrawIds[i] = Straws[i];
+    }
+    if (ZeroMask == 0) {
+      return 0;
+    }
+    unsigned int Invalid = 0;
+    for (int i = 0; i < 4; i++) {
+      if (ZeroMask & (1 << i)) {
+        StrawIds[i] = NStraws;
+        Positions[i] = NPos;
+        Invalid++;
+      }
+    }
+    return Invalid;
+  }
+#endif
+
   std::uint16_t NPos{512}; ///< resolution of position
+  Simd SimdLevel{cpuSimd()}; ///< used by the batch calcPositions()
 
 
 public:
@@ -187,6 +187,61 @@ TEST_F(CalibrationTest, LoadCalibConst) {
   deleteFile(StrawMappingConstFile);
 }
 
+TEST_F(CalibrationTest, LookupTableInvalid) {
+  Calibration calib;
+  calib.nullCalibration(8, 256);
+  ASSERT_ANY_THROW(calib.createLookupTable(0));
+  ASSERT_EQ(calib.lookupTableBytes(), 0);
+}
+
+TEST_F(CalibrationTest, LookupTableNull) {
+  Calibration calib;
+  uint32_t Straws{6160};
+  uint16_t Resolution{256};
+  calib.nullCalibration(Straws, Resolution);
+  calib.createLookupTable(Resolution);
+  ASSERT_EQ(calib.lookupTableBytes(), Straws * Resolution * 2);
+  for (uint32_t Straw = 0; Straw < Straws; Straw++) {
+    for (uint32_t Pos = 0; Pos < Resolution; Pos++) {
+      ASSERT_EQ(calib.strawCorrection(Straw, Pos), Pos);
+    }
+  }
+}
+
+TEST_F(CalibrationTest, LookupTableConst) {
+  saveBuffer(StrawMappingConstFile, (void *)StrawMappingConstStr.c_str(), StrawMappingConstStr.size());
+  Calibration calib = Calibration(StrawMappingConstFile);
+  calib.createLookupTable(4 * 256);
+  for (uint32_t Straw = 0; Straw < 3; Straw++) {
+    for (uint32_t Pos = 2; Pos < 256; Pos++) {
+      ASSERT_EQ(calib.strawCorrection(Straw, Pos), Pos - Straw);
+    }
+  }
+  deleteFile(StrawMappingConstFile);
+}
+
+TEST_F(CalibrationTest, LookupTableClampLowAndHigh) {
+  saveBuffer(StrawMappingNullFile, (void *)StrawMappingNullStr.c_str(), StrawMappingNullStr.size());
+  Calibration calib = Calibration(StrawMappingNullFile);
+  calib.StrawCalibration[0][0] = 100.0;
+  calib.StrawCalibration[1][0] = -2000;
+  calib.createLookupTable(256);
+
+  ASSERT_EQ(calib.strawCorrection(0, 5.0), 0);
+  ASSERT_EQ(calib.Stats.ClampLow, 1);
+  ASSERT_EQ(calib.strawCorrection(1, 5.0), 255);
+  ASSERT_EQ(calib.Stats.ClampHigh, 1);
+  deleteFile(StrawMappingNullFile);
+}
+
+// positions outside the straw use the first and last bins
+TEST_F(CalibrationTest, LookupTableOutsideStraw) {
+  Calibration calib;
+  calib.nullCalibration(8, 256);
+  calib.createLookupTable(512);
+  ASSERT_EQ(calib.strawCorrection(0, -1.0), 0);
+  ASSERT_EQ(calib.strawCorrection(0, 1000.0), 255);
+}
 
 TEST_F(CalibrationTest, NOTJson) {
   saveBuffer(NotJsonFile, (void *)NotJsonStr.c_str(), NotJsonStr.size());
@@ -115,6 +115,48 @@ TEST_F(DataParserTest, MultipleDataPackets) {
   ASSERT_EQ(Parser.Result.size(), 2);
 }
 
+TEST_F(DataParserTest, ReuseSectionVectors) {
+  Parser.parse((char *)&Ok2xThreeLokiReadouts[0], Ok2xThreeLokiReadouts.size());
+  ASSERT_EQ(Parser.Result.size(), 2);
+  auto FirstData = Parser.Result[0].Data.data();
+
+  // fewer sections shrink Result, remaining vectors keep their storage
+  Parser.parse((char *)&OkThreeLokiReadouts[0], OkThreeLokiReadouts.size());
+  ASSERT_EQ(Parser.Result.size(), 1);
+  ASSERT_EQ(Parser.Result[0].Data.size(), 3);
+  ASSERT_EQ(Parser.Result[0].Data.data(), FirstData);
+
+  Parser.parse((char *)&Ok2xThreeLokiReadouts[0], Ok2xThreeLokiReadouts.size());
+  ASSERT_EQ(Parser.Result.size(), 2);
+  ASSERT_EQ(Parser.Result[0].Data.data(), FirstData);
+  ASSERT_EQ(Parser.Result[1].Data.size(), 3);
+}
+
+TEST_F(DataParserTest, ParseViews) {
+  auto Res = Parser.parseViews((char *)&Ok2xThreeLokiReadouts[0],
+                               Ok2xThreeLokiReadouts.size());
+  ASSERT_EQ(Res, 6);
+  ASSERT_EQ(Parser.Stats.Readouts, 6);
+  ASSERT_EQ(Parser.Stats.Headers, 2);
+  ASSERT_EQ(Parser.Result.size(), 0);
+  ASSERT_EQ(Parser.Views.size(), 2);
+
+  // views refer to the readouts in the buffer, same data as parse()
+  Parser.parse((char *)&Ok2xThreeLokiReadouts[0], Ok2xThreeLokiReadouts.size());
+  for (unsigned int i = 0; i < Parser.Views.size(); i++) {
+    auto &View = Parser.Views[i];
+    auto &Section = Parser.Result[i];
+    ASSERT_EQ(View.RingId, Section.RingId);
+    ASSERT_EQ(View.FENId, Section.FENId);
+    ASSERT_EQ(View.Data.size(), 3);
+    ASSERT_EQ((char *)View.Data.data() - (char *)&Ok2xThreeLokiReadouts[0],
+              4 + i * (4 + 3 * 20));
+    for (unsigned int j = 0; j < View.Data.size(); j++) {
+      ASSERT_EQ(memcmp(&View.Data[j], &Section.Data[j], 20), 0);
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
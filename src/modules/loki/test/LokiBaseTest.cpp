@@ -178,6 +178,40 @@ TEST_F(LokiBaseTest, DataReceiveGood) {
   EXPECT_EQ(Readout.Counters.kafka_ev_errors, 2);
 }
 
+TEST_F(LokiBaseTest, DataReceiveBatched) {
+  Settings.DetectorPort = 9002;
+  Settings.ReceiveBatchSize = 16;
+  LokiBaseStandIn Readout(Settings, LocalSettings);
+  Readout.startThreads();
+
+  std::this_thread::sleep_for(SleepTime);
+  TestUDPServer Server(43128, Settings.DetectorPort, (unsigned char *)&TestPacket2[0], TestPacket2.size());
+  Server.startPacketTransmission(10, 100);
+  std::this_thread::sleep_for(SleepTime);
+  Readout.stopThreads();
+  EXPECT_EQ(Readout.Counters.RxPackets, 10);
+  EXPECT_EQ(Readout.Counters.RxBytes, 10 * TestPacket2.size());
+  EXPECT_EQ(Readout.Counters.FifoPushErrors, 0);
+  EXPECT_EQ(Readout.Counters.Readouts, 70);
+}
+
+TEST_F(LokiBaseTest, DataReceiveMultipleReceivers) {
+  Settings.DetectorPort = 9003;
+  Settings.ReceiverThreads = 2;
+  LokiBaseStandIn Readout(Settings, LocalSettings);
+  EXPECT_EQ(Readout.Threads.size(), 3);
+  Readout.startThreads();
+
+  std::this_thread::sleep_for(SleepTime);
+  TestUDPServer Server(43129, Settings.DetectorPort, (unsigned char *)&TestPacket2[0], TestPacket2.size());
+  Server.startPacketTransmission(10, 100);
+  std::this_thread::sleep_for(SleepTime);
+  Readout.stopThreads();
+  EXPECT_EQ(Readout.Counters.RxPackets, 10);
+  EXPECT_EQ(Readout.Counters.RxBytes, 10 * TestPacket2.size());
+  EXPECT_EQ(Readout.Counters.Readouts, 70);
+}
+
 int main(int argc, char **argv) {
   std::string filename{"deleteme_loki.json"};
   saveBuffer(filename, (void *)lokijson.c_str(), lokijson.size());
@@ -90,6 +90,26 @@ TEST_F(LokiInstrumentTest, PixelMismatch) {
   ASSERT_ANY_THROW(LokiInstrument Loki(counters, ModuleSettings));
 }
 
+TEST_F(LokiInstrumentTest, ProcessSectionMappingErrors) {
+  memset(&counters, 0, sizeof(counters));
+  LokiInstrument Loki(counters, ModuleSettings);
+  ReadoutParser::PacketHeaderV0 Header{};
+  std::vector<ReadoutEvent> Events;
+
+  DataParser::ParsedData BadRing{1, 1, {}};
+  ASSERT_FALSE(Loki.processSection(Header, BadRing, Events));
+  ASSERT_EQ(counters.MappingErrors, 1);
+
+  DataParser::ParsedData BadFEN{0, 0, {}};
+  ASSERT_FALSE(Loki.processSection(Header, BadFEN, Events));
+  ASSERT_EQ(counters.MappingErrors, 2);
+
+  DataParser::ParsedData Valid{0, 1, {}};
+  ASSERT_TRUE(Loki.processSection(Header, Valid, Events));
+  ASSERT_EQ(counters.MappingErrors, 2);
+  ASSERT_EQ(Events.size(), 0);
+}
+
 int main(int argc, char **argv) {
   saveBuffer(ConfigFile, (void *)ConfigStr.c_str(), ConfigStr.size());
   saveBuffer(Config512File, (void *)Config512Str.c_str(), Config512Str.size());
@@ -0,0 +1,71 @@
+// Copyright (C) 2021 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Compare single readout and batched (SIMD) straw and position
+/// calculations in TubeAmps
+///
+//===----------------------------------------------------------------------===//
+
+#include <benchmark/benchmark.h>
+#include <common/BenchmarkUtil.h>
+#include <loki/geometry/TubeAmps.h>
+#include <vector>
+
+using namespace Loki;
+
+// typical number of readouts in a LoKI Ring/FEN section
+const unsigned int Readouts{400};
+
+struct Amplitudes {
+  Amplitudes() : A(Readouts), B(Readouts), C(Readouts), D(Readouts) {
+    for (unsigned int i = 0; i < Readouts; i++) {
+      A[i] = (i * 37) % 4096;
+      B[i] = (i * 101) % 4096;
+      C[i] = (i * 13) % 4096;
+      D[i] = (i * 59) % 4096;
+    }
+  }
+  std::vector<uint16_t> A, B, C, D;
+};
+
+static void TubeAmpsSingle(benchmark::State &state) {
+  Amplitudes Amps;
+  TubeAmps Tube;
+  Tube.setResolution(512);
+  uint64_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    for (unsigned int i = 0; i < Readouts; i++) {
+      Tube.calcPositions(Amps.A[i], Amps.B[i], Amps.C[i], Amps.D[i]);
+      ::benchmark::DoNotOptimize(Tube.StrawId);
+      ::benchmark::DoNotOptimize(Tube.PosVal);
+    }
+    Total += Readouts;
+  });
+  state.SetItemsProcessed(Total);
+}
+BENCHMARK(TubeAmpsSingle);
+
+static void TubeAmpsBatch(benchmark::State &state, TubeAmps::Simd Level) {
+  Amplitudes Amps;
+  TubeAmps Tube;
+  Tube.setResolution(512);
+  Tube.setSimd(Level);
+  std::vector<uint8_t> Straws(Readouts);
+  std::vector<double> Positions(Readouts);
+  uint64_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    Tube.calcPositions(Amps.A.data(), Amps.B.data(), Amps.C.data(),
+                       Amps.D.data(), Readouts, Straws.data(),
+                       Positions.data());
+    ::benchmark::ClobberMemory();
+    Total += Readouts;
+  });
+  state.SetItemsProcessed(Total);
+}
+BENCHMARK_CAPTURE(TubeAmpsBatch, scalar, TubeAmps::Simd::None);
+BENCHMARK_CAPTURE(TubeAmpsBatch, sse41, TubeAmps::Simd::SSE41);
+BENCHMARK_CAPTURE(TubeAmpsBatch, avx2, TubeAmps::Simd::AVX2);
+
+BENCHMARK_MAIN();
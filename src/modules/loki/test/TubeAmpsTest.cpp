@@ -87,6 +87,51 @@ TEST_F(TubeAmpsTest, MinMaxPos) {
   }
 }
 
+// batch results must be identical to the single readout calculations for
+// every instruction set the CPU supports
+TEST_F(TubeAmpsTest, BatchSameAsSingle) {
+  const unsigned int Count{1003}; // not a multiple of the SIMD width
+  std::vector<uint16_t> A(Count), B(Count), C(Count), D(Count);
+  for (unsigned int i = 0; i < Count; i++) {
+    A[i] = (i * 37) % 4096;
+    B[i] = (i * 101) % 4096;
+    C[i] = (i * 13) % 4096;
+    D[i] = (i * 59) % 4096;
+    if (i % 10 == 0) {
+      A[i] = B[i] = C[i] = D[i] = 0;
+    }
+  }
+
+  for (auto Level : {TubeAmps::Simd::None, TubeAmps::Simd::SSE41,
+                     TubeAmps::Simd::AVX2}) {
+    TubeAmps Single;
+    TubeAmps Batch;
+    Single.setResolution(512);
+    Batch.setResolution(512);
+    Batch.setSimd(Level);
+    ASSERT_LE(Batch.simd(), Level);
+
+    std::vector<uint8_t> Straws(Count);
+    std::vector<double> Positions(Count);
+    auto Valid = Batch.calcPositions(A.data(), B.data(), C.data(), D.data(),
+                                     Count, Straws.data(), Positions.data());
+    ASSERT_EQ(Valid, Count - 101);
+    ASSERT_EQ(Batch.Stats.AmplitudeZero, 101);
+
+    for (unsigned int i = 0; i < Count; i++) {
+      Single.calcPositions(A[i], B[i], C[i], D[i]);
+      ASSERT_EQ(Straws[i], Single.StrawId);
+      ASSERT_EQ(Positions[i], Single.PosVal);
+    }
+    ASSERT_EQ(Single.Stats.AmplitudeZero, 101);
+  }
+}
+
+TEST_F(TubeAmpsTest, DefaultSimdIsCpuSimd) {
+  TubeAmps Tube;
+  ASSERT_EQ(Tube.simd(), TubeAmps::cpuSimd());
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,81 @@
+// Copyright (C) 2021 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Compare the LoKI calibration lookup table with the polynomials
+///
+/// For each table size the corrected positions from the table and from
+/// the polynomials are compared for all straws at SamplesPerPosition
+/// positions per unit along the straw. The worst case deviation, its
+/// straw and position, and the fraction of differing results are
+/// reported along with the memory used by the table.
+//===----------------------------------------------------------------------===//
+
+#include <CLI/CLI.hpp>
+#include <cinttypes>
+#include <cstdlib>
+#include <loki/geometry/Calibration.h>
+#include <string>
+#include <vector>
+// GCOVR_EXCL_START
+
+struct {
+  std::string CalibFile{""};
+  std::vector<uint32_t> Bins; ///< table sizes (bins per straw) to check
+  uint32_t SamplesPerPosition{16};
+} Settings;
+
+CLI::App app{"Check LoKI calibration lookup table against polynomials"};
+
+int main(int argc, char *argv[]) {
+  app.add_option("-f, --file", Settings.CalibFile, "LoKI calibration (json) file")->required();
+  app.add_option("-b, --bins", Settings.Bins, "Bins per straw (default: 1, 2 and 4 x resolution)");
+  app.add_option("-s, --samples", Settings.SamplesPerPosition, "Samples per position unit");
+  CLI11_PARSE(app, argc, argv);
+
+  Loki::Calibration Calib(Settings.CalibFile);
+  uint32_t Straws = Calib.StrawCalibration.size();
+  uint32_t Resolution = Calib.getMaxPixel() / Straws;
+
+  if (Settings.Bins.empty()) {
+    Settings.Bins = {Resolution, 2 * Resolution, 4 * Resolution};
+  }
+
+  printf("Straws %u, resolution %u, %u samples per position\n", Straws,
+         Resolution, Settings.SamplesPerPosition);
+  printf("%10s %12s %12s %12s %8s %10s\n", "bins", "bytes", "differ (%)",
+         "max dev", "straw", "position");
+
+  for (auto Bins : Settings.Bins) {
+    Calib.createLookupTable(Bins);
+
+    uint64_t Samples{0};
+    uint64_t Differ{0};
+    uint32_t MaxDeviation{0};
+    uint32_t WorstStraw{0};
+    double WorstPos{0};
+    for (uint32_t Straw = 0; Straw < Straws; Straw++) {
+      for (uint32_t i = 0; i < Resolution * Settings.SamplesPerPosition; i++) {
+        double Pos = (double)i / Settings.SamplesPerPosition;
+        int Clamp;
+        int64_t Polynomial = Calib.polynomialCorrection(Straw, Pos, Clamp);
+        int64_t Table = Calib.strawCorrection(Straw, Pos);
+        uint32_t Deviation = std::abs(Table - Polynomial);
+        Samples++;
+        if (Deviation != 0) {
+          Differ++;
+        }
+        if (Deviation > MaxDeviation) {
+          MaxDeviation = Deviation;
+          WorstStraw = Straw;
+          WorstPos = Pos;
+        }
+      }
+    }
+    printf("%10u %12zu %12.4f %12u %8u %10.4f\n", Bins, Calib.lookupTableBytes(),
+           100.0 * Differ / Samples, MaxDeviation, WorstStraw, WorstPos);
+  }
+  return 0;
+}
+// GCOVR_EXCL_STOP
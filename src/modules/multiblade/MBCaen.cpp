@@ -23,6 +23,34 @@ void SetCLIArguments(CLI::App __attribute__((unused)) & parser) {
   parser.add_option("--h5filesplit", LocalMBCAENSettings.H5SplitTime,
                     "Specify interval to split HDF5 files")
                     ->group("MBCAEN");
+
+  parser.add_option("--flush_horizon", LocalMBCAENSettings.FlushHorizon,
+                    "Keep clusters within this time (ticks) of the newest readout open between packets (0: close all)")
+                    ->group("MBCAEN");
+
+  parser.add_flag("--ordered_matcher", LocalMBCAENSettings.OrderedMatcher,
+                    "Keep unmatched clusters in an ordered queue instead of sorting them for every match")
+                    ->group("MBCAEN");
+
+  parser.add_flag("--radix_sort", LocalMBCAENSettings.RadixSort,
+                    "Sort hits with a radix sort instead of std::sort")
+                    ->group("MBCAEN");
+
+  parser.add_flag("--arena", LocalMBCAENSettings.ArenaAllocator,
+                    "Allocate hits, clusters and events from per thread arenas, recycled after every packet")
+                    ->group("MBCAEN");
+
+  parser.add_option("--workers", LocalMBCAENSettings.Workers,
+                    "Threads for per-cassette event building (0: use processing thread)")
+                    ->group("MBCAEN");
+
+  parser.add_flag("--deterministic", LocalMBCAENSettings.DeterministicWorkers,
+                    "Send events from workers in packet order instead of merged by time")
+                    ->group("MBCAEN");
+
+  parser.add_option("--merge_latency", LocalMBCAENSettings.MergeLatency,
+                    "Hold back events from workers until they are this much (ticks) older than the slowest worker")
+                    ->group("MBCAEN");
 }
 
 PopulateCLIParser PopulateParser{SetCLIArguments};
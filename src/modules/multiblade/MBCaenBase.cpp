@@ -40,7 +40,7 @@ namespace Multiblade {
 const char *classname = "Multiblade detector with CAEN readout";
 
 CAENBase::CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAENSettings)
-    : Detector("MBCAEN", settings), MBCAENSettings(LocalMBCAENSettings) {
+    : InputDetector("MBCAEN", settings), MBCAENSettings(LocalMBCAENSettings) {
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -51,6 +51,7 @@ CAENBase::CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAE
   Stats.create("receive.idle", Counters.RxIdle);
   Stats.create("receive.dropped", Counters.FifoPushErrors);
   Stats.create("receive.fifo_seq_errors", Counters.FifoSeqErrors);
+  Stats.create("receive.ring_overruns", Counters.RingOverruns);
 
   Stats.create("readouts.count", Counters.ReadoutsCount);
   Stats.create("readouts.count_valid", Counters.ReadoutsGood);
@@ -63,7 +64,11 @@ CAENBase::CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAE
   Stats.create("readouts.error_bytes", Counters.ReadoutsErrorBytes);
   Stats.create("readouts.seq_errors", Counters.ReadoutsSeqErrors);
 
-  Stats.create("thread.processing_idle", Counters.ProcessingIdle);
+  Stats.create("thread.processing_idle_spin", ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield", ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause", ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep", ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing", Counters.RxMemoryBacking);
 
   Stats.create("events.count", Counters.Events);
   Stats.create("events.udder", Counters.EventsUdder);
@@ -76,6 +81,19 @@ CAENBase::CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAE
 
   Stats.create("transmit.bytes", Counters.TxBytes);
 
+  Workers = std::min(MBCAENSettings.Workers, CassetteWorkers::MaxWorkers);
+  for (unsigned int Worker = 0; Worker < Workers; Worker++) {
+    std::string Name = "pipeline.worker" + std::to_string(Worker) + ".";
+    Stats.create(Name + "packets", WorkerStats[Worker].Packets);
+    Stats.create(Name + "hits", WorkerStats[Worker].Hits);
+    Stats.create(Name + "events", WorkerStats[Worker].Events);
+    Stats.create(Name + "queue_depth", WorkerStats[Worker].QueueDepth);
+    Stats.create(Name + "arena_chunks", WorkerArenaStats[Worker].Chunks);
+    Stats.create(Name + "arena_high_water_chunks", WorkerArenaStats[Worker].HighWaterChunks);
+    Stats.create(Name + "arena_high_water_bytes", WorkerArenaStats[Worker].HighWaterBytes);
+    Stats.create(Name + "arena_fallback_count", WorkerArenaStats[Worker].FallbackCount);
+  }
+
   /// \todo below stats are common to all detectors and could/should be moved
   Stats.create("kafka.produce_fails", Counters.kafka_produce_fails);
   Stats.create("kafka.ev_errors", Counters.kafka_ev_errors);
@@ -83,19 +101,33 @@ CAENBase::CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAE
   Stats.create("kafka.dr_errors", Counters.kafka_dr_errors);
   Stats.create("kafka.dr_others", Counters.kafka_dr_noerrors);
 
+  if (EFUSettings.HugePages) {
+    HitVectorStorage::pin(EFUSettings.NumaNode);
+    ClusterPoolStorage::pin(EFUSettings.NumaNode);
+  }
+
   Stats.create("memory.hitvec_storage.alloc_count", HitVectorStorage::Pool->Stats.AllocCount);
   Stats.create("memory.hitvec_storage.alloc_bytes", HitVectorStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.hitvec_storage.dealloc_count", HitVectorStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.hitvec_storage.dealloc_bytes", HitVectorStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.hitvec_storage.malloc_fallback_count", HitVectorStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.hitvec_storage.backing", HitVectorStorage::Pool->MemoryBacking);
 
   Stats.create("memory.cluster_storage.alloc_count", ClusterPoolStorage::Pool->Stats.AllocCount);
   Stats.create("memory.cluster_storage.alloc_bytes", ClusterPoolStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.cluster_storage.dealloc_count", ClusterPoolStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.cluster_storage.dealloc_bytes", ClusterPoolStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.cluster_storage.malloc_fallback_count", ClusterPoolStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.cluster_storage.backing", ClusterPoolStorage::Pool->MemoryBacking);
+
+  Stats.create("memory.arena.alloc_count", ProcessingArena.Stats.AllocCount);
+  Stats.create("memory.arena.chunks", ProcessingArena.Stats.Chunks);
+  Stats.create("memory.arena.high_water_chunks", ProcessingArena.Stats.HighWaterChunks);
+  Stats.create("memory.arena.high_water_bytes", ProcessingArena.Stats.HighWaterBytes);
+  Stats.create("memory.arena.fallback_count", ProcessingArena.Stats.FallbackCount);
 
   // clang-format on
+  Counters.RxMemoryBacking = rxMemoryBacking(); // 2 is huge pages
 
   std::function<void()> inputFunc = [this]() { CAENBase::input_thread(); };
   Detector::AddThreadFunction(inputFunc, "input");
@@ -124,26 +156,33 @@ void CAENBase::input_thread() {
   receiver.printBufferSizes();
   receiver.setRecvTimeout(0, 100000); /// secs, usecs 1/10s
 
+  auto &RxStats = RxCounters[0];
   for (;;) {
-    int readSize;
-    unsigned int rxBufferIndex = RxRingbuffer.getDataIndex();
-
-    /** this is the processing step */
-    RxRingbuffer.setDataLength(rxBufferIndex, 0);
-    if ((readSize = receiver.receive(RxRingbuffer.getDataBuffer(rxBufferIndex),
-                                   RxRingbuffer.getMaxBufSize())) > 0) {
-      RxRingbuffer.setDataLength(rxBufferIndex, readSize);
-      XTRACE(INPUT, DEB, "Received an udp packet of length %d bytes", readSize);
-      Counters.RxPackets++;
-      Counters.RxBytes += readSize;
-
-      if (InputFifo.push(rxBufferIndex) == false) {
-        Counters.FifoPushErrors++;
+    if (EFUSettings.ReceiveBatchSize > 1) {
+      receiveBatch(receiver, 0);
+    } else if (RxRingbuffer.acquire() == 0) { // still owned by processing
+      usleep(10);
+    } else {
+      int readSize;
+      unsigned int rxBufferIndex = RxRingbuffer.getDataIndex();
+
+      /** this is the processing step */
+      RxRingbuffer.setDataLength(rxBufferIndex, 0);
+      if ((readSize = receiver.receive(RxRingbuffer.getDataBuffer(rxBufferIndex),
+                                     RxRingbuffer.getMaxBufSize())) > 0) {
+        RxRingbuffer.setDataLength(rxBufferIndex, readSize);
+        XTRACE(INPUT, DEB, "Received an udp packet of length %d bytes", readSize);
+        RxStats.RxPackets++;
+        RxStats.RxBytes += readSize;
+
+        if (InputFifo.push(rxBufferIndex) == false) {
+          RxStats.FifoPushErrors++;
+        } else {
+          RxRingbuffer.commit();
+        }
       } else {
-        RxRingbuffer.getNextBuffer();
+        RxStats.RxIdle++;
       }
-    } else {
-      Counters.RxIdle++;
     }
 
     // Checking for exit
@@ -154,6 +193,26 @@ void CAENBase::input_thread() {
   }
 }
 
+/// \brief copy the receiver counters to Counters
+void CAENBase::updateReceiveStats() {
+  auto RxSum = sumReceiverCounters();
+  Counters.RxPackets = RxSum.RxPackets;
+  Counters.RxBytes = RxSum.RxBytes;
+  Counters.RxIdle = RxSum.RxIdle;
+  Counters.FifoPushErrors = RxSum.FifoPushErrors;
+  Counters.RingOverruns = RxSum.RingOverruns;
+}
+
+void CAENBase::updateWorkerStats(CassetteWorkers *Pool) {
+  if (Pool == nullptr) {
+    return;
+  }
+  for (unsigned int Worker = 0; Worker < Pool->workers(); Worker++) {
+    WorkerStats[Worker] = Pool->workerStats(Worker);
+    WorkerArenaStats[Worker] = Pool->arenaStats(Worker);
+  }
+}
+
 void CAENBase::processing_thread() {
   const uint16_t ncass = MultibladeConfig.getCassettes();
   const uint16_t nwires = MultibladeConfig.getWires();
@@ -206,7 +265,69 @@ void CAENBase::processing_thread() {
   HistogramSerializer histfb(histograms.needed_buffer_size(), "multiblade");
   histfb.set_callback(ProduceHist);
 
+  // filters and pixel calculation for a single event, called with the
+  // events of a cassette or with the events from the CassetteWorkers
+  auto processEvent = [&](const Event &e) {
+    if (!e.both_planes()) {
+      XTRACE(EVENT, INF, "Event No Coincidence %s", e.to_string({}, true).c_str());
+      Counters.EventsNoCoincidence++;
+      return;
+    }
+
+    // \todo parametrize maximum time span - in opts?
+    if (MultibladeConfig.filter_time_span && (e.time_span() > MultibladeConfig.filter_time_span_value)) {
+      XTRACE(EVENT, INF, "Event filter time_span %s", e.to_string({}, true).c_str());
+      Counters.FiltersMaxTimeSpan++;
+      return;
+    }
+
+    if ((e.ClusterA.coord_span() > e.ClusterA.hit_count()) && (e.ClusterB.coord_span() > e.ClusterB.hit_count())) {
+      XTRACE(EVENT, INF, "Event Chs not adjacent %s", e.to_string({}, true).c_str());
+      Counters.EventsNotAdjacent++;
+      return;
+    }
+
+    // // \todo are these always wires && strips respectively?
+    // if (filter_multiplicity &&
+    //     ((e.cluster1.hit_count() > 5) || (e.cluster2.hit_count() > 10))) {
+    //   Counters.FiltersMaxMulti1++;
+    //   return;
+    // }
+    // if (filter_multiplicity2 &&
+    //     ((e.cluster1.hit_count() > 3) || (e.cluster2.hit_count() > 4))) {
+    //   Counters.FiltersMaxMulti2++;
+    //   return;
+    // }
+
+    XTRACE(EVENT, INF, "Event Valid\n %s", e.to_string({}, true).c_str());
+    // calculate local x and y using center of mass
+    auto x = static_cast<uint16_t>(std::round(e.ClusterA.coord_center()));
+    auto y = static_cast<uint16_t>(std::round(e.ClusterB.coord_center()));
+
+    // calculate local x and y using center of span
+//        auto x = (e.cluster1.coord_start() + e.cluster1.coord_end()) / 2;
+//        auto y = (e.cluster2.coord_start() + e.cluster2.coord_end()) / 2;
+
+    // \todo improve this
+    auto time = e.time_start() * MultibladeConfig.TimeTickNS; // TOF in ns
+    auto pixel_id = essgeom.pixel2D(x, y);
+    XTRACE(EVENT, DEB, "time: %u, x %u, y %u, pixel %u", time, x, y, pixel_id);
+
+    if (pixel_id == 0) {
+      Counters.GeometryErrors++;
+    } else {
+      Counters.TxBytes += flatbuffer.addEvent(time, pixel_id);
+      Counters.Events++;
+    }
+  };
+
+  auto SortMethod = MBCAENSettings.RadixSort ? HitSort::Radix : HitSort::StdSort;
   std::vector<EventBuilder> builders(ncass);
+  for (auto &builder : builders) {
+    builder.setFlushHorizon(MBCAENSettings.FlushHorizon);
+    builder.setSortMethod(SortMethod);
+    builder.matcher.set_ordered_queue(MBCAENSettings.OrderedMatcher);
+  }
 
   DataParser parser;
   auto digitisers = MultibladeConfig.getDigitisers();
@@ -250,6 +371,42 @@ void CAENBase::processing_thread() {
   }
 
 
+  // Per-cassette event building on worker threads, events are handed
+  // back to processEvent() in the processing thread
+  std::unique_ptr<CassetteWorkers> Pool;
+  std::vector<Hit> PacketHits;
+  if (Workers > 0) {
+    XTRACE(PROCESS, ALW, "Using %u event building workers", Workers);
+    Pool.reset(new CassetteWorkers(Workers, ncass, processEvent,
+                                   MBCAENSettings.DeterministicWorkers, 256,
+                                   EFUSettings.IdleMode));
+    Pool->setFlushHorizon(MBCAENSettings.FlushHorizon);
+    Pool->setMergeLatency(MBCAENSettings.MergeLatency);
+    Pool->setSortMethod(SortMethod);
+    Pool->setOrderedMatcher(MBCAENSettings.OrderedMatcher);
+    Pool->setArena(MBCAENSettings.ArenaAllocator);
+  }
+
+  // without workers the builders allocate from the processing thread arena
+  bool UseArena = MBCAENSettings.ArenaAllocator and not Pool;
+  ArenaScope Scope(UseArena ? &ProcessingArena : nullptr);
+
+  // close all clusters of a cassette. With a flush horizon this is the only
+  // way clusters of a cassette without further packets are completed
+  auto flushCassette = [&](uint16_t cassette) {
+    if (Pool) {
+      Pool->addFlush(cassette);
+      return;
+    }
+    builders[cassette].flushAll();
+    for (const auto &e : builders[cassette].Events) {
+      processEvent(e);
+    }
+    builders[cassette].Events.clear();
+  };
+  // cassettes which received packets since the last update interval
+  std::vector<bool> CassetteActive(ncass, false);
+
   unsigned int data_index;
   TSCTimer produce_timer;
   Timer h5flushtimer;
@@ -258,9 +415,11 @@ void CAENBase::processing_thread() {
 
   while (true) {
     if (InputFifo.pop(data_index)) { // There is data in the FIFO - do processing
+      ProcessingIdle.reset();
       auto datalen = RxRingbuffer.getDataLength(data_index);
       if (datalen == 0) {
         Counters.FifoSeqErrors++;
+        RxRingbuffer.release(data_index);
         continue;
       }
 
@@ -269,6 +428,7 @@ void CAENBase::processing_thread() {
       if (parser.parse(dataptr, datalen) < 0) {
         Counters.ReadoutsErrorBytes += parser.Stats.error_bytes;
         Counters.ReadoutsErrorVersion += parser.Stats.error_version;
+        RxRingbuffer.release(data_index);
         continue;
       }
       Counters.ReadoutsSeqErrors += parser.Stats.seq_errors;
@@ -290,8 +450,12 @@ void CAENBase::processing_thread() {
       if (cassette < 0) {
         XTRACE(DATA, WAR, "Invalid digitizerId: %d",
                parser.MBHeader->digitizerID);
+        RxRingbuffer.release(data_index);
         continue;
       }
+      // readouts are copied by the parser, the header is no longer used
+      RxRingbuffer.release(data_index);
+      CassetteActive[cassette] = true;
 
       for (const auto &dp : parser.readouts) {
 
@@ -327,72 +491,34 @@ void CAENBase::processing_thread() {
 
         XTRACE(DATA, DEB, "time %lu, channel %u, adc %u", dp.local_time, dp.channel, dp.adc);
 
-        builders[cassette].insert({dp.local_time, coord, dp.adc, plane});
+        if (Pool) {
+          PacketHits.push_back({dp.local_time, coord, dp.adc, plane});
+        } else {
+          builders[cassette].insert({dp.local_time, coord, dp.adc, plane});
+        }
 
         XTRACE(DATA, DEB, "Readout (%s) -> cassette=%d plane=%d coord=%d",
                dp.debug().c_str(), cassette, plane, coord);
       }
 
-      builders[cassette].flush();
-      for (const auto &e : builders[cassette].Events) {
-
-        if (!e.both_planes()) {
-          XTRACE(EVENT, INF, "Event No Coincidence %s", e.to_string({}, true).c_str());
-          Counters.EventsNoCoincidence++;
-          continue;
-        }
-
-        // \todo parametrize maximum time span - in opts?
-        if (MultibladeConfig.filter_time_span && (e.time_span() > MultibladeConfig.filter_time_span_value)) {
-          XTRACE(EVENT, INF, "Event filter time_span %s", e.to_string({}, true).c_str());
-          Counters.FiltersMaxTimeSpan++;
-          continue;
+      if (Pool) {
+        Pool->addPacket(cassette, PacketHits);
+        Pool->collect();
+      } else {
+        builders[cassette].flush();
+        for (const auto &e : builders[cassette].Events) {
+          processEvent(e);
         }
-
-        if ((e.ClusterA.coord_span() > e.ClusterA.hit_count()) && (e.ClusterB.coord_span() > e.ClusterB.hit_count())) {
-          XTRACE(EVENT, INF, "Event Chs not adjacent %s", e.to_string({}, true).c_str());
-          Counters.EventsNotAdjacent++;
-          continue;
-        }
-
-        // // \todo are these always wires && strips respectively?
-        // if (filter_multiplicity &&
-        //     ((e.cluster1.hit_count() > 5) || (e.cluster2.hit_count() > 10))) {
-        //   Counters.FiltersMaxMulti1++;
-        //   continue;
-        // }
-        // if (filter_multiplicity2 &&
-        //     ((e.cluster1.hit_count() > 3) || (e.cluster2.hit_count() > 4))) {
-        //   Counters.FiltersMaxMulti2++;
-        //   continue;
-        // }
-
-        XTRACE(EVENT, INF, "Event Valid\n %s", e.to_string({}, true).c_str());
-        // calculate local x and y using center of mass
-        auto x = static_cast<uint16_t>(std::round(e.ClusterA.coord_center()));
-        auto y = static_cast<uint16_t>(std::round(e.ClusterB.coord_center()));
-
-        // calculate local x and y using center of span
-//        auto x = (e.cluster1.coord_start() + e.cluster1.coord_end()) / 2;
-//        auto y = (e.cluster2.coord_start() + e.cluster2.coord_end()) / 2;
-
-        // \todo improve this
-        auto time = e.time_start() * MultibladeConfig.TimeTickNS; // TOF in ns
-        auto pixel_id = essgeom.pixel2D(x, y);
-        XTRACE(EVENT, DEB, "time: %u, x %u, y %u, pixel %u", time, x, y, pixel_id);
-
-        if (pixel_id == 0) {
-          Counters.GeometryErrors++;
-        } else {
-          Counters.TxBytes += flatbuffer.addEvent(time, pixel_id);
-          Counters.Events++;
+        builders[cassette].Events.clear(); // else events will accumulate
+        if (UseArena) {
+          ProcessingArena.recycle();
         }
       }
-      builders[cassette].Events.clear(); // else events will accumulate
     } else {
       // There is NO data in the FIFO - do stop checks and sleep a little
-      Counters.ProcessingIdle++;
-      usleep(10);
+      if ((not Pool) or (Pool->collect() == 0)) {
+        ProcessingIdle.idle();
+      }
     }
 
     // if filedumping and requesting time splitting, check for rotation.
@@ -409,8 +535,23 @@ void CAENBase::processing_thread() {
     if (produce_timer.timetsc() >=
         EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ) {
 
+      updateReceiveStats();
       RuntimeStatusMask =  RtStat.getRuntimeStatusMask({Counters.RxPackets, Counters.Events, Counters.TxBytes});
 
+      if (MBCAENSettings.FlushHorizon != 0) {
+        for (uint16_t cassette = 0; cassette < ncass; cassette++) {
+          if (not CassetteActive[cassette]) {
+            flushCassette(cassette);
+          }
+          CassetteActive[cassette] = false;
+        }
+        if (UseArena) {
+          ProcessingArena.recycle();
+        }
+      }
+
+      updateWorkerStats(Pool.get());
+
       Counters.TxBytes += flatbuffer.produce();
 
       if (!histograms.isEmpty()) {
@@ -432,7 +573,15 @@ void CAENBase::processing_thread() {
     }
 
     if (not runThreads) {
-      // \todo flush everything here
+      updateReceiveStats();
+      for (uint16_t cassette = 0; cassette < ncass; cassette++) {
+        flushCassette(cassette);
+      }
+      if (Pool) {
+        Pool->flush();
+        updateWorkerStats(Pool.get());
+      }
+      Counters.TxBytes += flatbuffer.produce();
       XTRACE(INPUT, ALW, "Stopping processing thread.");
       return;
     }
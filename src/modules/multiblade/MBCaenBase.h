@@ -10,8 +10,10 @@
 #pragma once
 
 #include <common/Detector.h>
+#include <common/Socket.h>
 #include <caen/Config.h>
 #include <multiblade/caen/Readout.h>
+#include <multiblade/clustering/CassetteWorkers.h>
 
 namespace Multiblade {
 
@@ -19,11 +21,18 @@ struct CAENSettings {
   std::string FilePrefix{""};
   std::string ConfigFile{""};
   uint32_t H5SplitTime{0}; // split files every N seconds (0 is inactive)
+  unsigned int Workers{0}; // event building threads, 0: processing thread
+  bool DeterministicWorkers{false}; // events in packet order, not time merged
+  uint64_t MergeLatency{0}; // worker events held back from the horizon (ticks)
+  uint64_t FlushHorizon{0}; // EventBuilder flush policy (ticks), 0: flush all
+  bool OrderedMatcher{false}; // matcher uses an ordered cluster queue
+  bool RadixSort{false}; // hits are sorted with HitSort::Radix
+  bool ArenaAllocator{false}; // event building allocates from per thread arenas
 };
 
 
 
-class CAENBase : public Detector {
+class CAENBase : public InputDetector<> {
 public:
   CAENBase(BaseSettings const &settings, struct CAENSettings &LocalMBCAENSettings);
   ~CAENBase() = default;
@@ -31,15 +40,23 @@ public:
   void input_thread();
   void processing_thread();
 
+  /// \brief copy the receiver counters to Counters
+  void updateReceiveStats();
+
+  /// \brief copy the CassetteWorkers counters to WorkerStats
+  void updateWorkerStats(CassetteWorkers *Pool);
+
 protected:
 
   struct {
-    // Input Counters - accessed in input thread
+    // Input Counters - copied from RxCounters by the processing thread
     int64_t RxPackets;
     int64_t RxBytes;
     int64_t RxIdle;
     int64_t FifoPushErrors;
-    int64_t PaddingFor64ByteAlignment[4]; // cppcheck-suppress unusedStructMember
+    int64_t RxMemoryBacking;
+    int64_t RingOverruns;
+    int64_t PaddingFor64ByteAlignment[2]; // cppcheck-suppress unusedStructMember
 
     // Processing Counters - accessed in processing thread
     int64_t FifoSeqErrors;
@@ -55,7 +72,6 @@ protected:
     int64_t FiltersMaxTimeSpan;
     int64_t FiltersMaxMulti1;
     int64_t FiltersMaxMulti2;
-    int64_t ProcessingIdle;
     int64_t Events;
     int64_t EventsUdder;
     int64_t EventsNoCoincidence;
@@ -72,6 +88,11 @@ protected:
 
   CAENSettings MBCAENSettings;
   Config MultibladeConfig;
+  unsigned int Workers{0}; ///< 0: no CassetteWorkers
+  CassetteWorkerStats WorkerStats[CassetteWorkers::MaxWorkers];
+  Arena::ArenaStats WorkerArenaStats[CassetteWorkers::MaxWorkers];
+  /// used for event building without CassetteWorkers
+  Arena ProcessingArena;
 };
 
 }
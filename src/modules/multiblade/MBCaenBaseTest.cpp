@@ -45,6 +45,7 @@ public:
   ~CAENBaseStandIn() = default;
   using Detector::Threads;
   using Multiblade::CAENBase::Counters;
+  using Multiblade::CAENBase::WorkerStats;
 };
 
 class CAENBaseTest : public ::testing::Test {
@@ -80,6 +81,23 @@ TEST_F(CAENBaseTest, DataReceive) {
   EXPECT_EQ(Readout.Counters.ReadoutsCount, 45); // number of readouts in pkt13_short
 }
 
+TEST_F(CAENBaseTest, DataReceiveWorkers) {
+  LocalSettings.Workers = 2;
+  CAENBaseStandIn Readout(Settings, LocalSettings);
+  Readout.startThreads();
+  std::chrono::duration<std::int64_t, std::milli> SleepTime{400};
+  std::this_thread::sleep_for(SleepTime);
+  TestUDPServer Server(43127, Settings.DetectorPort, (unsigned char *)&pkt145701[0], pkt145701.size());
+  Server.startPacketTransmission(1, 100);
+  std::this_thread::sleep_for(SleepTime);
+  Readout.stopThreads();
+  EXPECT_EQ(Readout.Counters.RxPackets, 1);
+  EXPECT_EQ(Readout.Counters.ReadoutsCount, 45);
+  EXPECT_EQ(Readout.WorkerStats[0].Packets + Readout.WorkerStats[1].Packets, 1);
+  EXPECT_EQ(Readout.WorkerStats[0].Hits + Readout.WorkerStats[1].Hits,
+            Readout.Counters.ReadoutsGood);
+}
+
 int main(int argc, char **argv) {
   std::string filename{"MB18Estia.json"};
   saveBuffer(filename, (void *)mb18estiajson.c_str(), mb18estiajson.size());
@@ -45,4 +45,46 @@ static void EventGenBM(benchmark::State &state) {
 
 BENCHMARK(EventGenBM)->RangeMultiplier(2)->Range(64, 2<<12);
 
+// 4096 events with two wire hits and one strip hit, inserted in packets
+// of state.range(0) hits with a flush() after each packet, so events
+// straddle packet boundaries
+static void packetFlush(benchmark::State &state, uint64_t Horizon) {
+  const uint32_t Clusters{4096};
+  std::vector<Hit> Hits;
+  for (uint32_t i = 0; i < Clusters; i++) {
+    uint64_t t = i * (Multiblade::timegap + 1000);
+    uint16_t coord = i % 32;
+    Hits.push_back({t, coord, 4000, Multiblade::WirePlane});
+    Hits.push_back({t + 5, uint16_t(coord + 1), 4000, Multiblade::WirePlane});
+    Hits.push_back({t + 70, coord, 4000, Multiblade::StripPlane});
+  }
+  size_t PacketHits = state.range(0);
+
+  int64_t Events{0};
+  for (auto _ : state) {
+    Multiblade::EventBuilder PacketBuilder;
+    PacketBuilder.setFlushHorizon(Horizon);
+    for (size_t i = 0; i < Hits.size(); i++) {
+      PacketBuilder.insert(Hits[i]);
+      if ((i % PacketHits) == PacketHits - 1) {
+        PacketBuilder.flush();
+      }
+    }
+    PacketBuilder.flushAll();
+    Events += PacketBuilder.Events.size();
+  }
+  state.SetItemsProcessed(state.iterations() * Hits.size());
+  state.counters["events"] = Events / state.iterations();
+}
+
+static void FlushPerPacket(benchmark::State &state) {
+  packetFlush(state, 0);
+}
+BENCHMARK(FlushPerPacket)->RangeMultiplier(4)->Range(16, 1024);
+
+static void FlushHorizon(benchmark::State &state) {
+  packetFlush(state, 5000);
+}
+BENCHMARK(FlushHorizon)->RangeMultiplier(4)->Range(16, 1024);
+
 BENCHMARK_MAIN();
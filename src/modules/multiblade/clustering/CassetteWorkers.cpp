@@ -0,0 +1,212 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Per-cassette event building on a pool of worker threads
+///
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <common/Trace.h>
+#include <multiblade/clustering/CassetteWorkers.h>
+
+// #undef TRC_LEVEL
+// #define TRC_LEVEL TRC_L_DEB
+
+namespace Multiblade {
+
+const unsigned int CassetteWorkers::MaxWorkers;
+
+CassetteWorkers::CassetteWorkers(unsigned int Workers, unsigned int Cassettes,
+                                 EventCallback Callback, bool Deterministic,
+                                 unsigned int QueueSize, std::string IdleMode)
+    : Callback(Callback), Deterministic(Deterministic), QueueSize(QueueSize),
+      Builders(Cassettes) {
+  Workers = (Workers < 1) ? 1 : (Workers > MaxWorkers) ? MaxWorkers : Workers;
+
+  for (unsigned int i = 0; i < Workers; i++) {
+    WorkerThreads.emplace_back(
+        new Worker(QueueSize, IdleMode, Arena::chunkShare(Workers)));
+  }
+  Merger = ChronoHeapMerger(0, Workers);
+  for (auto &W : WorkerThreads) {
+    auto Wp = W.get();
+    W->Thread = std::thread([this, Wp]() { workerThread(*Wp); });
+  }
+}
+
+CassetteWorkers::~CassetteWorkers() {
+  Running = false;
+  for (auto &W : WorkerThreads) {
+    W->Thread.join();
+  }
+}
+
+void CassetteWorkers::addPacket(uint16_t Cassette, std::vector<Hit> &Hits) {
+  submit(Cassette, &Hits, false);
+}
+
+void CassetteWorkers::addFlush(uint16_t Cassette) {
+  submit(Cassette, nullptr, true);
+}
+
+void CassetteWorkers::flushAll() {
+  for (uint16_t Cassette = 0; Cassette < Builders.size(); Cassette++) {
+    addFlush(Cassette);
+  }
+  flush();
+}
+
+void CassetteWorkers::submit(uint16_t Cassette, std::vector<Hit> *Hits,
+                             bool FlushAll) {
+  assert(Cassette < Builders.size());
+  unsigned int WorkerId = Cassette % workers();
+  Worker &W = *WorkerThreads[WorkerId];
+
+  while (W.Submitted.load(std::memory_order_relaxed) - W.Collected == QueueSize) {
+    if (collect() == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  uint64_t Next = W.Submitted.load(std::memory_order_relaxed);
+  auto &Item = W.Items[Next % QueueSize];
+  Item.Cassette = Cassette;
+  Item.FlushAll = FlushAll;
+  if (Hits) {
+    std::swap(Item.Hits, *Hits);
+    Hits->clear();
+  } else {
+    Item.Hits.clear();
+  }
+  W.Submitted.store(Next + 1, std::memory_order_release);
+  Pending.push_back(WorkerId);
+}
+
+unsigned int CassetteWorkers::collect(bool Wait) {
+  unsigned int Packets{0};
+  while (not Pending.empty()) {
+    unsigned int WorkerId = Pending.front();
+    Worker &W = *WorkerThreads[WorkerId];
+    if (W.Collected >= W.Completed.load(std::memory_order_acquire)) {
+      if (not Wait) {
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+
+    auto &Item = W.Items[W.Collected % QueueSize];
+    for (auto &E : Item.Events) {
+      if (Deterministic) {
+        Callback(E);
+      } else {
+        merge(WorkerId, E);
+      }
+    }
+    W.CollectedStats = Item.Stats;
+    W.CollectedArenaStats = Item.ArenaStats;
+    W.Collected++;
+    Pending.pop_front();
+    if (not Item.FlushAll) {
+      Packets++;
+    }
+  }
+
+  // Pending is only empty after a wait if every packet was collected
+  releaseMerged(Wait);
+
+  for (auto &W : WorkerThreads) {
+    W->CollectedStats.QueueDepth =
+        W->Submitted.load(std::memory_order_relaxed) -
+        W->Completed.load(std::memory_order_relaxed);
+  }
+  return Packets;
+}
+
+void CassetteWorkers::merge(unsigned int WorkerId, Event &E) {
+  uint32_t Slot;
+  if (FreeSlots.empty()) {
+    Slot = MergeStore.size();
+    MergeStore.push_back(std::move(E));
+  } else {
+    Slot = FreeSlots.back();
+    FreeSlots.pop_back();
+    MergeStore[Slot] = std::move(E);
+  }
+  uint64_t Time = MergeStore[Slot].time_start();
+  WorkerThreads[WorkerId]->Latest = std::max(WorkerThreads[WorkerId]->Latest, Time);
+  Merger.insert(WorkerId, {Time, Slot});
+}
+
+void CassetteWorkers::releaseMerged(bool All) {
+  if (Merger.empty()) {
+    return;
+  }
+
+  // idle workers follow the newest worker so they do not stall the horizon
+  unsigned int Newest{0};
+  for (unsigned int i = 1; i < workers(); i++) {
+    if (WorkerThreads[i]->Latest > WorkerThreads[Newest]->Latest) {
+      Newest = i;
+    }
+  }
+  for (unsigned int i = 0; i < workers(); i++) {
+    auto &W = *WorkerThreads[i];
+    if (W.Collected == W.Submitted.load(std::memory_order_relaxed)) {
+      Merger.sync_up(i, Newest);
+    }
+  }
+
+  while (Merger.ready() or (All and not Merger.empty())) {
+    uint32_t Slot = Merger.pop_earliest().pixel_id;
+    // moved out so the hits are released and do not pin arena chunks
+    Event E = std::move(MergeStore[Slot]);
+    Callback(E);
+    FreeSlots.push_back(Slot);
+  }
+}
+
+void CassetteWorkers::workerThread(Worker &W) {
+  uint64_t Next{0};
+  while (Running) {
+    if (Next == W.Submitted.load(std::memory_order_acquire)) {
+      W.Idle.idle();
+      continue;
+    }
+    W.Idle.reset();
+
+    auto &Item = W.Items[Next % QueueSize];
+    auto &Builder = Builders[Item.Cassette];
+    ArenaScope Scope(UseArena ? &W.Memory : nullptr);
+    for (auto &H : Item.Hits) {
+      Builder.insert(H);
+    }
+    if (Item.FlushAll) {
+      Builder.flushAll();
+    } else {
+      Builder.flush();
+    }
+    std::swap(Item.Events, Builder.Events);
+    Builder.Events.clear();
+    if (UseArena) {
+      W.Memory.recycle();
+    }
+
+    if (not Item.FlushAll) {
+      W.Stats.Packets++;
+    }
+    W.Stats.Hits += Item.Hits.size();
+    W.Stats.Events += Item.Events.size();
+    Item.Stats = W.Stats;
+    Item.ArenaStats = W.Memory.Stats;
+    XTRACE(CLUSTER, DEB, "cassette %u: %zu hits, %zu events", Item.Cassette,
+           Item.Hits.size(), Item.Events.size());
+    Next++;
+    W.Completed.store(Next, std::memory_order_release);
+  }
+}
+
+} // namespace
@@ -0,0 +1,207 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Per-cassette event building on a pool of worker threads
+///
+/// The processing thread validates readouts and maps them to hits as usual
+/// and hands the hits of each packet (all from one cassette) to
+/// addPacket(). Each cassette has its own EventBuilder and all packets
+/// from a cassette go to the same worker (Cassette % Workers), so
+/// clustering of a cassette is identical to the single threaded case.
+///
+/// collect() is called from the processing thread and hands the events of
+/// completed packets to the EventCallback. Events are merged by time across
+/// workers and collect() calls with a ChronoHeapMerger (one pipeline per
+/// worker) and are handed over once they are older than the merge horizon,
+/// the latest event time of the slowest worker minus the merge latency.
+/// A worker with no outstanding packets does not hold back the horizon.
+/// flush() hands over all events. If Deterministic is set events are handed
+/// over in packet order, exactly as the single threaded processing would.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <common/Arena.h>
+#include <common/IdleStrategy.h>
+#include <common/reduction/ChronoHeapMerger.h>
+#include <common/reduction/Event.h>
+#include <common/reduction/clustering/AbstractClusterer.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <multiblade/clustering/EventBuilder.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Multiblade {
+
+/// \brief per worker counters, QueueDepth is updated by collect()
+struct CassetteWorkerStats {
+  int64_t Packets{0};
+  int64_t Hits{0};
+  int64_t Events{0};
+  int64_t QueueDepth{0};
+};
+
+class CassetteWorkers {
+public:
+  static const unsigned int MaxWorkers{16};
+
+  /// \brief receives the events in output order
+  using EventCallback = std::function<void(const Event &)>;
+
+  /// \param Workers number of worker threads (1 - MaxWorkers)
+  /// \param Cassettes number of cassettes (EventBuilders)
+  /// \param Callback called by collect() for each event
+  /// \param Deterministic hand over events in packet order
+  /// \param QueueSize packets queued per worker
+  /// \param IdleMode IdleStrategy used by the workers
+  CassetteWorkers(unsigned int Workers, unsigned int Cassettes,
+                  EventCallback Callback, bool Deterministic = false,
+                  unsigned int QueueSize = 256, std::string IdleMode = "yield");
+
+  /// \brief stops and joins the worker threads, uncollected data is lost
+  ~CassetteWorkers();
+
+  unsigned int workers() { return WorkerThreads.size(); }
+
+  /// \brief counters of a worker as of its last collected packet, to be
+  /// copied to the detector stats
+  const CassetteWorkerStats &workerStats(unsigned int Worker) {
+    return WorkerThreads[Worker]->CollectedStats;
+  }
+
+  /// \brief events are handed over once they are this much (ticks) older
+  /// than the merge horizon, must be called before the first addPacket()
+  void setMergeLatency(uint64_t Latency) {
+    Merger = ChronoHeapMerger(Latency, workers());
+  }
+
+  /// \brief set the EventBuilder flush policy of all cassettes, must be
+  /// called before the first addPacket()
+  void setFlushHorizon(uint64_t Horizon) {
+    for (auto &Builder : Builders) {
+      Builder.setFlushHorizon(Horizon);
+    }
+  }
+
+  /// \brief select the hit sort of all cassettes, must be called before the
+  /// first addPacket()
+  void setSortMethod(HitSort Method) {
+    for (auto &Builder : Builders) {
+      Builder.setSortMethod(Method);
+    }
+  }
+
+  /// \brief select the matcher cluster queue of all cassettes, must be
+  /// called before the first addPacket()
+  void setOrderedMatcher(bool Ordered) {
+    for (auto &Builder : Builders) {
+      Builder.matcher.set_ordered_queue(Ordered);
+    }
+  }
+
+  /// \brief let each worker allocate hits, clusters and events from its own
+  /// Arena, which is recycled after every packet. Each arena is limited to
+  /// its share of the chunk pool. Must be called before the first
+  /// addPacket()
+  void setArena(bool Enable) { UseArena = Enable; }
+
+  /// \brief arena counters of a worker as of its last collected packet, to
+  /// be copied to the detector stats
+  const Arena::ArenaStats &arenaStats(unsigned int Worker) {
+    return WorkerThreads[Worker]->CollectedArenaStats;
+  }
+
+  /// \brief queue the hits of a packet for event building. The vector is
+  /// swapped with a queue entry, so its capacity is reused by the caller.
+  /// Blocks (while collecting) if the worker queue is full.
+  void addPacket(uint16_t Cassette, std::vector<Hit> &Hits);
+
+  /// \brief queue closing all clusters of a cassette (EventBuilder::
+  /// flushAll()), e.g. when no packets arrived for a while. Blocks (while
+  /// collecting) if the worker queue is full.
+  void addFlush(uint16_t Cassette);
+
+  /// \brief hand the events of completed packets to the EventCallback
+  /// \param Wait wait for all outstanding packets to complete
+  /// \return number of packets handed over, flushes are not counted
+  unsigned int collect(bool Wait = false);
+
+  /// \brief wait for and hand over all outstanding packets and all events
+  /// held back by the merger
+  unsigned int flush() { return collect(true); }
+
+  /// \brief close all clusters of all cassettes and hand over all events
+  void flushAll();
+
+private:
+  struct WorkItem {
+    uint16_t Cassette{0};
+    bool FlushAll{false}; ///< close all clusters after the hits
+    std::vector<Hit> Hits;
+    std::vector<Event> Events;
+    /// worker counters after this packet, written before Completed
+    CassetteWorkerStats Stats;
+    Arena::ArenaStats ArenaStats;
+  };
+
+  struct Worker {
+    Worker(unsigned int QueueSize, std::string IdleMode, size_t ArenaChunks)
+        : Items(QueueSize), Idle(IdleMode, 10), Memory(ArenaChunks) {}
+    std::vector<WorkItem> Items;
+    IdleStrategy Idle;
+    Arena Memory;
+    std::thread Thread;
+    /// written by the processing thread, read by the worker
+    std::atomic<uint64_t> Submitted{0};
+    char Padding0[64]; // cppcheck-suppress unusedStructMember
+    /// written by the worker, read by the processing thread
+    std::atomic<uint64_t> Completed{0};
+    char Padding1[64]; // cppcheck-suppress unusedStructMember
+    /// only used by the worker
+    CassetteWorkerStats Stats;
+    /// only used by the processing thread
+    uint64_t Collected{0};
+    uint64_t Latest{0}; ///< latest event time given to the merger
+    CassetteWorkerStats CollectedStats;
+    Arena::ArenaStats CollectedArenaStats;
+  };
+
+  /// \brief queue an entry for a cassette, swapping in Hits if not nullptr
+  void submit(uint16_t Cassette, std::vector<Hit> *Hits, bool FlushAll);
+
+  void workerThread(Worker &W);
+
+  /// \brief move an event of a worker into the merger
+  void merge(unsigned int WorkerId, Event &E);
+
+  /// \brief hand over the events that are older than the merge horizon
+  /// \param All hand over all events
+  void releaseMerged(bool All);
+
+  EventCallback Callback;
+  bool Deterministic{false};
+  bool UseArena{false};
+  unsigned int QueueSize;
+  std::atomic_bool Running{true};
+  /// hits and clusters are allocated by the workers and released by both
+  /// the workers and the processing thread, outlives the threads
+  SharedReductionPools SharedPools;
+  /// one per cassette, only used by the cassette's worker
+  std::vector<EventBuilder> Builders;
+  std::vector<std::unique_ptr<Worker>> WorkerThreads;
+  /// worker of each packet not yet handed over, in packet order
+  std::deque<unsigned int> Pending;
+  /// orders the events of all workers, the pixel_id of a merger entry is
+  /// the index of the event in MergeStore
+  ChronoHeapMerger Merger{0, 1};
+  std::vector<Event> MergeStore;
+  std::vector<uint32_t> FreeSlots;
+};
+
+} // namespace
@@ -0,0 +1,188 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Unit tests for CassetteWorkers
+///
+//===----------------------------------------------------------------------===//
+
+#include <multiblade/clustering/CassetteWorkers.h>
+#include <test/TestBase.h>
+
+using namespace Multiblade;
+
+class CassetteWorkersTest : public TestBase {
+protected:
+  std::vector<uint64_t> Times;
+  CassetteWorkers::EventCallback Callback = [this](const Event &e) {
+    Times.push_back(e.time_start());
+  };
+
+  /// \brief one wire and one strip hit, gives one event at Time
+  std::vector<Hit> makeHits(uint64_t Time) {
+    return {{Time, 1, 100, WirePlane}, {Time, 1, 100, StripPlane}};
+  }
+
+  /// \brief collect (without waiting) until Packets have been handed over
+  void collectPackets(CassetteWorkers &Pool, unsigned int Packets) {
+    unsigned int Collected{0};
+    while (Collected < Packets) {
+      Collected += Pool.collect();
+    }
+  }
+};
+
+TEST_F(CassetteWorkersTest, Constructor) {
+  CassetteWorkers Pool(2, 4, Callback);
+  ASSERT_EQ(Pool.workers(), 2);
+  ASSERT_EQ(Pool.collect(), 0);
+  ASSERT_EQ(Pool.flush(), 0);
+}
+
+TEST_F(CassetteWorkersTest, WorkersClamped) {
+  CassetteWorkers Pool1(0, 4, Callback);
+  ASSERT_EQ(Pool1.workers(), 1);
+  CassetteWorkers Pool2(100, 4, Callback);
+  ASSERT_EQ(Pool2.workers(), CassetteWorkers::MaxWorkers);
+}
+
+TEST_F(CassetteWorkersTest, MergedByTime) {
+  CassetteWorkers Pool(2, 2, Callback);
+  auto Hits = makeHits(100000);
+  Pool.addPacket(0, Hits);
+  ASSERT_TRUE(Hits.empty());
+  Hits = makeHits(50000);
+  Pool.addPacket(1, Hits);
+  ASSERT_EQ(Pool.flush(), 2);
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000, 100000}));
+}
+
+TEST_F(CassetteWorkersTest, MergedAcrossCollects) {
+  CassetteWorkers Pool(2, 2, Callback);
+  auto Hits = makeHits(100000);
+  Pool.addPacket(0, Hits);
+  Hits = makeHits(50000);
+  Pool.addPacket(1, Hits);
+  collectPackets(Pool, 2);
+  // the event at the horizon is held back
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000}));
+
+  Hits = makeHits(70000);
+  Pool.addPacket(1, Hits);
+  collectPackets(Pool, 1);
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000, 70000}));
+
+  Hits = makeHits(200000);
+  Pool.addPacket(0, Hits);
+  Hits = makeHits(150000);
+  Pool.addPacket(1, Hits);
+  collectPackets(Pool, 2);
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000, 70000, 100000, 150000}));
+
+  ASSERT_EQ(Pool.flush(), 0);
+  ASSERT_EQ(Times,
+            std::vector<uint64_t>({50000, 70000, 100000, 150000, 200000}));
+}
+
+TEST_F(CassetteWorkersTest, MergeLatency) {
+  CassetteWorkers Pool(2, 2, Callback);
+  Pool.setMergeLatency(60000);
+  auto Hits = makeHits(100000);
+  Pool.addPacket(0, Hits);
+  Hits = makeHits(50000);
+  Pool.addPacket(1, Hits);
+  collectPackets(Pool, 2);
+  ASSERT_TRUE(Times.empty());
+
+  Hits = makeHits(120000);
+  Pool.addPacket(0, Hits);
+  collectPackets(Pool, 1);
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000}));
+
+  Pool.flush();
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000, 100000, 120000}));
+}
+
+TEST_F(CassetteWorkersTest, FlushAllClosesClusters) {
+  CassetteWorkers Pool(2, 2, Callback);
+  Pool.setFlushHorizon(1000000);
+  auto Hits = makeHits(100000);
+  Pool.addPacket(0, Hits);
+  Hits = makeHits(50000);
+  Pool.addPacket(1, Hits);
+  ASSERT_EQ(Pool.flush(), 2);
+  ASSERT_TRUE(Times.empty());
+
+  Pool.addFlush(1);
+  ASSERT_EQ(Pool.flush(), 0);
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000}));
+
+  Pool.flushAll();
+  ASSERT_EQ(Times, std::vector<uint64_t>({50000, 100000}));
+  ASSERT_EQ(Pool.workerStats(0).Packets, 1);
+  ASSERT_EQ(Pool.workerStats(1).Packets, 1);
+}
+
+TEST_F(CassetteWorkersTest, DeterministicPacketOrder) {
+  CassetteWorkers Pool(2, 2, Callback, true);
+  auto Hits = makeHits(100000);
+  Pool.addPacket(0, Hits);
+  Hits = makeHits(50000);
+  Pool.addPacket(1, Hits);
+  ASSERT_EQ(Pool.flush(), 2);
+  ASSERT_EQ(Times, std::vector<uint64_t>({100000, 50000}));
+}
+
+TEST_F(CassetteWorkersTest, QueueFullAndStats) {
+  const unsigned int Packets{100};
+  CassetteWorkers Pool(3, 6, Callback, true, 4);
+  for (unsigned int i = 0; i < Packets; i++) {
+    auto Hits = makeHits(20000 * (i + 1));
+    Pool.addPacket(i % 6, Hits);
+  }
+  Pool.flush();
+  ASSERT_EQ(Times.size(), Packets);
+  for (unsigned int i = 0; i < Packets; i++) {
+    ASSERT_EQ(Times[i], 20000 * (i + 1));
+  }
+
+  int64_t Sum{0};
+  for (unsigned int i = 0; i < Pool.workers(); i++) {
+    auto &Stats = Pool.workerStats(i);
+    ASSERT_EQ(Stats.Packets, Packets / 3 + (i < Packets % 3 ? 1 : 0));
+    ASSERT_EQ(Stats.Hits, 2 * Stats.Packets);
+    ASSERT_EQ(Stats.Events, Stats.Packets);
+    ASSERT_EQ(Stats.QueueDepth, 0);
+    Sum += Stats.Packets;
+  }
+  ASSERT_EQ(Sum, Packets);
+}
+
+TEST_F(CassetteWorkersTest, Arena) {
+  const unsigned int Packets{20};
+  CassetteWorkers Pool(2, 4, Callback, true);
+  Pool.setArena(true);
+  for (unsigned int i = 0; i < Packets; i++) {
+    auto Hits = makeHits(20000 * (i + 1));
+    Pool.addPacket(i % 4, Hits);
+  }
+  Pool.flush();
+  ASSERT_EQ(Times.size(), Packets);
+  for (unsigned int i = 0; i < Packets; i++) {
+    ASSERT_EQ(Times[i], 20000 * (i + 1));
+  }
+
+  for (unsigned int i = 0; i < Pool.workers(); i++) {
+    auto &Stats = Pool.arenaStats(i);
+    ASSERT_GT(Stats.AllocCount, 0);
+    ASSERT_GE(Stats.HighWaterChunks, 1);
+    ASSERT_GT(Stats.HighWaterBytes, 0);
+    ASSERT_EQ(Stats.FallbackCount, 0);
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
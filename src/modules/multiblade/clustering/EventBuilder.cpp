@@ -29,7 +29,7 @@ EventBuilder::EventBuilder(uint32_t BoxSize) : TimeBoxSize(BoxSize) {
 
 void EventBuilder::insert(Hit hit) {
   if ((hit.time - TimeBoxT0) >= TimeBoxSize) {
-    flush();
+    flushAll();
     TimeBoxT0 = hit.time;
     XTRACE(CLUSTER, DEB, "NEW TIME BOX ===================================");
   }
@@ -48,13 +48,61 @@ void EventBuilder::insert(Hit hit) {
 }
 
 void EventBuilder::flush() {
+  if (FlushHorizon == 0) {
+    flushAll();
+    return;
+  }
+
+  matcher.matched_events.clear();
+
+  sort_chronologically(p0, SortMethod);
+  sort_chronologically(p1, SortMethod);
+
+  uint64_t Newest{0};
+  if (!p0.empty()) {
+    Newest = p0.back().time;
+  }
+  if (!p1.empty() and (p1.back().time > Newest)) {
+    Newest = p1.back().time;
+  }
+
+  // hand the hits outside the horizon to the clusterers, the rest
+  // stay buffered until the next flush. Later hits are not older than
+  // Cut, so a time cluster ending more than timegap before Cut is complete
+  uint64_t Cut = (Newest > FlushHorizon) ? Newest - FlushHorizon : 0;
+  auto ClusterOlder = [Cut](HitVector &Hits, GapClusterer &Clusterer,
+                            uint64_t &LastTime) {
+    size_t Older{0};
+    while ((Older < Hits.size()) and (Hits[Older].time <= Cut)) {
+      Clusterer.insert(Hits[Older]);
+      LastTime = Hits[Older].time;
+      Older++;
+    }
+    Hits.erase(Hits.begin(), Hits.begin() + Older);
+    if ((Cut > LastTime) and (Cut - LastTime > timegap)) {
+      Clusterer.flush();
+    }
+  };
+  ClusterOlder(p0, c0, LastClustered0);
+  ClusterOlder(p1, c1, LastClustered1);
+
+  // open clusters and clusters within the matcher latency are kept
+  matcher.insert(WirePlane, c0.clusters);
+  matcher.insert(StripPlane, c1.clusters);
+  matcher.match(false);
+
+  auto & e = matcher.matched_events;
+  Events.insert(Events.end(), e.begin(), e.end());
+}
+
+void EventBuilder::flushAll() {
   matcher.matched_events.clear();
 
-  sort_chronologically(p0);
+  sort_chronologically(p0, SortMethod);
   c0.cluster(p0);
   c0.flush();
 
-  sort_chronologically(p1);
+  sort_chronologically(p1, SortMethod);
   c1.cluster(p1);
   c1.flush();
 
@@ -36,10 +36,31 @@ public:
   // \todo pass by rvalue?
   void insert(Hit hit);
 
+  /// \brief cluster and match the inserted hits. With FlushHorizon 0 all
+  /// clusters are closed (flushAll()). Otherwise hits within FlushHorizon
+  /// of the newest hit stay buffered, and clusters which can still grow or
+  /// be matched are kept for the next call, so clusters straddling
+  /// packet boundaries are not split.
   void flush();
 
+  /// \brief cluster and match all inserted hits and close all clusters
+  void flushAll();
+
   void clear();
 
+  /// \brief set the flush policy, 0 (default) closes all clusters in
+  /// flush(). Later hits must not be older than the newest hit minus
+  /// Horizon.
+  void setFlushHorizon(uint64_t Horizon) { FlushHorizon = Horizon; }
+
+  /// \brief select the sort used for the hits and the coordinates of time
+  /// clusters, HitSort::StdSort (default) or HitSort::Radix
+  void setSortMethod(HitSort Method) {
+    SortMethod = Method;
+    c0.set_sort_method(Method);
+    c1.set_sort_method(Method);
+  }
+
   HitVector p0, p1;
 
   // \todo parametrize
@@ -55,6 +76,12 @@ public:
   uint64_t TimeBoxT0{0};
   uint32_t TimeBoxSize{10000000};
 
+  // Flush policy, see flush()
+  uint64_t FlushHorizon{0};
+  HitSort SortMethod{HitSort::StdSort};
+  uint64_t LastClustered0{0}; ///< time of last hit given to c0
+  uint64_t LastClustered1{0}; ///< time of last hit given to c1
+
   // Data from MB18_thresholds_sw36.xlsx
   // only for the lower (?) 32 channels per digitizer
   std::vector<std::vector<uint16_t>> Thresholds {
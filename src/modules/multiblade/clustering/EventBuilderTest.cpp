@@ -53,6 +53,68 @@ TEST_F(EventBuilderTest, FirstTest) {
 
 }
 
+TEST_F(EventBuilderTest, RadixSort) {
+  uint32_t clusters = 100; // enough hits for the radix sort
+  createHits(clusters, 6);
+  builder.setSortMethod(HitSort::Radix);
+
+  builder.flush();
+
+  ASSERT_EQ(builder.matcher.matched_events.size(), clusters);
+  for (auto & e : builder.matcher.matched_events) {
+    ASSERT_TRUE(e.both_planes());
+    ASSERT_FLOAT_EQ(e.ClusterA.coord_center() + 1.0, e.ClusterB.coord_center());
+  }
+}
+
+// One cluster in each plane, inserted in two packets
+void insertTwoPackets(EventBuilder & b) {
+  b.insert({0, 1, 4000, WirePlane});
+  b.insert({10, 2, 4000, WirePlane});
+  b.insert({5, 1, 4000, StripPlane});
+  b.flush();
+  b.insert({20, 3, 4000, WirePlane});
+  b.insert({25, 2, 4000, StripPlane});
+  b.flush();
+}
+
+TEST_F(EventBuilderTest, FlushSplitsClusters) {
+  insertTwoPackets(builder);
+  ASSERT_EQ(builder.Events.size(), 2);
+}
+
+TEST_F(EventBuilderTest, FlushHorizon) {
+  builder.setFlushHorizon(1000);
+  insertTwoPackets(builder);
+  ASSERT_EQ(builder.Events.size(), 0); // all hits within the horizon
+
+  builder.flushAll();
+  ASSERT_EQ(builder.Events.size(), 1);
+  auto & e = builder.Events[0];
+  ASSERT_TRUE(e.both_planes());
+  ASSERT_EQ(e.ClusterA.hit_count(), 3);
+  ASSERT_EQ(e.ClusterB.hit_count(), 2);
+}
+
+TEST_F(EventBuilderTest, FlushHorizonClosesOldClusters) {
+  builder.setFlushHorizon(1000);
+  insertTwoPackets(builder);
+  // later packets are far beyond the horizon and the time gap, so
+  // earlier clusters are complete. The matcher closes an event when
+  // the next clusters are outside its latency.
+  for (uint64_t Time = 100000; Time <= 300000; Time += 100000) {
+    builder.insert({Time, 5, 4000, WirePlane});
+    builder.insert({Time, 5, 4000, StripPlane});
+    builder.flush();
+    ASSERT_EQ(builder.p0.size(), 1);
+    ASSERT_EQ(builder.p1.size(), 1);
+  }
+  ASSERT_EQ(builder.Events.size(), 1);
+  ASSERT_EQ(builder.Events[0].ClusterA.hit_count(), 3);
+  builder.flushAll();
+  ASSERT_EQ(builder.Events.size(), 4);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
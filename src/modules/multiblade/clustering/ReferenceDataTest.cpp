@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <test/TestBase.h>
+#include <multiblade/clustering/CassetteWorkers.h>
 #include <multiblade/clustering/EventBuilder.h>
 #include <algorithm>
 #include <assert.h>
@@ -64,6 +65,11 @@ public:
 
   bool thresholdCheck(uint8_t DigIndex, uint16_t GlobalChannel, uint16_t AdcValue);
 
+  // Split readouts into packets of PacketHits hits spread over Cassettes
+  // cassettes, as the digitizers would send them
+  std::vector<std::pair<uint16_t, std::vector<Hit>>> MakePackets(
+      std::vector<struct MBHits> & vec, size_t PacketHits, uint16_t Cassettes);
+
 protected:
   // builder uses a 2us time boxing
   EventBuilder builder{2010};
@@ -178,6 +184,26 @@ void ReferenceDataTest::LoadAndProcessReadouts(std::vector<struct MBHits> & vec)
 }
 
 
+std::vector<std::pair<uint16_t, std::vector<Hit>>> ReferenceDataTest::MakePackets(
+    std::vector<struct MBHits> & vec, size_t PacketHits, uint16_t Cassettes) {
+  std::vector<std::pair<uint16_t, std::vector<Hit>>> Packets;
+  for (size_t i = 0; i < vec.size(); i++) {
+    if ((i % PacketHits) == 0) {
+      Packets.push_back({static_cast<uint16_t>((i / PacketHits) % Cassettes), {}});
+    }
+    auto & MBHit = vec[i];
+    uint64_t Time = (uint64_t)(MBHit.Time*1000000000ULL);
+    uint16_t Channel = (uint16_t)MBHit.Channel;
+    uint16_t AdcValue = (uint16_t)MBHit.AdcValue;
+    if (isWire(Channel)) {
+      Packets.back().second.push_back({Time, GetWireCoord(Channel), AdcValue, WirePlane});
+    } else {
+      Packets.back().second.push_back({Time, GetStripCoord(Channel), AdcValue, StripPlane});
+    }
+  }
+  return Packets;
+}
+
 // Compare the calculated (t, x, y) with the reference data
 // Very slow implementation, but this is only reference data
 void ReferenceDataTest::CountMatches(std::vector<struct MBEvents> & evts, bool DiscardThresh) {
@@ -299,6 +325,90 @@ TEST_F(ReferenceDataTest, LoadSmall2_Sorted_NotFiltered) {
 }
 
 
+// Event building on worker threads in deterministic mode must give the
+// same events, in the same order, as one EventBuilder per cassette
+TEST_F(ReferenceDataTest, Workers_Deterministic_SameAsSerial) {
+  auto Readouts = DS2S_ST_FF;
+  std::sort(Readouts.begin(), Readouts.end(), compareByTime);
+  const uint16_t Cassettes{3};
+  auto Packets = MakePackets(Readouts, 4, Cassettes);
+
+  std::vector<EventBuilder> Builders(Cassettes);
+  std::vector<std::string> Serial;
+  for (auto Packet : Packets) {
+    auto & Builder = Builders[Packet.first];
+    for (auto & H : Packet.second) {
+      Builder.insert(H);
+    }
+    Builder.flush();
+    for (auto & e : Builder.Events) {
+      Serial.push_back(e.to_string({}, true));
+    }
+    Builder.Events.clear();
+  }
+  ASSERT_NE(Serial.size(), 0);
+
+  for (unsigned int Workers = 1; Workers <= Cassettes; Workers++) {
+    std::vector<std::string> Threaded;
+    CassetteWorkers Pool(Workers, Cassettes,
+        [&Threaded](const Event & e) {
+          Threaded.push_back(e.to_string({}, true));
+        }, true, 2);
+    for (auto Packet : Packets) {
+      Pool.addPacket(Packet.first, Packet.second);
+    }
+    Pool.flush();
+    ASSERT_EQ(Threaded, Serial);
+
+    int64_t Hits{0};
+    for (unsigned int i = 0; i < Pool.workers(); i++) {
+      Hits += Pool.workerStats(i).Hits;
+    }
+    ASSERT_EQ(Hits, Readouts.size());
+  }
+}
+
+// Flushing after every packet splits clusters at packet boundaries, with a
+// flush horizon the events are the same as for all readouts in one go
+TEST_F(ReferenceDataTest, FlushHorizon_SameAsSingleFlush) {
+  auto Readouts = DS2S_ST_FF;
+  std::sort(Readouts.begin(), Readouts.end(), compareByTime);
+  auto Packets = MakePackets(Readouts, 3, 1);
+
+  auto Build = [&Packets](EventBuilder & Builder, bool PerPacket) {
+    std::vector<std::string> Result;
+    for (auto & Packet : Packets) {
+      for (auto & H : Packet.second) {
+        Builder.insert(H);
+      }
+      if (PerPacket) {
+        Builder.flush();
+      }
+    }
+    Builder.flushAll();
+    for (auto & e : Builder.Events) {
+      Result.push_back(e.to_string({}, true));
+    }
+    return Result;
+  };
+
+  EventBuilder Single;
+  auto Reference = Build(Single, false);
+
+  EventBuilder PerPacket;
+  auto Split = Build(PerPacket, true);
+  ASSERT_NE(Split, Reference);
+
+  EventBuilder Horizon;
+  Horizon.setFlushHorizon(5000);
+  ASSERT_EQ(Build(Horizon, true), Reference);
+
+  EventBuilder Ordered;
+  Ordered.setFlushHorizon(5000);
+  Ordered.matcher.set_ordered_queue(true);
+  ASSERT_EQ(Build(Ordered, true), Reference);
+}
+
 
 #ifdef HAS_REFDATA
 
@@ -20,6 +20,9 @@ void SetCLIArguments(CLI::App & parser) {
                   "stream monitor data")->group("Multigrid")->configurable(true)->default_val("true");
   parser.add_option("--dumptofile", LocalMultigridSettings.FilePrefix,
                     "dump to specified file")->group("Multigrid")->configurable(true);
+  parser.add_option("--workers", LocalMultigridSettings.Workers,
+                    "Threads for module reduction (0: use processing thread)")
+                    ->group("Multigrid")->configurable(true);
 }
 
 PopulateCLIParser PopulateParser{SetCLIArguments};
@@ -33,7 +33,7 @@
 static constexpr int TscMHz{2900};
 
 MultigridBase::MultigridBase(BaseSettings const &settings, MultigridSettings const &LocalSettings)
-    : Detector("CSPEC", settings), ModuleSettings(LocalSettings) {
+    : InputDetector("CSPEC", settings), ModuleSettings(LocalSettings) {
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
 
@@ -42,6 +42,8 @@ MultigridBase::MultigridBase(BaseSettings const &settings, MultigridSettings con
   Stats.create("rx_packets", Counters.rx_packets);
   Stats.create("rx_bytes", Counters.rx_bytes);
   Stats.create("rx_idle", Counters.rx_idle);
+  Stats.create("fifo_push_errors", Counters.fifo_push_errors);
+  Stats.create("fifo_seq_errors", Counters.fifo_seq_errors);
   Stats.create("readouts_total", Counters.readouts_total);
   Stats.create("rx_discarded_bytes", Counters.parser_discarded_bytes);
   Stats.create("parser_triggers", Counters.parser_triggers);
@@ -61,6 +63,12 @@ MultigridBase::MultigridBase(BaseSettings const &settings, MultigridSettings con
   Stats.create("tx_events", Counters.tx_events);
   Stats.create("tx_bytes", Counters.tx_bytes);
 
+  Stats.create("thread.processing_idle_spin", ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield", ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause", ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep", ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing", Counters.rx_memory_backing);
+
   /// \todo below stats are common to all detectors and could/should be moved
   Stats.create("kafka.produce_fails", Counters.kafka_produce_fails);
   Stats.create("kafka.ev_errors", Counters.kafka_ev_errors);
@@ -68,19 +76,27 @@ MultigridBase::MultigridBase(BaseSettings const &settings, MultigridSettings con
   Stats.create("kafka.dr_errors", Counters.kafka_dr_errors);
   Stats.create("kafka.dr_others", Counters.kafka_dr_noerrors);
 
+  if (EFUSettings.HugePages) {
+    HitVectorStorage::pin(EFUSettings.NumaNode);
+    ClusterPoolStorage::pin(EFUSettings.NumaNode);
+  }
+
   Stats.create("memory.hitvec_storage.alloc_count", HitVectorStorage::Pool->Stats.AllocCount);
   Stats.create("memory.hitvec_storage.alloc_bytes", HitVectorStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.hitvec_storage.dealloc_count", HitVectorStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.hitvec_storage.dealloc_bytes", HitVectorStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.hitvec_storage.malloc_fallback_count", HitVectorStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.hitvec_storage.backing", HitVectorStorage::Pool->MemoryBacking);
 
   Stats.create("memory.cluster_storage.alloc_count", ClusterPoolStorage::Pool->Stats.AllocCount);
   Stats.create("memory.cluster_storage.alloc_bytes", ClusterPoolStorage::Pool->Stats.AllocBytes);
   Stats.create("memory.cluster_storage.dealloc_count", ClusterPoolStorage::Pool->Stats.DeallocCount);
   Stats.create("memory.cluster_storage.dealloc_bytes", ClusterPoolStorage::Pool->Stats.DeallocBytes);
   Stats.create("memory.cluster_storage.malloc_fallback_count", ClusterPoolStorage::Pool->Stats.MallocFallbackCount);
+  Stats.create("memory.cluster_storage.backing", ClusterPoolStorage::Pool->MemoryBacking);
 
   // clang-format on
+  Counters.rx_memory_backing = rxMemoryBacking(); // 2 is huge pages
 
   LOG(INIT, Sev::Info, "Stream monitor data = {}",
       (ModuleSettings.monitor ? "YES" : "no"));
@@ -88,13 +104,29 @@ MultigridBase::MultigridBase(BaseSettings const &settings, MultigridSettings con
     LOG(INIT, Sev::Info, "Dump h5 data in path: {}",
         ModuleSettings.FilePrefix);
 
-  std::function<void()> inputFunc = [this]() { MultigridBase::mainThread(); };
-  Detector::AddThreadFunction(inputFunc, "main");
+  std::function<void()> inputFunc = [this]() { MultigridBase::inputThread(); };
+  Detector::AddThreadFunction(inputFunc, "input");
+
+  std::function<void()> processingFunc = [this]() {
+    MultigridBase::processingThread();
+  };
+  Detector::AddThreadFunction(processingFunc, "processing");
 }
 
 bool MultigridBase::init_config() {
   LOG(INIT, Sev::Info, "MG Config file: {}", ModuleSettings.ConfigFile);
-  mg_config = Multigrid::Config(ModuleSettings.ConfigFile);
+  try {
+    mg_config = Multigrid::Config(ModuleSettings.ConfigFile);
+  } catch (std::exception &e) {
+    LOG(INIT, Sev::Error, "Invalid MG config file {}: {}",
+        ModuleSettings.ConfigFile, e.what());
+    return false;
+  }
+  if (!mg_config.builder) {
+    LOG(INIT, Sev::Error, "No builder in MG config file {}",
+        ModuleSettings.ConfigFile);
+    return false;
+  }
 
   LOG(INIT, Sev::Info, "Multigrid Config\n{}", mg_config.debug());
   if (ModuleSettings.monitor) {
@@ -137,10 +169,7 @@ void MultigridBase::process_events(EV42Serializer &ev42serializer) {
   mg_config.reduction.out_queue.clear();
 }
 
-void MultigridBase::mainThread() {
-  if (!init_config())
-    return;
-
+void MultigridBase::inputThread() {
   /// Connection setup
   Socket::Endpoint
       local(EFUSettings.DetectorAddress.c_str(), EFUSettings.DetectorPort); //Change name or add more comments
@@ -152,6 +181,41 @@ void MultigridBase::mainThread() {
   cspecdata.printBufferSizes();
   cspecdata.setRecvTimeout(0, one_tenth_second_usecs); /// secs, usecs
 
+  while (runThreads) {
+    ssize_t ReadSize{0};
+    unsigned int RxBufferIndex = RxRingbuffer.getDataIndex();
+
+    RxRingbuffer.setDataLength(RxBufferIndex, 0);
+    if ((ReadSize = cspecdata.receive(RxRingbuffer.getDataBuffer(RxBufferIndex),
+                                      RxRingbuffer.getMaxBufSize())) > 0) {
+      RxRingbuffer.setDataLength(RxBufferIndex, ReadSize);
+      Counters.rx_packets++;
+      Counters.rx_bytes += ReadSize;
+
+      if (InputFifo.push(RxBufferIndex) == false) {
+        Counters.fifo_push_errors++;
+      } else {
+        RxRingbuffer.getNextBuffer();
+      }
+    } else {
+      Counters.rx_idle++;
+    }
+  }
+  XTRACE(INPUT, ALW, "Stopping input thread.");
+}
+
+void MultigridBase::processingThread() {
+  if (!init_config()) {
+    // nothing will empty the fifo, so stop the input thread too
+    LOG(INIT, Sev::Error, "Stopping input and processing threads");
+    runThreads = false;
+    return;
+  }
+
+  mg_config.reduction.set_worker_threads(ModuleSettings.Workers);
+  LOG(INIT, Sev::Info, "Multigrid reduction threads: {}",
+      mg_config.reduction.worker_threads());
+
   Producer event_producer(EFUSettings.KafkaBroker, "C-SPEC_detector");
   auto Produce = [&event_producer](auto DataBuffer, auto Timestamp) {
     event_producer.produce(DataBuffer, Timestamp);
@@ -161,20 +225,23 @@ void MultigridBase::mainThread() {
 
   ev42serializer.pulseTime(0);
 
-  uint8_t buffer[EthernetBufferSize];
-
   TSCTimer report_timer;
 
   RuntimeStat RtStat({Counters.rx_packets, Counters.events_total, Counters.tx_bytes});
 
+  unsigned int DataIndex;
   while (true) {
-    ssize_t ReadSize{0};
-    if ((ReadSize = cspecdata.receive(buffer, EthernetBufferSize)) > 0) {
-      Counters.rx_packets++;
-      Counters.rx_bytes += ReadSize;
-//      XTRACE(PROCESS, DEB, "Processed UDP packet of size: %d", ReadSize);
+    if (InputFifo.pop(DataIndex)) {
+      ProcessingIdle.reset();
+      auto DataLen = RxRingbuffer.getDataLength(DataIndex);
+      if (DataLen == 0) {
+        Counters.fifo_seq_errors++;
+        continue;
+      }
+//      XTRACE(PROCESS, DEB, "Processed UDP packet of size: %d", DataLen);
 
-      mg_config.builder->parse(Buffer<uint8_t>(buffer, static_cast<size_t>(ReadSize)));
+      auto DataPtr = reinterpret_cast<uint8_t *>(RxRingbuffer.getDataBuffer(DataIndex));
+      mg_config.builder->parse(Buffer<uint8_t>(DataPtr, static_cast<size_t>(DataLen)));
 
       Counters.readouts_total = mg_config.builder->stats_readouts_total;
       Counters.parser_discarded_bytes = mg_config.builder->stats_discarded_bytes;
@@ -208,7 +275,7 @@ void MultigridBase::mainThread() {
         process_events(ev42serializer);
       }
     } else {
-      Counters.rx_idle++;
+      ProcessingIdle.idle();
     }
 
     /// Force periodic flushing
@@ -18,14 +18,20 @@ struct MultigridSettings {
   std::string FilePrefix;
   // \todo move this to json
   bool monitor{false};
+  unsigned int Workers{0}; ///< module reduction threads, 0: processing thread
 };
 
 ///
-class MultigridBase : public Detector {
+class MultigridBase : public InputDetector<> {
 public:
   MultigridBase(BaseSettings const &settings, MultigridSettings const &LocalSettings);
   ~MultigridBase() = default;
-  void mainThread();
+
+  /// \brief receive packets into RxRingbuffer and InputFifo
+  void inputThread();
+
+  /// \brief parse, cluster and serialize packets from InputFifo
+  void processingThread();
 
   /// Some hardcoded constants
   static constexpr int one_tenth_second_usecs{100000}; ///
@@ -37,6 +43,9 @@ protected:
     int64_t rx_packets{0};
     int64_t rx_bytes{0};
     int64_t rx_idle{0};
+    int64_t fifo_push_errors{0};
+    int64_t rx_memory_backing{0};
+    int64_t fifo_seq_errors{0};
     int64_t readouts_total{0};
     int64_t parser_discarded_bytes{0};
     int64_t parser_triggers{0};
@@ -15,6 +15,24 @@ ModulePipeline::ModulePipeline() {
   matcher.set_minimum_time_gap(1);
 }
 
+void ModulePipeline::set_wire_clusterer_2d(bool streaming) {
+  use_wire_clusterer_2d = true;
+  wire_clusterer_2d.set_geometry(analyzer.geometry());
+  wire_clusterer_2d.set_streaming(streaming);
+}
+
+AbstractClusterer &ModulePipeline::wires() {
+  if (use_wire_clusterer_2d)
+    return wire_clusterer_2d;
+  return wire_clusterer;
+}
+
+const AbstractClusterer &ModulePipeline::wires() const {
+  if (use_wire_clusterer_2d)
+    return wire_clusterer_2d;
+  return wire_clusterer;
+}
+
 void ModulePipeline::ingest(const Hit &hit) {
   if (previous_time_ > hit.time) {
     stats.time_seq_errors++;
@@ -25,7 +43,7 @@ void ModulePipeline::ingest(const Hit &hit) {
   auto plane = plane_in_module(hit.plane);
 
   if (plane == wire_plane) {
-    wire_clusterer.insert(hit);
+    wires().insert(hit);
   } else if (plane == grid_plane) {
     grid_clusterer.insert(hit);
   } else {
@@ -34,14 +52,15 @@ void ModulePipeline::ingest(const Hit &hit) {
 }
 
 void ModulePipeline::process_events(bool flush) {
+  auto &wire_clusters = wires();
   if (flush) {
-    wire_clusterer.flush();
+    wire_clusters.flush();
     grid_clusterer.flush();
   }
-  stats.wire_clusters = wire_clusterer.stats_cluster_count;
+  stats.wire_clusters = wire_clusters.stats_cluster_count;
   stats.grid_clusters = grid_clusterer.stats_cluster_count;
-  if (!wire_clusterer.clusters.empty())
-    matcher.insert(wire_clusterer.clusters.front().plane(), wire_clusterer.clusters);
+  if (!wire_clusters.clusters.empty())
+    matcher.insert(wire_clusters.clusters.front().plane(), wire_clusters.clusters);
   if (!grid_clusterer.clusters.empty())
     matcher.insert(grid_clusterer.clusters.front().plane(), grid_clusterer.clusters);
   matcher.match(flush);
@@ -86,7 +105,7 @@ void ModulePipeline::process_events(bool flush) {
 // debug strings excluded from coverage and unit tests
 std::string ModulePipeline::config(const std::string& prepend) const {
   std::stringstream ss;
-  ss << prepend << "Wire clusterer:\n" + wire_clusterer.config(prepend + "  ");
+  ss << prepend << "Wire clusterer:\n" + wires().config(prepend + "  ");
   ss << prepend << "Grid clusterer:\n" + grid_clusterer.config(prepend + "  ");
   ss << prepend << "Matcher:\n" + matcher.config(prepend + "  ");
   ss << prepend << "max_wire_hits = " << max_wire_hits << "\n";
@@ -109,7 +128,7 @@ std::string ModulePipeline::status(const std::string& prepend, bool verbose) con
   }
   ss << prepend << "Previous time: " << previous_time_ << "\n";
   ss << prepend << "Matcher:\n" + matcher.status(prepend + "  ", verbose);
-  ss << prepend << "Wire clusterer:\n" + wire_clusterer.status(prepend + "  ", verbose);
+  ss << prepend << "Wire clusterer:\n" + wires().status(prepend + "  ", verbose);
   ss << prepend << "Grid clusterer:\n" + grid_clusterer.status(prepend + "  ", verbose);
   return ss.str();
 }
@@ -3,6 +3,7 @@
 #pragma once
 #include <multigrid/reduction/EventProcessingStats.h>
 #include <common/reduction/clustering/GapClusterer.h>
+#include <common/reduction/clustering/GapClusterer2D.h>
 #include <common/reduction/matching/GapMatcher.h>
 #include <common/reduction/analysis/MgAnalyzer.h>
 #include <common/reduction/NeutronEvent.h>
@@ -22,14 +23,20 @@ public:
   std::string config(const std::string& prepend) const;
   std::string status(const std::string& prepend, bool verbose) const;
 
+  /// \brief cluster the wires with GapClusterer2D, in x and z of the analyzer
+  /// geometry instead of by wire number. Call after setting the geometry.
+  /// \param streaming see GapClusterer2D::set_streaming()
+  void set_wire_clusterer_2d(bool streaming);
+
   std::list<NeutronEvent> out_queue;
 
   EventProcessingStats stats;
 
 //private:
 
-// \todo refactor: use GapClusterer2D for wires
   GapClusterer wire_clusterer{0, 1};
+  GapClusterer2D wire_clusterer_2d{0, 1};
+  bool use_wire_clusterer_2d{false};
   GapClusterer grid_clusterer{0, 1};
 
   GapMatcher matcher{sequoia_maximum_latency, 0, 1};
@@ -44,6 +51,10 @@ public:
 private:
   uint64_t previous_time_{0};
 
+  /// \returns the selected wire clusterer
+  AbstractClusterer &wires();
+  const AbstractClusterer &wires() const;
+
 };
 
 void from_json(const nlohmann::json &j, ModulePipeline &g);
@@ -0,0 +1,68 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#include <multigrid/reduction/ModuleWorkers.h>
+#include <algorithm>
+
+namespace Multigrid {
+
+ModuleWorkers::ModuleWorkers(size_t groups)
+    : groups_(std::max(groups, size_t(1))) {
+  for (size_t group = 1; group < groups_; ++group) {
+    threads_.emplace_back([this, group]() { worker(group); });
+  }
+}
+
+ModuleWorkers::~ModuleWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto &t : threads_) {
+    t.join();
+  }
+}
+
+void ModuleWorkers::run(const Job &job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    remaining_ = threads_.size();
+    generation_++;
+  }
+  start_.notify_all();
+
+  job(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return remaining_ == 0; });
+  job_ = nullptr;
+}
+
+void ModuleWorkers::worker(size_t group) {
+  uint64_t generation{0};
+  while (true) {
+    const Job *job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [this, generation]() {
+        return stop_ || (generation_ != generation);
+      });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      job = job_;
+    }
+
+    (*job)(group);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      remaining_--;
+    }
+    done_.notify_one();
+  }
+}
+
+}
@@ -0,0 +1,46 @@
+/** Copyright (C) 2020 European Spallation Source ERIC */
+
+#pragma once
+#include <common/reduction/clustering/AbstractClusterer.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Multigrid {
+
+/// \brief Threads processing groups of modules in parallel. run() hands
+/// each group to its thread, the calling thread processes group 0, and
+/// returns when all groups are done. The hit and cluster pools are
+/// Shared while the workers exist.
+class ModuleWorkers {
+public:
+  using Job = std::function<void(size_t group)>;
+
+  /// \param groups number of groups, groups - 1 threads are started
+  explicit ModuleWorkers(size_t groups);
+  ~ModuleWorkers();
+
+  size_t groups() const { return groups_; }
+
+  /// \brief call job(group) for all groups in parallel, wait for all
+  void run(const Job &job);
+
+private:
+  void worker(size_t group);
+
+  size_t groups_{1};
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const Job *job_{nullptr};
+  uint64_t generation_{0};
+  size_t remaining_{0};
+  bool stop_{false};
+  SharedReductionPools shared_pools_; ///< outlives the threads
+  std::vector<std::thread> threads_;
+};
+
+}
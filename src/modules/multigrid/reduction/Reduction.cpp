@@ -2,8 +2,10 @@
 
 #include <multigrid/reduction/Reduction.h>
 #include <multigrid/geometry/PlaneMappings.h>
+#include <common/reduction/clustering/AbstractClusterer.h>
 
 #include <common/Trace.h>
+#include <stdexcept>
 //#undef TRC_LEVEL
 //#define TRC_LEVEL TRC_L_DEB
 
@@ -30,11 +32,39 @@ void Reduction::ingest(const Hit &h) {
   }
 }
 
+void Reduction::set_worker_threads(size_t threads) {
+  threads = std::min(threads, pipelines.size());
+  if (threads < 2) {
+    workers_.reset();
+    return;
+  }
+  // the hit and cluster pools are Shared while the workers exist
+  workers_ = std::make_shared<ModuleWorkers>(threads);
+}
+
+size_t Reduction::worker_threads() const {
+  return workers_ ? workers_->groups() : 1;
+}
+
 void Reduction::process_queues(bool flush) {
+  if (workers_) {
+    size_t groups = workers_->groups();
+    workers_->run([this, flush, groups](size_t group) {
+      size_t end = (group + 1) * pipelines.size() / groups;
+      for (size_t i = group * pipelines.size() / groups; i < end; ++i) {
+        pipelines[i].process_events(flush);
+      }
+    });
+  } else {
+    for (auto &p : pipelines) {
+      p.process_events(flush);
+    }
+  }
+
+  // merging in module order, output does not depend on the threads
   stats.clear();
   for (size_t i = 0; i < pipelines.size(); ++i) {
     auto &p = pipelines[i];
-    p.process_events(flush);
     stats += p.stats;
     merger.insert(i, p.out_queue);
   }
@@ -152,6 +182,8 @@ void from_json(const nlohmann::json &j, Reduction &g) {
     pipeline.matcher = GapMatcher(max_latency,
                                   2 * module_count,
                                   2 * module_count + 1);
+    if (j.count("ordered_matcher"))
+      pipeline.matcher.set_ordered_queue(j["ordered_matcher"]);
 
     pipeline.max_wire_hits = max_wire_multiplicity;
     pipeline.max_grid_hits = max_grid_multiplicity;
@@ -159,6 +191,17 @@ void from_json(const nlohmann::json &j, Reduction &g) {
     pipeline.analyzer.weighted(jj["analysis_weighted"]);
     pipeline.analyzer.set_geometry(jj["digital_geometry"]);
 
+    std::string wire_clusterer{"GapClusterer"};
+    if (j.count("wire_clusterer"))
+      wire_clusterer = j["wire_clusterer"];
+    if (wire_clusterer == "GapClusterer2D") {
+      bool streaming = j.count("wire_clusterer_streaming") &&
+                       j["wire_clusterer_streaming"].get<bool>();
+      pipeline.set_wire_clusterer_2d(streaming);
+    } else if (wire_clusterer != "GapClusterer") {
+      throw std::runtime_error("Unknown wire_clusterer " + wire_clusterer);
+    }
+
     g.pipelines.push_back(pipeline);
     module_count++;
   }
@@ -169,7 +212,7 @@ void from_json(const nlohmann::json &j, Reduction &g) {
     p.geometry = logical_geometry;
   }
 
-  g.merger = ChronoMerger(max_latency, g.pipelines.size() + 1);
+  g.merger = ChronoHeapMerger(max_latency, g.pipelines.size() + 1);
 }
 
 }
\ No newline at end of file
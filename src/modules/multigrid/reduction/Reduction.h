@@ -2,7 +2,9 @@
 
 #pragma once
 #include <multigrid/reduction/ModulePipeline.h>
-#include <common/reduction/ChronoMerger.h>
+#include <multigrid/reduction/ModuleWorkers.h>
+#include <common/reduction/ChronoHeapMerger.h>
+#include <memory>
 
 namespace Multigrid {
 
@@ -12,6 +14,11 @@ public:
   void ingest(HitVector &hits);
   void ingest(const Hit& hit);
   void process_queues(bool flush);
+
+  /// \brief process_queues() processes the pipelines in groups of
+  /// consecutive modules, one thread per group. 0 or 1: calling thread only
+  void set_worker_threads(size_t threads);
+  size_t worker_threads() const;
   std::string config(const std::string& prepend) const;
   std::string status(const std::string& prepend, bool verbose) const;
 
@@ -22,12 +29,12 @@ public:
   std::vector<ModulePipeline> pipelines;
   EventProcessingStats stats;
 
-  ChronoMerger merger{sequoia_maximum_latency, 2};
+  ChronoHeapMerger merger{sequoia_maximum_latency, 2};
 
   std::list<NeutronEvent> out_queue;
 
 private:
-
+  std::shared_ptr<ModuleWorkers> workers_;
 };
 
 void from_json(const nlohmann::json &j, Reduction &g);
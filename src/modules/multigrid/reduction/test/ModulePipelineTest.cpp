@@ -46,6 +46,26 @@ TEST_F(ModulePipelineTest, Ingest) {
   ASSERT_EQ(pipeline.stats.invalid_planes, 0);
  }
 
+TEST_F(ModulePipelineTest, WireClusterer2D) {
+  // wire = 20 * x + z, no two wires are neighbours in both x and z
+  auto wire_clusters = [](ModulePipeline &p) {
+    p.ingest({10, 0, 100, wire_plane}); // x 0, z 0
+    p.ingest({10, 23, 100, wire_plane}); // x 1, z 3
+    p.ingest({10, 41, 100, wire_plane}); // x 2, z 1
+    p.process_events(true);
+    return p.stats.wire_clusters;
+  };
+
+  ASSERT_EQ(wire_clusters(pipeline), 3); // by wire number
+
+  ModulePipeline batch;
+  batch.set_wire_clusterer_2d(false);
+  ASSERT_EQ(wire_clusters(batch), 2); // x, then z
+
+  ModulePipeline streaming;
+  streaming.set_wire_clusterer_2d(true);
+  ASSERT_EQ(wire_clusters(streaming), 3); // x and z
+}
 
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -19,6 +19,7 @@ public:
       : MultigridBase(Settings, ReadoutSettings){};
   ~MultigridBaseStandIn() = default;
   using Detector::Threads;
+  using Detector::runThreads;
   using MultigridBase::Counters;
 };
 
@@ -75,6 +76,40 @@ TEST_F(MultigridBaseTest, DataReceive) {
   EXPECT_EQ(Readout.Counters.tx_events, 22);
 }
 
+// module pipelines in parallel threads give the same results
+TEST_F(MultigridBaseTest, DataReceiveWorkers) {
+  LocalSettings.Workers = 3;
+  MultigridBaseStandIn Readout(Settings, LocalSettings);
+  Readout.startThreads();
+  std::chrono::duration<std::int64_t, std::milli> InitSleepTime {300};
+  TestUDPServer Server(43127, Settings.DetectorPort,
+      &ws4[0], ws4.size());
+  std::this_thread::sleep_for(InitSleepTime);
+  Server.startPacketTransmission(1, 1000);
+  std::chrono::duration<std::int64_t, std::milli> SleepTime(1000);
+  std::this_thread::sleep_for(SleepTime);
+  Readout.stopThreads();
+  EXPECT_EQ(Readout.Counters.rx_packets, 1);
+  EXPECT_EQ(Readout.Counters.hits_total, 54);
+  EXPECT_EQ(Readout.Counters.hits_used, 44);
+  EXPECT_EQ(Readout.Counters.wire_clusters, 24);
+  EXPECT_EQ(Readout.Counters.grid_clusters, 26);
+  EXPECT_EQ(Readout.Counters.events_total, 23);
+  EXPECT_EQ(Readout.Counters.events_multiplicity_rejects, 1);
+  EXPECT_EQ(Readout.Counters.tx_events, 22);
+}
+
+// the input thread must not keep running without a processing thread
+TEST_F(MultigridBaseTest, BadConfigStopsThreads) {
+  LocalSettings.ConfigFile = "deleteme_multigrid_no_such_config.json";
+  MultigridBaseStandIn Readout(Settings, LocalSettings);
+  Readout.startThreads();
+  std::chrono::duration<std::int64_t, std::milli> SleepTime(300);
+  std::this_thread::sleep_for(SleepTime);
+  EXPECT_FALSE(Readout.runThreads);
+  Readout.stopThreads();
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -5,6 +5,11 @@
 ///
 /// \brief ESS HighTime/LowTime handler class
 ///
+/// High is in seconds and Low in ticks of the 88052500 Hz ESS clock. The
+/// conversion to ns uses integer arithmetic only: a tick is exactly
+/// 400000/35221 ns, so the result is floor(Low * 1e9 / 88052500) for all
+/// valid Low values. The compiler implements the division by the constant
+/// as a multiplication by a fixed-point reciprocal.
 //===----------------------------------------------------------------------===//
 
 #pragma once
@@ -15,12 +20,15 @@
 class ESSTime {
 public:
   // ESS clock is 88052500 Hz
+  static constexpr uint32_t TicksPerSecond{88052500};
+  static constexpr uint64_t NsPerTickNum{400000}; // 1e9 / 88052500 reduced
+  static constexpr uint64_t NsPerTickDen{35221};
   const double NsPerTick{11.356860963629653};
   const uint64_t OneBillion{1000000000LU};
 
   /// \brief save reference (pulse) time
   uint64_t setReference(uint32_t High, uint32_t Low) {
-    TimeInNS =toNS(High, Low);
+    TimeInNS = toNS(High, Low);
     return TimeInNS;
   }
 
@@ -28,11 +36,18 @@ public:
   uint64_t getTOF(uint32_t High, uint32_t Low) {
     return toNS(High, Low) - TimeInNS;
   }
-private:
-  /// \brief convert ess High/Low time to NS
-  uint64_t toNS(uint32_t High, uint32_t Low) {
+
+  /// \brief convert ess High/Low time to NS, exact (rounded down)
+  static uint64_t toNS(uint32_t High, uint32_t Low) {
     //assert(Low < 88052500);
+    return High * 1000000000LU + (Low * NsPerTickNum) / NsPerTickDen;
+  }
+
+  /// \brief previous floating point conversion, kept for comparison
+  uint64_t toNSDouble(uint32_t High, uint32_t Low) {
     return  High * OneBillion + Low * NsPerTick;
   }
+
+private:
   uint64_t TimeInNS{0};
 };
@@ -0,0 +1,59 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Benchmark of ESS time conversions, integer and floating point
+///
+//===----------------------------------------------------------------------===//
+
+#include <benchmark/benchmark.h>
+#include <common/BenchmarkUtil.h>
+#include <readout/ESSTime.h>
+
+const uint32_t Count{1000000};
+const uint32_t TickStep{ESSTime::TicksPerSecond / Count};
+
+static void ESSTimeToNS(benchmark::State &state) {
+  uint64_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    for (uint32_t Low = 0; Low < ESSTime::TicksPerSecond; Low += TickStep) {
+      uint64_t NS = ESSTime::toNS(1, Low);
+      ::benchmark::DoNotOptimize(NS);
+    }
+    Total += Count;
+  });
+  state.SetItemsProcessed(Total);
+}
+BENCHMARK(ESSTimeToNS);
+
+static void ESSTimeToNSDouble(benchmark::State &state) {
+  ESSTime Time;
+  uint64_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    for (uint32_t Low = 0; Low < ESSTime::TicksPerSecond; Low += TickStep) {
+      uint64_t NS = Time.toNSDouble(1, Low);
+      ::benchmark::DoNotOptimize(NS);
+    }
+    Total += Count;
+  });
+  state.SetItemsProcessed(Total);
+}
+BENCHMARK(ESSTimeToNSDouble);
+
+static void ESSTimeGetTOF(benchmark::State &state) {
+  ESSTime Time;
+  Time.setReference(1, 12345);
+  uint64_t Total = 0;
+  BenchmarkLoop(state, [&] {
+    for (uint32_t Low = 0; Low < ESSTime::TicksPerSecond; Low += TickStep) {
+      uint64_t TOF = Time.getTOF(2, Low);
+      ::benchmark::DoNotOptimize(TOF);
+    }
+    Total += Count;
+  });
+  state.SetItemsProcessed(Total);
+}
+BENCHMARK(ESSTimeGetTOF);
+
+BENCHMARK_MAIN();
@@ -38,6 +38,33 @@ TEST_F(ESSTimeTest, Bounds) {
   ASSERT_EQ(Time.getTOF(1, 0), 12); // why not 11?
 }
 
+// all valid tick values, against the definition with the unreduced fraction
+TEST_F(ESSTimeTest, AllTicksExact) {
+  uint64_t Previous{0};
+  for (uint32_t Low = 0; Low < ESSTime::TicksPerSecond; Low++) {
+    uint64_t NS = ESSTime::toNS(0, Low);
+    ASSERT_EQ(NS, (Low * 1000000000LU) / ESSTime::TicksPerSecond);
+    ASSERT_GE(NS, Previous);
+    Previous = NS;
+  }
+  ASSERT_EQ(Previous, 999999988);
+}
+
+// the floating point conversion is at most 1 ns off
+TEST_F(ESSTimeTest, AllTicksCloseToDouble) {
+  for (uint32_t Low = 0; Low < ESSTime::TicksPerSecond; Low++) {
+    uint64_t NS = ESSTime::toNS(1, Low);
+    uint64_t NSDouble = Time.toNSDouble(1, Low);
+    ASSERT_LE((NS > NSDouble) ? NS - NSDouble : NSDouble - NS, 1);
+  }
+}
+
+TEST_F(ESSTimeTest, HighTimeRange) {
+  ASSERT_EQ(ESSTime::toNS(0xffffffff, 0), 0xffffffffLU * 1000000000LU);
+  ASSERT_EQ(ESSTime::toNS(0xffffffff, 88052499),
+            0xffffffffLU * 1000000000LU + 999999988);
+}
+
 
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
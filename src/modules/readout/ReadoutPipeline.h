@@ -0,0 +1,249 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Multi threaded processing of parsed ESS readout data
+///
+/// The processing thread validates and parses packets as usual and hands
+/// the parsed Ring/FEN sections to addPacket(). Sections are distributed
+/// over a pool of worker threads, all sections from the same Ring/FEN go to
+/// the same worker. Each worker owns an instrument object (WorkerT) which
+/// must provide
+///
+///   void processSection(const ReadoutParser::PacketHeaderV0 &Header,
+///                       SectionT &Section, std::vector<ReadoutEvent> &Events);
+///
+/// SectionT must have RingId and FENId members and a Data vector (as the
+/// ParsedData of the LoKI and DREAM DataParsers).
+///
+/// collect() is called from the processing thread. Packets are handed to
+/// the EventCallback in the order they were added, with the events in
+/// section order, i.e. the same order as processing the sections in a
+/// single thread.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <common/IdleStrategy.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <readout/ESSTime.h>
+#include <readout/ReadoutParser.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief event calculated by a worker
+struct ReadoutEvent {
+  uint64_t Time; ///< time of flight (ns)
+  uint32_t PixelId;
+};
+
+/// \brief per worker counters, QueueDepth is updated by collect()
+struct ReadoutWorkerStats {
+  int64_t Sections{0};
+  int64_t Readouts{0};
+  int64_t Events{0};
+  int64_t QueueDepth{0};
+};
+
+template <typename SectionT, typename WorkerT> class ReadoutPipeline {
+public:
+  static const unsigned int MaxWorkers{16};
+
+  /// \brief creates the instrument object for a worker
+  using WorkerFactory = std::function<std::unique_ptr<WorkerT>(unsigned int Worker)>;
+
+  /// \brief receives the pulse time and events of each packet
+  using EventCallback = std::function<void(uint64_t PulseTime, std::vector<ReadoutEvent> &Events)>;
+
+  /// \param Workers number of worker threads (1 - MaxWorkers)
+  /// \param Factory called once per worker before its thread is started
+  /// \param Callback called by collect() for each completed packet
+  /// \param QueueSize sections queued per worker, must be larger than the
+  /// number of sections in a packet
+  /// \param IdleMode IdleStrategy used by the workers
+  ReadoutPipeline(unsigned int Workers, WorkerFactory Factory,
+                  EventCallback Callback, unsigned int QueueSize = 1024,
+                  std::string IdleMode = "yield")
+      : Callback(Callback), QueueSize(QueueSize) {
+    Workers = (Workers < 1) ? 1 : (Workers > MaxWorkers) ? MaxWorkers : Workers;
+    for (unsigned int i = 0; i < Workers; i++) {
+      WorkerThreads.emplace_back(new Worker(QueueSize, IdleMode));
+      WorkerThreads.back()->Instrument = Factory(i);
+    }
+    for (unsigned int i = 0; i < Workers; i++) {
+      auto W = WorkerThreads[i].get();
+      W->Thread = std::thread([this, W]() { workerThread(*W); });
+    }
+  }
+
+  /// \brief stops and joins the worker threads, uncollected data is lost
+  ~ReadoutPipeline() {
+    Running = false;
+    for (auto &W : WorkerThreads) {
+      W->Thread.join();
+    }
+  }
+
+  unsigned int workers() { return WorkerThreads.size(); }
+
+  /// \brief counters of a worker, to be copied to the detector stats
+  const ReadoutWorkerStats &workerStats(unsigned int Worker) {
+    return WorkerThreads[Worker]->Stats;
+  }
+
+  /// \brief distribute the sections of a validated and parsed packet to
+  /// the workers. The section contents are moved to the pipeline (the
+  /// vectors are swapped with those of an already collected item, whose
+  /// capacity the LoKI/DREAM parsers reuse as they assign in place).
+  /// Blocks (while collecting) if a worker queue is full.
+  void addPacket(const ReadoutParser::PacketHeaderV0 &Header,
+                 std::vector<SectionT> &Sections) {
+    assert(Sections.size() < QueueSize);
+    PacketNumber++;
+
+    for (auto &Section : Sections) {
+      uint8_t WorkerId = (Section.RingId * 32 + Section.FENId) % workers();
+      Worker &W = *WorkerThreads[WorkerId];
+      while (W.Submitted.load(std::memory_order_relaxed) - W.Collected == QueueSize) {
+        if (collect() == 0) {
+          std::this_thread::yield();
+        }
+      }
+      uint64_t Next = W.Submitted.load(std::memory_order_relaxed);
+      auto &Item = W.Items[Next % QueueSize];
+      Item.PacketNumber = PacketNumber;
+      Item.Header = Header;
+      std::swap(Item.Section, Section);
+      W.Submitted.store(Next + 1, std::memory_order_release);
+      SectionWorkers.push_back(WorkerId);
+    }
+    // only fully submitted packets can be collected
+    Pending.push_back({PacketNumber, Sections.size(),
+                       Time.setReference(Header.PulseHigh, Header.PulseLow)});
+  }
+
+  /// \brief hand completed packets, in order, to the EventCallback
+  /// \param Wait wait for all outstanding packets to complete
+  /// \return number of packets handed over
+  unsigned int collect(bool Wait = false) {
+    unsigned int Packets{0};
+    while (not Pending.empty()) {
+      if (not packetComplete(Pending.front().Number)) {
+        if (not Wait) {
+          break;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+
+      // each worker's items are in submission order, so taking the next
+      // item of the worker that got the section restores the section order
+      Events.clear();
+      for (size_t i = 0; i < Pending.front().Sections; i++) {
+        Worker &W = *WorkerThreads[SectionWorkers.front()];
+        SectionWorkers.pop_front();
+        auto &Item = W.Items[W.Collected % QueueSize];
+        Events.insert(Events.end(), Item.Events.begin(), Item.Events.end());
+        W.Collected++;
+      }
+      Callback(Pending.front().PulseTime, Events);
+      Pending.pop_front();
+      Packets++;
+    }
+
+    for (auto &W : WorkerThreads) {
+      W->Stats.QueueDepth = W->Submitted.load(std::memory_order_relaxed) -
+                            W->Completed.load(std::memory_order_relaxed);
+    }
+    return Packets;
+  }
+
+  /// \brief wait for and hand over all outstanding packets
+  unsigned int flush() { return collect(true); }
+
+private:
+  struct WorkItem {
+    uint64_t PacketNumber{0};
+    ReadoutParser::PacketHeaderV0 Header;
+    SectionT Section;
+    std::vector<ReadoutEvent> Events;
+  };
+
+  struct Worker {
+    Worker(unsigned int QueueSize, std::string IdleMode)
+        : Items(QueueSize), Idle(IdleMode, 10) {}
+    std::vector<WorkItem> Items;
+    std::unique_ptr<WorkerT> Instrument;
+    IdleStrategy Idle;
+    std::thread Thread;
+    /// written by the processing thread, read by the worker
+    std::atomic<uint64_t> Submitted{0};
+    char Padding0[64]; // cppcheck-suppress unusedStructMember
+    /// written by the worker, read by the processing thread
+    std::atomic<uint64_t> Completed{0};
+    ReadoutWorkerStats Stats;
+    char Padding1[64]; // cppcheck-suppress unusedStructMember
+    /// only used by the processing thread
+    uint64_t Collected{0};
+  };
+
+  struct PendingPacket {
+    uint64_t Number;
+    size_t Sections;
+    uint64_t PulseTime;
+  };
+
+  /// \brief are all sections of the packet processed
+  bool packetComplete(uint64_t Number) {
+    for (auto &W : WorkerThreads) {
+      uint64_t Submitted = W->Submitted.load(std::memory_order_relaxed);
+      uint64_t Completed = W->Completed.load(std::memory_order_acquire);
+      uint64_t End = W->Collected;
+      while ((End < Submitted) and (W->Items[End % QueueSize].PacketNumber == Number)) {
+        if (End >= Completed) {
+          return false;
+        }
+        End++;
+      }
+    }
+    return true;
+  }
+
+  void workerThread(Worker &W) {
+    uint64_t Next{0};
+    while (Running) {
+      if (Next == W.Submitted.load(std::memory_order_acquire)) {
+        W.Idle.idle();
+        continue;
+      }
+      W.Idle.reset();
+      auto &Item = W.Items[Next % QueueSize];
+      Item.Events.clear();
+      W.Instrument->processSection(Item.Header, Item.Section, Item.Events);
+      W.Stats.Sections++;
+      W.Stats.Readouts += Item.Section.Data.size();
+      W.Stats.Events += Item.Events.size();
+      Next++;
+      W.Completed.store(Next, std::memory_order_release);
+    }
+  }
+
+  EventCallback Callback;
+  unsigned int QueueSize;
+  std::atomic_bool Running{true};
+  std::vector<std::unique_ptr<Worker>> WorkerThreads;
+  std::deque<PendingPacket> Pending;
+  std::deque<uint8_t> SectionWorkers; ///< worker of each submitted section
+  std::vector<ReadoutEvent> Events;
+  uint64_t PacketNumber{0};
+  ESSTime Time;
+};
+
+template <typename SectionT, typename WorkerT>
+const unsigned int ReadoutPipeline<SectionT, WorkerT>::MaxWorkers;
@@ -0,0 +1,186 @@
+// Copyright (C) 2020 European Spallation Source, ERIC. See LICENSE file
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// \brief Unit test for ReadoutPipeline
+///
+//===----------------------------------------------------------------------===//
+
+#include <readout/ReadoutPipeline.h>
+#include <test/TestBase.h>
+
+struct TestReadout {
+  uint32_t Time;
+};
+
+struct TestSection {
+  uint8_t RingId;
+  uint8_t FENId;
+  std::vector<TestReadout> Data;
+};
+
+/// \brief one event per readout, pixel is Ring * 100 + FEN
+class TestInstrument {
+public:
+  explicit TestInstrument(unsigned int Id) : Id(Id) {}
+
+  void processSection(const ReadoutParser::PacketHeaderV0 &,
+                      TestSection &Section, std::vector<ReadoutEvent> &Events) {
+    for (auto &Data : Section.Data) {
+      Events.push_back({Data.Time, Section.RingId * 100U + Section.FENId});
+    }
+    Sections++;
+  }
+
+  unsigned int Id;
+  int Sections{0};
+};
+
+using TestPipeline = ReadoutPipeline<TestSection, TestInstrument>;
+
+class ReadoutPipelineTest : public TestBase {
+protected:
+  ReadoutParser::PacketHeaderV0 Header{};
+  std::vector<std::pair<uint64_t, std::vector<ReadoutEvent>>> Received;
+
+  TestPipeline::WorkerFactory Factory = [](unsigned int Worker) {
+    return std::unique_ptr<TestInstrument>(new TestInstrument(Worker));
+  };
+
+  TestPipeline::EventCallback Callback =
+      [this](uint64_t PulseTime, std::vector<ReadoutEvent> &Events) {
+        Received.push_back({PulseTime, Events});
+      };
+
+  /// \brief sections for FEN 1 - Sections, FEN f has readouts with
+  /// time f, f + Sections, f + 2 * Sections ...
+  std::vector<TestSection> makeSections(uint8_t Ring, uint8_t Sections,
+                                        unsigned int Readouts) {
+    std::vector<TestSection> Result;
+    for (uint8_t FEN = 1; FEN <= Sections; FEN++) {
+      TestSection Section{Ring, FEN, {}};
+      for (unsigned int i = 0; i < Readouts; i++) {
+        Section.Data.push_back({FEN + i * Sections});
+      }
+      Result.push_back(Section);
+    }
+    return Result;
+  }
+};
+
+TEST_F(ReadoutPipelineTest, Constructor) {
+  TestPipeline Pipeline(4, Factory, Callback);
+  ASSERT_EQ(Pipeline.workers(), 4);
+  ASSERT_EQ(Pipeline.collect(), 0);
+  ASSERT_EQ(Pipeline.flush(), 0);
+}
+
+TEST_F(ReadoutPipelineTest, WorkersClamped) {
+  TestPipeline Pipeline1(0, Factory, Callback);
+  ASSERT_EQ(Pipeline1.workers(), 1);
+  TestPipeline Pipeline2(1000, Factory, Callback);
+  ASSERT_EQ(Pipeline2.workers(), TestPipeline::MaxWorkers);
+}
+
+TEST_F(ReadoutPipelineTest, EventsInSectionOrder) {
+  TestPipeline Pipeline(3, Factory, Callback);
+  auto Sections = makeSections(0, 6, 10);
+  Header.PulseHigh = 1;
+  Pipeline.addPacket(Header, Sections);
+  ASSERT_EQ(Pipeline.flush(), 1);
+
+  ASSERT_EQ(Received.size(), 1);
+  ASSERT_EQ(Received[0].first, 1000000000LU);
+  auto &Events = Received[0].second;
+  ASSERT_EQ(Events.size(), 60);
+  for (unsigned int i = 0; i < Events.size(); i++) {
+    ASSERT_EQ(Events[i].Time, (i / 10) + 1 + (i % 10) * 6);
+    ASSERT_EQ(Events[i].PixelId, (i / 10) + 1);
+  }
+}
+
+/// \brief the event order doesn't depend on the number of workers
+TEST_F(ReadoutPipelineTest, SameOrderAsSingleWorker) {
+  const unsigned int Packets{50};
+  std::vector<std::pair<uint64_t, std::vector<ReadoutEvent>>> Reference;
+  for (unsigned int Workers : {1, 2, 5}) {
+    Received.clear();
+    TestPipeline Pipeline(Workers, Factory, Callback, 32);
+    for (unsigned int i = 0; i < Packets; i++) {
+      std::vector<TestSection> Sections;
+      for (unsigned int Ring = 0; Ring < 3; Ring++) {
+        auto RingSections = makeSections((Ring + i) % 3, 4 + i % 3, 1 + i % 4);
+        Sections.insert(Sections.end(), RingSections.rbegin(), RingSections.rend());
+      }
+      Header.PulseHigh = i;
+      Pipeline.addPacket(Header, Sections);
+      Pipeline.collect();
+    }
+    Pipeline.flush();
+
+    ASSERT_EQ(Received.size(), Packets);
+    if (Workers == 1) {
+      Reference = Received;
+      continue;
+    }
+    for (unsigned int i = 0; i < Packets; i++) {
+      ASSERT_EQ(Received[i].first, Reference[i].first);
+      auto &Events = Received[i].second;
+      auto &RefEvents = Reference[i].second;
+      ASSERT_EQ(Events.size(), RefEvents.size());
+      for (unsigned int j = 0; j < Events.size(); j++) {
+        ASSERT_EQ(Events[j].Time, RefEvents[j].Time);
+        ASSERT_EQ(Events[j].PixelId, RefEvents[j].PixelId);
+      }
+    }
+  }
+}
+
+TEST_F(ReadoutPipelineTest, PacketOrderAndStats) {
+  const unsigned int Packets{200};
+  TestPipeline Pipeline(4, Factory, Callback, 16);
+  for (unsigned int i = 0; i < Packets; i++) {
+    auto Sections = makeSections(i % 3, 8, 2);
+    Header.PulseHigh = i;
+    Pipeline.addPacket(Header, Sections);
+    Pipeline.collect();
+  }
+  Pipeline.flush();
+
+  ASSERT_EQ(Received.size(), Packets);
+  for (unsigned int i = 0; i < Packets; i++) {
+    ASSERT_EQ(Received[i].first, i * 1000000000LU);
+    ASSERT_EQ(Received[i].second.size(), 16);
+    ASSERT_EQ(Received[i].second[0].PixelId, (i % 3) * 100 + 1);
+  }
+
+  int64_t Sections{0};
+  int64_t Readouts{0};
+  int64_t Events{0};
+  for (unsigned int i = 0; i < Pipeline.workers(); i++) {
+    auto &Stats = Pipeline.workerStats(i);
+    ASSERT_GT(Stats.Sections, 0);
+    ASSERT_EQ(Stats.QueueDepth, 0);
+    Sections += Stats.Sections;
+    Readouts += Stats.Readouts;
+    Events += Stats.Events;
+  }
+  ASSERT_EQ(Sections, Packets * 8);
+  ASSERT_EQ(Readouts, Packets * 16);
+  ASSERT_EQ(Events, Packets * 16);
+}
+
+TEST_F(ReadoutPipelineTest, EmptyPacket) {
+  TestPipeline Pipeline(2, Factory, Callback);
+  std::vector<TestSection> Sections;
+  Pipeline.addPacket(Header, Sections);
+  ASSERT_EQ(Pipeline.collect(), 1);
+  ASSERT_EQ(Received.size(), 1);
+  ASSERT_EQ(Received[0].second.size(), 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
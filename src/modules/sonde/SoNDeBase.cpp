@@ -20,7 +20,7 @@
 // #define TRC_LEVEL TRC_L_DEB
 
 SONDEIDEABase::SONDEIDEABase(BaseSettings const &settings, struct SoNDeSettings & localSettings)
-     : Detector("SoNDe detector using IDEAS readout", settings),
+     : InputDetector("SoNDe detector using IDEAS readout", settings),
        SoNDeSettings(localSettings) {
 
   Stats.setPrefix(EFUSettings.GraphitePrefix, EFUSettings.GraphiteRegion);
@@ -43,7 +43,11 @@ SONDEIDEABase::SONDEIDEABase(BaseSettings const &settings, struct SoNDeSettings
   Stats.create("transmit.bytes",                  mystats.tx_bytes);
 
   Stats.create("thread.input_idle",               mystats.rx_idle);
-  Stats.create("thread.processing_idle",          mystats.processing_idle);
+  Stats.create("thread.processing_idle_spin",     ProcessingIdle.Counters.Spins);
+  Stats.create("thread.processing_idle_yield",    ProcessingIdle.Counters.Yields);
+  Stats.create("thread.processing_idle_pause",    ProcessingIdle.Counters.Pauses);
+  Stats.create("thread.processing_idle_sleep",    ProcessingIdle.Counters.Sleeps);
+  Stats.create("memory.rx_backing",               mystats.rx_memory_backing);
   Stats.create("thread.fifo_synch_errors",        mystats.fifo_synch_errors);
 
   /// \todo Kafka stats are common to all detectors and could/should be moved
@@ -55,6 +59,8 @@ SONDEIDEABase::SONDEIDEABase(BaseSettings const &settings, struct SoNDeSettings
 
 
   // clang-format on
+  mystats.rx_memory_backing = rxMemoryBacking(); // 2 is huge pages
+
   std::function<void()> inputFunc = [this]() { SONDEIDEABase::input_thread(); };
   Detector::AddThreadFunction(inputFunc, "input");
 
@@ -133,8 +139,6 @@ void SONDEIDEABase::processing_thread() {
   TSCTimer produce_timer;
   while (1) {
     if ((InputFifo.pop(data_index)) == false) {
-      mystats.processing_idle++;
-
       if (produce_timer.timetsc() >=
           EFUSettings.UpdateIntervalSec * 1000000 * TSC_MHZ) {
         mystats.tx_bytes += flatbuffer.produce();
@@ -157,9 +161,10 @@ void SONDEIDEABase::processing_thread() {
           histograms.clear();
         }
       }
-      usleep(10);
+      ProcessingIdle.idle();
 
     } else {
+      ProcessingIdle.reset();
 
       auto len = RxRingbuffer.getDataLength(data_index);
       if (len == 0) {
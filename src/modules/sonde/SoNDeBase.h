@@ -23,7 +23,7 @@ struct SoNDeSettings {
 
 /** ----------------------------------------------------- */
 
-class SONDEIDEABase : public Detector {
+class SONDEIDEABase : public InputDetector<> {
 public:
   explicit SONDEIDEABase(BaseSettings const & settings, SoNDeSettings & localSoNDeSettings);
   ~SONDEIDEABase() = default;
@@ -39,10 +39,10 @@ protected:
     int64_t rx_bytes;
     int64_t rx_idle;
     int64_t fifo_push_errors;
-    int64_t PaddingFor64ByteAlignment[4]; // cppcheck-suppress unusedStructMember
+    int64_t rx_memory_backing;
+    int64_t PaddingFor64ByteAlignment[3]; // cppcheck-suppress unusedStructMember
 
     // Processing and Output counters
-    int64_t processing_idle;
     int64_t rx_pkt_triggertime;
     int64_t rx_pkt_singleevent;
     int64_t rx_pkt_multievent;
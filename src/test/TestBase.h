@@ -16,6 +16,11 @@
 #include <gtest/gtest.h>
 #pragma GCC diagnostic pop
 
+// gtest before 1.10 only has the deprecated *_TEST_CASE spelling
+#ifndef TYPED_TEST_SUITE
+#define TYPED_TEST_SUITE TYPED_TEST_CASE
+#endif
+
 namespace testing {
 namespace internal {
 enum GTestColor { COLOR_DEFAULT, COLOR_RED, COLOR_GREEN, COLOR_YELLOW };